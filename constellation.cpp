@@ -0,0 +1,117 @@
+#include "constellation.h"
+#include "ubxtime.h"
+
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+const double OrbitRadius = 26559700.0;          // m
+const double MeanMotion = 1.458423e-4;          // rad/s, half a sidereal day
+const double EarthRotation = 7.2921151467e-5;   // rad/s
+const double Inclination = 55.0 * M_PI / 180.0;
+const double WgsA = 6378137.0;
+const double WgsE2 = 6.69437999014e-3;
+
+// Satellites are handed out to these systems in order. The first one keeps
+// gnssId 1, which NAV-SAT has always reported for its SVs
+struct GnssSystem {
+    quint8 gnssId;
+    int svCount;
+};
+const GnssSystem Systems[] = {
+    { 1, 32 },  // primary
+    { 2, 36 },  // Galileo
+    { 3, 37 },  // BeiDou
+    { 6, 24 },  // GLONASS
+};
+
+} // namespace
+
+Constellation::Constellation(int satellites)
+    : m_count(qBound(1, satellites, MaxSatellites)) {
+    int index = 0;
+    for (const GnssSystem &system : Systems) {
+        for (int sv = 1; sv <= system.svCount && index < m_count; sv++, index++) {
+            m_snapshot.satellites[index].gnssId = system.gnssId;
+            m_snapshot.satellites[index].svId = static_cast<quint8>(sv);
+        }
+    }
+    advance(0, 0);
+}
+
+const Constellation::Snapshot &Constellation::advance(quint32 epoch, qint64 timeMs) {
+    const int planes = 6;
+    const int perPlane = (m_count + planes - 1) / planes;
+    const double t = timeMs / 1000.0;
+    const double cosI = std::cos(Inclination);
+    const double sinI = std::sin(Inclination);
+
+    Snapshot &s = m_snapshot;
+    s.epoch = epoch;
+    s.timeMs = timeMs;
+
+    const UbxTime utc = UbxTime::fromMSecs(timeMs);
+    s.iTOW = utc.iTOW;
+    s.year = utc.year;
+    s.month = utc.month;
+    s.day = utc.day;
+    s.hour = utc.hour;
+    s.minute = utc.minute;
+    s.second = utc.second;
+
+    s.count = m_count;
+    for (int i = 0; i < m_count; i++) {
+        const int plane = i % planes;
+        const int slot = i / planes;
+        // Node drifts west with Earth rotation, slots are phased between planes
+        const double node = plane * (2 * M_PI / planes) - EarthRotation * t;
+        const double u = slot * (2 * M_PI / perPlane) + plane * (2 * M_PI / m_count) + MeanMotion * t;
+        const double cosU = std::cos(u);
+        const double sinU = std::sin(u);
+        const double cosNode = std::cos(node);
+        const double sinNode = std::sin(node);
+
+        Satellite &sat = s.satellites[i];
+        sat.x = OrbitRadius * (cosU * cosNode - sinU * cosI * sinNode);
+        sat.y = OrbitRadius * (cosU * sinNode + sinU * cosI * cosNode);
+        sat.z = OrbitRadius * sinU * sinI;
+    }
+    return s;
+}
+
+int Constellation::visible(const Snapshot &snapshot, double lat, double lon, double height,
+                           double elevationMask, LookAngle *out) {
+    const double phi = qDegreesToRadians(lat);
+    const double lambda = qDegreesToRadians(lon);
+    const double sinPhi = std::sin(phi);
+    const double cosPhi = std::cos(phi);
+    const double sinLambda = std::sin(lambda);
+    const double cosLambda = std::cos(lambda);
+    const double n = WgsA / std::sqrt(1.0 - WgsE2 * sinPhi * sinPhi);
+    const double x = (n + height) * cosPhi * cosLambda;
+    const double y = (n + height) * cosPhi * sinLambda;
+    const double z = (n * (1.0 - WgsE2) + height) * sinPhi;
+    const double sinMask = std::sin(qDegreesToRadians(elevationMask));
+
+    int count = 0;
+    for (int i = 0; i < snapshot.count; i++) {
+        const Satellite &sat = snapshot.satellites[i];
+        const double dx = sat.x - x;
+        const double dy = sat.y - y;
+        const double dz = sat.z - z;
+        const double east = -sinLambda * dx + cosLambda * dy;
+        const double north = -sinPhi * cosLambda * dx - sinPhi * sinLambda * dy + cosPhi * dz;
+        const double up = cosPhi * cosLambda * dx + cosPhi * sinLambda * dy + sinPhi * dz;
+        const double range = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (up < sinMask * range) {
+            continue;
+        }
+
+        LookAngle &look = out[count++];
+        look.index = i;
+        look.elevation = qRadiansToDegrees(std::asin(up / range));
+        look.azimuth = std::fmod(qRadiansToDegrees(std::atan2(east, north)) + 360.0, 360.0);
+    }
+    return count;
+}
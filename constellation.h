@@ -0,0 +1,64 @@
+#ifndef CONSTELLATION_H
+#define CONSTELLATION_H
+
+#include <QtGlobal>
+
+// GPS-like constellation on circular orbits (Walker 55 deg: N/6 planes,
+// 12 h period, Earth rotation included). Satellites are numbered through
+// several GNSS in turn, so up to MaxSatellites SVs keep distinct
+// gnssId/svId pairs. One snapshot of satellite ECEF
+// positions and epoch time is computed per navigation epoch and shared
+// read-only by every receiver; each receiver only works out its own look
+// angles from it.
+class Constellation {
+public:
+    static constexpr int MaxSatellites = 128;
+
+    struct Satellite {
+        quint8 gnssId;
+        quint8 svId;
+        double x;           // ECEF, m
+        double y;
+        double z;
+    };
+
+    struct Snapshot {
+        quint32 epoch = 0;
+        qint64 timeMs = 0;  // UTC, ms since the Unix epoch
+        quint32 iTOW = 0;   // ms
+        quint16 year = 0;   // UTC date and time for NAV-PVT
+        quint8 month = 0;
+        quint8 day = 0;
+        quint8 hour = 0;
+        quint8 minute = 0;
+        quint8 second = 0;
+        int count = 0;
+        Satellite satellites[MaxSatellites];
+    };
+
+    struct LookAngle {
+        int index;          // Into Snapshot::satellites
+        double elevation;   // deg
+        double azimuth;     // deg, 0..360
+    };
+
+    explicit Constellation(int satellites = 24);
+
+    int satelliteCount() const { return m_count; }
+
+    // Recomputes the snapshot for the given time; the previous one is
+    // overwritten, so call it only between epochs
+    const Snapshot &advance(quint32 epoch, qint64 timeMs);
+    const Snapshot &snapshot() const { return m_snapshot; }
+
+    // Satellites above the mask as seen from a geodetic position (WGS-84),
+    // returns how many were written to out (MaxSatellites at most)
+    static int visible(const Snapshot &snapshot, double lat, double lon, double height,
+                       double elevationMask, LookAngle *out);
+
+private:
+    int m_count;
+    Snapshot m_snapshot;
+};
+
+#endif // CONSTELLATION_H
@@ -1,6 +1,7 @@
 #include "dialog.h"
 #include "ui_dialog.h"
 #include "gnsswindow.h"
+#include "udpfanouttransport.h"
 #include <QMessageBox>
 #include <QDebug>
 #include <QTimer>
@@ -9,7 +10,6 @@
 Dialog::Dialog(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::Dialog),
-    m_socket(new QTcpSocket(this)),
     m_gnssWindow(nullptr),
     m_connectionTimer(new QTimer(this)) {
     ui->setupUi(this);
@@ -18,29 +18,44 @@ Dialog::Dialog(QWidget *parent) :
     m_connectionTimer->setInterval(10000);
     connect(m_connectionTimer, &QTimer::timeout, this, &Dialog::onConnectionTimeout);
 
-    connect(m_socket, &QTcpSocket::connected, this, &Dialog::onConnected);
-    connect(m_socket, &QTcpSocket::disconnected, this, &Dialog::onDisconnected);
-    connect(m_socket, &QTcpSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
-        qDebug() << tr("Socket state changed to: %1").arg(state);
+    connect(ui->cbTransport, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        // The shared-memory segment is named after the port
+        ui->leIpAddress->setEnabled(index != UbxTransport::Pty && index != UbxTransport::SharedMemory);
+        ui->lePort->setEnabled(index != UbxTransport::Pty);
+        ui->cbUdpPacking->setEnabled(index == UbxTransport::UdpFanout);
+        ui->chkUdpSequence->setEnabled(index == UbxTransport::UdpFanout);
     });
-    connect(m_socket, &QTcpSocket::errorOccurred, this, &Dialog::onError);
 
-    connect(m_socket, &QTcpSocket::readyRead, this, [this]() {
-        QByteArray newData = m_socket->readAll();
+    ui->leIpAddress->setText("192.168.2.22");
+    ui->lePort->setText("40001");
+
+    qDebug() << tr("Dialog initialized");
+}
+
+void Dialog::setTransport(UbxTransport *transport) {
+    if (m_transport) {
+        m_transport->disconnect(this);
+        m_transport->close();
+        m_transport->deleteLater();
+    }
+
+    m_transport = transport;
+
+    connect(m_transport, &UbxTransport::opened, this, &Dialog::onConnected);
+    connect(m_transport, &UbxTransport::closed, this, &Dialog::onDisconnected);
+    connect(m_transport, &UbxTransport::errorOccurred, this, &Dialog::onError);
+
+    connect(m_transport, &UbxTransport::readyRead, this, [this]() {
+        QByteArray newData = m_transport->readAll();
         m_receiveBuffer.append(newData);
         qDebug() << tr("Data received: %1 bytes, total buffer: %2 bytes")
                         .arg(newData.size()).arg(m_receiveBuffer.size());
     });
-
-    ui->leIpAddress->setText("192.168.2.22");
-    ui->lePort->setText("40001");
-
-    qDebug() << tr("Dialog initialized, socket state: %1").arg(m_socket->state());
 }
 
 void Dialog::onConnectionTimeout() {
-    if (m_socket->state() == QAbstractSocket::ConnectingState) {
-        m_socket->abort();
+    if (m_transport && !m_transport->isOpen()) {
+        m_transport->close();
         QMessageBox::warning(this, tr("Timeout"), tr("Connection timed out"));
     }
 }
@@ -52,8 +67,8 @@ void Dialog::onDisconnected() {
 
     qDebug() << tr("Disconnected from host");
 
-    if (m_socket) {
-        m_socket->abort();
+    if (m_transport) {
+        m_transport->close();
     }
 }
 
@@ -62,13 +77,13 @@ void Dialog::onConnected() {
 
     if (!m_gnssWindow) {
         m_gnssWindow = new GNSSWindow(this);
-        m_gnssWindow->setSocket(m_socket);
+        m_gnssWindow->setTransport(m_transport);
         m_gnssWindow->setReceiveBuffer(&m_receiveBuffer);
         m_gnssWindow->show();
         this->hide();
     }
 
-    emit logMessage(tr("Connected to autopilot"), "system");
+    emit logMessage(tr("Connected to autopilot via %1").arg(m_transport->description()), "system");
 }
 
 void Dialog::appendToLog(const QString &message, const QString &type) {
@@ -81,38 +96,43 @@ void Dialog::appendToLog(const QString &message, const QString &type) {
 }
 
 void Dialog::on_connectButton_clicked() {
+    const UbxTransport::Kind kind = static_cast<UbxTransport::Kind>(ui->cbTransport->currentIndex());
     QString host = ui->leIpAddress->text().trimmed();
     QString portStr = ui->lePort->text().trimmed();
+    quint16 port = 0;
 
-    if (host.isEmpty() || portStr.isEmpty()) {
+    if (kind != UbxTransport::Pty) {
+        if ((host.isEmpty() && kind != UbxTransport::SharedMemory) || portStr.isEmpty()) {
             QMessageBox::warning(this, tr("Error"), tr("Please enter host and port"));
-        return;
-    }
+            return;
+        }
 
-    bool ok;
-    quint16 port = portStr.toUShort(&ok);
-    if (!ok || port == 0) {
-        QMessageBox::warning(this, tr("Error"), tr("Invalid port number"));
-        return;
+        bool ok;
+        port = portStr.toUShort(&ok);
+        if (!ok || port == 0) {
+            QMessageBox::warning(this, tr("Error"), tr("Invalid port number"));
+            return;
+        }
     }
 
-    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
-        m_socket->disconnectFromHost();
-        if (m_socket->state() != QAbstractSocket::UnconnectedState) {
-            m_socket->waitForDisconnected(1000);
-        }
+    UbxTransport *transport = UbxTransport::create(kind, host, port, this);
+    if (auto *fanout = qobject_cast<UdpFanoutTransport*>(transport)) {
+        fanout->setPacking(static_cast<UdpFanoutTransport::Packing>(ui->cbUdpPacking->currentIndex()));
+        fanout->setSequenceHeader(ui->chkUdpSequence->isChecked());
     }
+    setTransport(transport);
 
-    m_socket->connectToHost(host, port);
-    m_connectionTimer->start(10000);
+    // A server waits for the autopilot as long as it takes
+    if (kind == UbxTransport::TcpClient) {
+        m_connectionTimer->start(10000);
+    }
+    m_transport->open();
 }
 
-void Dialog::onError(QAbstractSocket::SocketError error) {
-    Q_UNUSED(error)
+void Dialog::onError(const QString &message) {
     m_connectionTimer->stop();
 
-    QString errorMsg = m_socket->errorString();
-    QMessageBox::critical(this, tr("Connection Error"), errorMsg);
+    QMessageBox::critical(this, tr("Connection Error"), message);
 
     if (m_gnssWindow) {
         m_gnssWindow->close();
@@ -124,9 +144,9 @@ void Dialog::onError(QAbstractSocket::SocketError error) {
 Dialog::~Dialog() {
     m_connectionTimer->stop();
 
-    if (m_socket->state() == QAbstractSocket::ConnectedState) {
-        m_socket->disconnectFromHost();
-        m_socket->waitForDisconnected(1000);
+    if (m_transport) {
+        m_transport->disconnect(this);
+        m_transport->close();
     }
 
     delete m_connectionTimer;
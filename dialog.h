@@ -2,8 +2,8 @@
 #define DIALOG_H
 
 #include <QDialog>
-#include <QTcpSocket>
 #include <QTranslator>
+#include "ubxtransport.h"
 
 class GNSSWindow;
 
@@ -18,7 +18,7 @@ public:
     explicit Dialog(QWidget *parent = nullptr);
     ~Dialog();
 
-    QTcpSocket* getSocket() const { return m_socket; }
+    UbxTransport* getTransport() const { return m_transport; }
     QByteArray& getReceiveBuffer() { return m_receiveBuffer; }
     void appendToLog(const QString &message, const QString &type = "info");
 
@@ -30,12 +30,14 @@ private slots:
     void on_connectButton_clicked();
     void onConnected();
     void onDisconnected();
-    void onError(QAbstractSocket::SocketError error);
+    void onError(const QString &message);
     void onConnectionTimeout();
 
 private:
+    void setTransport(UbxTransport *transport);
+
     Ui::Dialog *ui;
-    QTcpSocket *m_socket;
+    UbxTransport *m_transport = nullptr;
     GNSSWindow *m_gnssWindow = nullptr;
     QTimer *m_connectionTimer;
     QByteArray m_receiveBuffer;
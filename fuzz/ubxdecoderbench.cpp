@@ -0,0 +1,50 @@
+#include "ubxdecoderharness.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+
+// Replays the seed corpus through the framer and decoders and reports
+// throughput. Usage: ubx_decoder_bench [corpus dir] [passes]
+int main(int argc, char *argv[]) {
+    const QString corpusPath = argc > 1 ? QString::fromLocal8Bit(argv[1])
+                                        : QStringLiteral(UBX_FUZZ_CORPUS_DIR);
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    QVector<QByteArray> inputs;
+    qint64 inputBytes = 0;
+    const QDir corpus(corpusPath);
+    for (const QString &name : corpus.entryList(QDir::Files, QDir::Name)) {
+        QFile file(corpus.filePath(name));
+        if (file.open(QIODevice::ReadOnly)) {
+            inputs.append(file.readAll());
+            inputBytes += inputs.last().size();
+        }
+    }
+    if (inputs.isEmpty() || passes <= 0) {
+        std::fprintf(stderr, "No corpus files in %s\n", qPrintable(corpusPath));
+        return 1;
+    }
+
+    UbxDecoderHarness::silenceWarnings();
+    UbxDecoderHarness harness;
+    quint64 frames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int pass = 0; pass < passes; pass++) {
+        for (const QByteArray &input : inputs) {
+            frames += harness.run(input.constData(), input.size());
+        }
+    }
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    const double bytes = double(inputBytes) * passes;
+    std::printf("%d inputs, %lld bytes, %d passes in %.3f s\n",
+                int(inputs.size()), static_cast<long long>(inputBytes), passes, seconds);
+    std::printf("%.1f MB/s, %.0f frames/s, %.1f ns/frame\n",
+                bytes / seconds / 1e6, frames / seconds, seconds * 1e9 / qMax<quint64>(frames, 1));
+    return 0;
+}
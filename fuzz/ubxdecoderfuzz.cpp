@@ -0,0 +1,17 @@
+#include "ubxdecoderharness.h"
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***) {
+    UbxDecoderHarness::silenceWarnings();
+    return 0;
+}
+
+// libFuzzer entry point, see IMITATOR_FUZZ in CMakeLists.txt. Run with
+// the seed corpus, e.g. ./ubx_decoder_fuzz -max_len=4096 fuzz/corpus
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static UbxDecoderHarness harness;
+    harness.run(reinterpret_cast<const char *>(data), static_cast<int>(size));
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef UBX_DECODER_HARNESS_H
+#define UBX_DECODER_HARNESS_H
+
+#include "ubxframer.h"
+#include "ubxparser.h"
+
+#include <QtGlobal>
+
+// Shared by the fuzz target and the benchmark: splits input into frames
+// and runs every decoder on each payload regardless of its class/ID, then
+// once more on the raw input, so decoders are reached without a valid
+// checksum in front of them.
+class UbxDecoderHarness {
+public:
+    // The decoders qWarning() on every short payload; without this the fuzz
+    // target and the benchmark mostly measure stderr
+    static void silenceWarnings() {
+        qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+    }
+
+    // Returns the number of frames the framer found
+    quint64 run(const char *data, int size) {
+        const quint64 framesBefore = m_framer.stats().frames;
+
+        m_buffer.clear();
+        m_buffer.append(data, size);
+        m_framer.process(m_buffer, [this](quint8, quint8, const QByteArray &payload) {
+            decodeAll(payload);
+        });
+
+        decodeAll(QByteArray::fromRawData(data, size));
+        return m_framer.stats().frames - framesBefore;
+    }
+
+private:
+    void decodeAll(const QByteArray &payload) {
+        UbxParser::decodeNavPvt(payload, m_navPvt);
+        UbxParser::decodeNavSat(payload, m_navSat);
+        UbxParser::decodeNavStatus(payload, m_navStatus);
+        UbxParser::decodeCfgPrt(payload, m_cfgPrt);
+        UbxParser::decodeMonVer(payload, m_monVer);
+        UbxParser::decodeMonHw(payload, m_monHw);
+        UbxParser::decodeMonRf(payload, m_monRf);
+        UbxParser::decodeSecUniqid(payload, m_secUniqid);
+        UbxParser::decodeCfgMsg(payload, m_cfgMsg);
+        UbxParser::parseCfgItfm(payload);
+        UbxParser::parseAck(payload);
+    }
+
+    UbxFramer m_framer;
+    QByteArray m_buffer;
+
+    // Reused so the large NAV-SAT and MON-RF results are not rebuilt per call
+    UbxParser::NavPvt m_navPvt;
+    UbxParser::NavSat m_navSat;
+    UbxParser::NavStatus m_navStatus;
+    UbxParser::CfgPrt m_cfgPrt;
+    UbxParser::MonVer m_monVer;
+    UbxParser::MonHw m_monHw;
+    UbxParser::MonRf m_monRf;
+    UbxParser::SecUniqid m_secUniqid;
+    UbxParser::CfgMsg m_cfgMsg;
+};
+
+#endif // UBX_DECODER_HARNESS_H
@@ -0,0 +1,108 @@
+#include "gnsserrormodel.h"
+
+#include <QCoreApplication>
+#include <QtMath>
+#include <cmath>
+
+bool GnssErrorModel::Config::fromJson(const QJsonObject &json, Config &config, QString &error) {
+    Config result;
+    result.enabled = json["enabled"].toBool(true);
+    result.seed = static_cast<quint32>(json["seed"].toDouble(1));
+    result.positionTau = json["positionTau"].toDouble(result.positionTau);
+    result.velocityTau = json["velocityTau"].toDouble(result.velocityTau);
+    result.verticalRatio = json["verticalRatio"].toDouble(result.verticalRatio);
+    result.biasRate = json["biasRate"].toDouble(result.biasRate);
+    result.biasLimit = json["biasLimit"].toDouble(result.biasLimit);
+    result.burstRate = json["burstRate"].toDouble(result.burstRate);
+    result.burstDuration = json["burstDuration"].toDouble(result.burstDuration);
+    result.burstSigma = json["burstSigma"].toDouble(result.burstSigma);
+
+    if (result.positionTau <= 0 || result.velocityTau <= 0 || result.verticalRatio <= 0 ||
+        result.biasRate < 0 || result.biasLimit < 0 || result.burstRate < 0 ||
+        result.burstDuration <= 0 || result.burstSigma < 0) {
+        error = QCoreApplication::translate("GnssErrorModel", "Time constants and durations must be "
+                                            "positive, rates and sigmas non-negative");
+        return false;
+    }
+
+    config = result;
+    return true;
+}
+
+void GnssErrorModel::setConfig(const Config &config) {
+    m_config = config;
+    m_normal.reseed(config.seed);
+    m_uniformEngine.seed(config.seed);
+    for (int axis = 0; axis < AxisCount; axis++) {
+        m_position[axis] = 0.0;
+        m_velocity[axis] = 0.0;
+        m_bias[axis] = 0.0;
+    }
+    m_burst[0] = m_burst[1] = 0.0;
+    m_burstRemaining = 0.0;
+}
+
+// Exact discretisation: x' = phi x + sigma sqrt(1 - phi^2) w keeps the
+// stationary sigma whatever dt is
+GnssErrorModel::Markov GnssErrorModel::markov(double dt, double tau) {
+    const double phi = std::exp(-dt / tau);
+    return { phi, std::sqrt(1.0 - phi * phi) };
+}
+
+GnssErrorModel::Output GnssErrorModel::step(double dt, double rmsPos, double rmsVel) {
+    Output out = {};
+    dt = qMax(0.0, dt);
+
+    const double horizontalSigma = rmsPos / M_SQRT2;
+    const double positionSigma[AxisCount] = {
+        horizontalSigma, horizontalSigma, horizontalSigma * m_config.verticalRatio
+    };
+    const double velocitySigma = rmsVel / std::sqrt(3.0);
+    const double biasStep = m_config.biasRate * std::sqrt(dt);
+    const Markov position = markov(dt, m_config.positionTau);
+    const Markov velocity = markov(dt, m_config.velocityTau);
+
+    for (int axis = 0; axis < AxisCount; axis++) {
+        m_position[axis] = position.phi * m_position[axis] + positionSigma[axis] * position.gain * m_normal.next();
+        m_velocity[axis] = velocity.phi * m_velocity[axis] + velocitySigma * velocity.gain * m_normal.next();
+
+        double bias = m_bias[axis] + biasStep * m_normal.next();
+        if (bias > m_config.biasLimit) {
+            bias = 2 * m_config.biasLimit - bias;
+        } else if (bias < -m_config.biasLimit) {
+            bias = -2 * m_config.biasLimit - bias;
+        }
+        m_bias[axis] = qBound(-m_config.biasLimit, bias, m_config.biasLimit);
+    }
+
+    // Bursts arrive as a Poisson process and decorrelate quickly
+    if (m_burstRemaining <= 0.0) {
+        std::uniform_real_distribution<double> uniform;
+        if (uniform(m_uniformEngine) < 1.0 - std::exp(-m_config.burstRate / 60.0 * dt)) {
+            m_burstRemaining = m_config.burstDuration;
+        }
+    }
+    const bool burst = m_burstRemaining > 0.0;
+    if (burst) {
+        const Markov multipath = markov(dt, 1.0);
+        for (double &offset : m_burst) {
+            offset = multipath.phi * offset + m_config.burstSigma * multipath.gain * m_normal.next();
+        }
+    } else {
+        m_burst[0] = m_burst[1] = 0.0;
+    }
+    m_burstRemaining = qMax(0.0, m_burstRemaining - dt);
+
+    for (int axis = 0; axis < AxisCount; axis++) {
+        out.position[axis] = m_position[axis] + m_bias[axis] + (axis < 2 ? m_burst[axis] : 0.0);
+        out.velocity[axis] = m_velocity[axis];
+    }
+
+    const double burstVariance = burst ? 2.0 * m_config.burstSigma * m_config.burstSigma : 0.0;
+    out.hAcc = std::sqrt(2.0 * horizontalSigma * horizontalSigma + m_bias[North] * m_bias[North] +
+                         m_bias[East] * m_bias[East] + burstVariance);
+    out.vAcc = std::sqrt(positionSigma[Up] * positionSigma[Up] + m_bias[Up] * m_bias[Up]);
+    out.sAcc = rmsVel;
+    out.burst = burst;
+    return out;
+}
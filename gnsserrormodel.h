@@ -0,0 +1,87 @@
+#ifndef GNSS_ERROR_MODEL_H
+#define GNSS_ERROR_MODEL_H
+
+#include <QJsonObject>
+#include <QtGlobal>
+#include <random>
+#include "normalblocksampler.h"
+
+// Position and velocity error of a receiver, per local axis (north, east,
+// up). Each axis is a first-order Gauss-Markov process whose stationary
+// sigma comes from the configured RMS, plus a random-walk bias on the
+// position axes and occasional multipath bursts on the horizontal ones.
+// The reported accuracies follow the error actually applied: the
+// Gauss-Markov sigma, the current bias and, during a burst, the burst
+// sigma.
+//
+// {
+//   "seed": 7,
+//   "positionTau": 30,    s, correlation time of the position error
+//   "velocityTau": 2,     s
+//   "verticalRatio": 1.7, vertical sigma relative to one horizontal axis
+//   "biasRate": 0.02,     m/sqrt(s), random-walk intensity
+//   "biasLimit": 3,       m, the walk reflects at +-limit
+//   "burstRate": 0.5,     multipath bursts per minute
+//   "burstDuration": 8,   s
+//   "burstSigma": 4       m, extra horizontal sigma during a burst
+// }
+class GnssErrorModel {
+public:
+    enum Axis {
+        North,
+        East,
+        Up,
+        AxisCount
+    };
+
+    struct Config {
+        bool enabled = false;
+        quint32 seed = 1;
+        double positionTau = 30.0;
+        double velocityTau = 2.0;
+        double verticalRatio = 1.7;
+        double biasRate = 0.02;
+        double biasLimit = 3.0;
+        double burstRate = 0.5;
+        double burstDuration = 8.0;
+        double burstSigma = 4.0;
+
+        static bool fromJson(const QJsonObject &json, Config &config, QString &error);
+    };
+
+    struct Output {
+        double position[AxisCount];     // m
+        double velocity[AxisCount];     // m/s
+        double hAcc;                    // m
+        double vAcc;                    // m
+        double sAcc;                    // m/s
+        bool burst;
+    };
+
+    void setConfig(const Config &config);
+    const Config &config() const { return m_config; }
+    bool isEnabled() const { return m_config.enabled; }
+
+    // Advances the model by dt seconds. rmsPos is the horizontal RMS
+    // position error, rmsVel the 3D RMS velocity error.
+    Output step(double dt, double rmsPos, double rmsVel);
+
+private:
+    struct Markov {
+        double phi;
+        double gain;
+    };
+
+    static Markov markov(double dt, double tau);
+
+    Config m_config;
+    NormalBlockSampler m_normal;
+    std::mt19937 m_uniformEngine;
+    double m_position[AxisCount] = {};
+    double m_velocity[AxisCount] = {};
+    double m_bias[AxisCount] = {};
+    double m_burst[2] = {};
+    double m_burstRemaining = 0.0;  // s
+};
+
+#endif // GNSS_ERROR_MODEL_H
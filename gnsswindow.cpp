@@ -11,15 +11,22 @@
 #include "dialog.h"
 #include "ubxparser.h"
 #include "ubxdefs.h"
+#include "ubxtime.h"
+#include "ptytransport.h"
+#include <QDockWidget>
+#include <QListView>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QtMath>
+#include <cmath>
 
 GNSSWindow::GNSSWindow(Dialog* parentDialog, QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::GNSSWindow),
     m_parentDialog(parentDialog),
-    m_socket(nullptr),
+    m_transport(nullptr),
     m_receiveBuffer(nullptr),
-    m_pvtTimer(new QTimer(this)),
-    m_statusTimer(new QTimer(this)),
+    m_epochTimer(new QTimer(this)),
     m_initTimer(new QTimer(this)),
     m_ackTimeoutTimer(new QTimer(this)),
     m_utcTimer(new QTimer(this)),
@@ -27,8 +34,7 @@ GNSSWindow::GNSSWindow(Dialog* parentDialog, QWidget *parent) :
     m_waitingForAck(false) {
     ui->setupUi(this);
 
-    m_pvtTimer->setInterval(1000);
-    m_statusTimer->setInterval(1000);
+    m_epochTimer->setInterval(1000);
     m_initTimer->setSingleShot(true);
     m_initTimer->setInterval(15000);
     m_ackTimeoutTimer->setSingleShot(true);
@@ -42,6 +48,72 @@ GNSSWindow::GNSSWindow(Dialog* parentDialog, QWidget *parent) :
 
     setupConnections();
 
+    ui->teReceived->document()->setMaximumBlockCount(LogViewMaxLines);
+    m_logJournal = new UbxLogJournal(this);
+    connect(m_logJournal, &UbxLogJournal::exportFinished, this, [this](bool ok, const QString &message) {
+        if (ok) {
+            ui->statusbar->showMessage(message, 5000);
+        } else {
+            QMessageBox::warning(this, tr("Error"), tr("Could not save file: %1").arg(message));
+        }
+    });
+    connect(m_logJournal, &UbxLogJournal::errorOccurred, this, [this](const QString &message) {
+        appendToLog(message, "error");
+    });
+    connect(m_logJournal, &UbxLogJournal::opened, this, [this](bool ok) {
+        if (!ok) {
+            appendToLog(tr("Log journal unavailable, export covers the visible log only"), "warning");
+        }
+    });
+    m_logJournal->open();
+
+    setupLogSearch();
+
+    m_telemetry = new TelemetryDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_telemetry);
+    m_telemetry->hide();
+    ui->toolBar->addAction(m_telemetry->toggleViewAction());
+
+    m_faults = new UbxFaultInjector(this);
+    m_faults->setSink([this](const char *data, int size) { writeFrame(data, size); });
+    QAction *loadFaults = ui->toolBar->addAction(tr("Faults..."));
+    connect(loadFaults, &QAction::triggered, this, &GNSSWindow::loadFaultConfig);
+    m_stopFaultsAction = ui->toolBar->addAction(tr("Stop Faults"));
+    m_stopFaultsAction->setEnabled(false);
+    connect(m_stopFaultsAction, &QAction::triggered, this, &GNSSWindow::stopFaults);
+
+    QAction *loadScenario = ui->toolBar->addAction(tr("RF Scenario..."));
+    connect(loadScenario, &QAction::triggered, this, &GNSSWindow::loadRfScenario);
+    m_stopRfScenarioAction = ui->toolBar->addAction(tr("Stop RF Scenario"));
+    m_stopRfScenarioAction->setEnabled(false);
+    connect(m_stopRfScenarioAction, &QAction::triggered, this, &GNSSWindow::stopRfScenario);
+
+    m_vehicleInput = new VehicleInput(this);
+    QAction *loadVehicle = ui->toolBar->addAction(tr("Vehicle Input..."));
+    connect(loadVehicle, &QAction::triggered, this, &GNSSWindow::loadVehicleInput);
+    m_stopVehicleInputAction = ui->toolBar->addAction(tr("Stop Vehicle Input"));
+    m_stopVehicleInputAction->setEnabled(false);
+    connect(m_stopVehicleInputAction, &QAction::triggered, this, &GNSSWindow::stopVehicleInput);
+
+    QAction *loadErrors = ui->toolBar->addAction(tr("Error Model..."));
+    connect(loadErrors, &QAction::triggered, this, &GNSSWindow::loadErrorModel);
+    m_stopErrorModelAction = ui->toolBar->addAction(tr("Stop Error Model"));
+    m_stopErrorModelAction->setEnabled(false);
+    connect(m_stopErrorModelAction, &QAction::triggered, this, &GNSSWindow::stopErrorModel);
+
+    // Log records are rendered in batches, off the send path
+    m_logDrainTimer = new QTimer(this);
+    connect(m_logDrainTimer, &QTimer::timeout, this, &GNSSWindow::drainLog);
+    m_logDrainTimer->start(50);
+
+    m_bandwidthLabel = new QLabel(this);
+    ui->statusbar->addPermanentWidget(m_bandwidthLabel);
+    updateEpochTimer();
+    updateBandwidthBudget();
+
+    openConfigStore();
+    connect(ui->leChipId, &QLineEdit::editingFinished, this, &GNSSWindow::openConfigStore);
+
     m_utcTimer->start(1000);
     updateUTCTime();
 
@@ -319,6 +391,8 @@ QJsonObject GNSSWindow::getCurrentSettings() const {
     secUniqidSettings["chipId"] = ui->leChipId->text();
     settings["secUniqid"] = secUniqidSettings;
 
+    settings["logFilter"] = m_logFilterModel->filter().toJson();
+
     return settings;
 }
 
@@ -331,49 +405,21 @@ void GNSSWindow::processBuffer() {
         return;
     }
 
-    qDebug() << "Processing buffer:" << m_receiveBuffer->size() << "bytes";
-
-    while (m_receiveBuffer->size() >= 8) {
-        int startPos = m_receiveBuffer->indexOf("\xB5\x62");
-        if (startPos < 0) {
-            qDebug() << "No UBX sync chars found, clearing buffer";
-            m_receiveBuffer->clear();
-            return;
-        }
-
-        if (startPos > 0) {
-            qDebug() << "Discarding" << startPos << "bytes before sync chars";
-            m_receiveBuffer->remove(0, startPos);
-            continue;
-        }
-
-        if (m_receiveBuffer->size() < 8) {
-            qDebug() << "Waiting for more data (header incomplete)";
-            return;
-        }
-
-        quint16 length = static_cast<quint8>((*m_receiveBuffer)[4]) |
-                         (static_cast<quint8>((*m_receiveBuffer)[5]) << 8);
-        quint8 msgClass = static_cast<quint8>((*m_receiveBuffer)[2]);
-        quint8 msgId = static_cast<quint8>((*m_receiveBuffer)[3]);
-
-        int totalMessageSize = 8 + length;
-        if (m_receiveBuffer->size() < totalMessageSize) {
-            qDebug() << "Waiting for more data. Need:" << totalMessageSize
-                     << "Have:" << m_receiveBuffer->size();
-            return;
-        }
-
-        QByteArray message = m_receiveBuffer->left(totalMessageSize);
-        m_receiveBuffer->remove(0, totalMessageSize);
+    const UbxFramer::Stats before = m_framer.stats();
+    m_framer.process(*m_receiveBuffer, [this](quint8 msgClass, quint8 msgId, const QByteArray &payload) {
+        processUbxMessage(msgClass, msgId, payload);
+    });
 
-        QByteArray payload;
-        if (UbxParser::parseUbxMessage(message, msgClass, msgId, payload)) {
-            processUbxMessage(msgClass, msgId, payload);
-        } else {
-            qWarning() << "Failed to parse UBX message";
-            appendToLog(tr("Failed to parse UBX message"), "error");
-        }
+    // One line per read, not per rejected candidate
+    const UbxFramer::Stats &stats = m_framer.stats();
+    if (stats.resyncs != before.resyncs) {
+        appendToLog(tr("Resynchronized after %1 bad frame(s) (%2 checksum, %3 length); "
+                       "%4 resyncs, %5 bytes discarded so far")
+                        .arg(stats.resyncs - before.resyncs)
+                        .arg(stats.checksumErrors - before.checksumErrors)
+                        .arg(stats.oversizeLengths - before.oversizeLengths)
+                        .arg(stats.resyncs)
+                        .arg(stats.discardedBytes), "warning");
     }
 }
 
@@ -384,8 +430,8 @@ void GNSSWindow::clearReceiveBuffer() {
 }
 
 void GNSSWindow::onReadyRead() {
-    if (!m_socket || !m_receiveBuffer) {
-        qCritical() << "onReadyRead: Socket or buffer not initialized!";
+    if (!m_transport || !m_receiveBuffer) {
+        qCritical() << "onReadyRead: Transport or buffer not initialized!";
         return;
     }
 
@@ -647,6 +693,19 @@ void GNSSWindow::applySettings(const QJsonObject &settings)
         widget->blockSignals(false);
     }
 
+    openConfigStore();
+
+    if (settings.contains("logFilter")) {
+        setLogFilterControls(UbxLogIndex::Filter::fromJson(settings["logFilter"].toObject()));
+    }
+
+    // valueChanged was blocked above, so cached frames cannot know what changed
+    m_frameCache.invalidateAll();
+    publishSimState();
+    if (m_transport) {
+        m_transport->setBaudRate(ui->cbBaudRate->currentText().toUInt());
+    }
+
     updateAvailableIds();
     onClassIdChanged();
 
@@ -656,27 +715,29 @@ void GNSSWindow::applySettings(const QJsonObject &settings)
     appendToLog(tr("All settings applied from configuration"), "system");
 }
 
-void GNSSWindow::setSocket(QTcpSocket *socket) {
-    if (m_socket) {
-        m_socket->disconnect(this);
+void GNSSWindow::setTransport(UbxTransport *transport) {
+    if (m_transport) {
+        m_transport->disconnect(this);
     }
 
-    m_socket = socket;
+    m_transport = transport;
+    m_portConfig = {};
 
-    if (m_socket) {
-        connect(m_socket, &QTcpSocket::readyRead, this, &GNSSWindow::onReadyRead);
+    if (m_transport) {
+        connect(m_transport, &UbxTransport::readyRead, this, &GNSSWindow::onReadyRead);
 
-        connect(m_socket, &QTcpSocket::disconnected, this, [this]() {
+        connect(m_transport, &UbxTransport::closed, this, [this]() {
             appendToLog(tr("Disconnected from host"), "system");
             m_timer->stop();
-            m_socket = nullptr;
+            m_transport = nullptr;
         });
 
-        connect(m_socket, &QTcpSocket::errorOccurred, this, &GNSSWindow::onError);
+        connect(m_transport, &UbxTransport::errorOccurred, this, &GNSSWindow::onError);
 
-        appendToLog(tr("Socket connected and configured"), "debug");
+        m_transport->setBaudRate(ui->cbBaudRate->currentText().toUInt());
+        appendToLog(tr("Transport configured: %1").arg(m_transport->description()), "debug");
     } else {
-        appendToLog(tr("Socket pointer is null!"), "error");
+        appendToLog(tr("Transport pointer is null!"), "error");
     }
 }
 
@@ -686,11 +747,9 @@ void GNSSWindow::handleInitTimeout()
         appendToLog(tr("Configuration timeout - proceeding without ACK"), "warning");
         m_initializationComplete = true;
 
-        if (m_socket && m_socket->state() == QAbstractSocket::ConnectedState) {
-            int rate = ui->rateSpin->value();
-            m_pvtTimer->start(1000 / rate);
-            m_statusTimer->start(1000 / rate);
+        if (m_transport && m_transport->isOpen()) {
             ui->autoSendCheck->setChecked(true);
+            onAutoSendToggled(true);
         }
     }
 }
@@ -703,44 +762,18 @@ void GNSSWindow::handleAckTimeout()
     }
 }
 
-void GNSSWindow::handleSocketDisconnected()
-{
-    appendToLog(tr("Disconnected from host"), "system");
-    m_timer->stop();
-    m_socket = nullptr;
-}
-
-void GNSSWindow::handleSocketError(QAbstractSocket::SocketError error)
-{
-    Q_UNUSED(error);
-    QString errorMsg = m_socket ? m_socket->errorString() : "Socket not initialized";
-    appendToLog(tr("Socket error: ") + errorMsg, "error");
+void GNSSWindow::onError(const QString &message) {
+    appendToLog(tr("Transport error: %1").arg(message), "error");
 
     m_timer->stop();
     m_initializationComplete = false;
     m_waitingForAck = false;
 
-    if (m_socket && m_socket->state() != QAbstractSocket::UnconnectedState) {
-        m_socket->disconnectFromHost();
+    if (m_transport && m_transport->isOpen()) {
+        m_transport->close();
     }
 
-    ui->statusbar->showMessage(tr("Connection error: %1").arg(errorMsg), 5000);
-}
-
-void GNSSWindow::onError(QAbstractSocket::SocketError error) {
-    Q_UNUSED(error);
-    QString errorMsg = m_socket ? m_socket->errorString() : "Socket not initialized";
-    appendToLog(tr("Socket error: %1").arg(errorMsg), "error");
-
-    m_timer->stop();
-    m_initializationComplete = false;
-    m_waitingForAck = false;
-
-    if (m_socket && m_socket->state() != QAbstractSocket::UnconnectedState) {
-        m_socket->disconnectFromHost();
-    }
-
-    ui->statusbar->showMessage(tr("Connection error: %1").arg(errorMsg), 5000);
+    ui->statusbar->showMessage(tr("Connection error: %1").arg(message), 5000);
 }
 
 void GNSSWindow::updateUTCTime() {
@@ -750,18 +783,7 @@ void GNSSWindow::updateUTCTime() {
 }
 
 void GNSSWindow::onActionSaveLogTriggered() {
-    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Log"), "", tr("Text Files (*.txt);;All Files (*)"));
-    if (fileName.isEmpty()) return;
-
-    QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, tr("Error"), tr("Could not save file"));
-        return;
-    }
-
-    QTextStream out(&file);
-    out << ui->teReceived->toPlainText();
-    file.close();
+    saveLogToFile();
 }
 
 void GNSSWindow::onActionClearLogTriggered() {
@@ -978,7 +1000,7 @@ void GNSSWindow::setupCfgRateFields() {
 }
 
 void GNSSWindow::sendUbxInfDebug() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send INF-DEBUG"), "error");
         return;
     }
@@ -991,7 +1013,7 @@ void GNSSWindow::sendUbxInfDebug() {
 }
 
 void GNSSWindow::sendUbxInfError() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send INF-ERROR"), "error");
         return;
     }
@@ -1004,7 +1026,7 @@ void GNSSWindow::sendUbxInfError() {
 }
 
 void GNSSWindow::sendUbxInfNotice() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send INF-NOTICE"), "error");
         return;
     }
@@ -1017,7 +1039,7 @@ void GNSSWindow::sendUbxInfNotice() {
 }
 
 void GNSSWindow::sendUbxInfTest() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send INF-TEST"), "error");
         return;
     }
@@ -1030,7 +1052,7 @@ void GNSSWindow::sendUbxInfTest() {
 }
 
 void GNSSWindow::sendUbxInfWarning() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send INF-WARNING"), "error");
         return;
     }
@@ -1043,7 +1065,7 @@ void GNSSWindow::sendUbxInfWarning() {
 }
 
 void GNSSWindow::sendUbxCfgRate() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-RATE"), "error");
         return;
     }
@@ -1052,20 +1074,22 @@ void GNSSWindow::sendUbxCfgRate() {
     quint16 navRate = static_cast<quint16>(ui->sbNavRate->value());
     quint16 timeRef = static_cast<quint16>(ui->cbTimeRef->currentIndex());
 
-    QByteArray payload(6, 0x00);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgRate)) {
+        QByteArray payload(6, 0x00);
+
+        qToLittleEndian<quint16>(measRate, payload.data());
 
-    qToLittleEndian<quint16>(measRate, payload.data());
+        qToLittleEndian<quint16>(navRate, payload.data() + 2);
 
-    qToLittleEndian<quint16>(navRate, payload.data() + 2);
+        qToLittleEndian<quint16>(timeRef, payload.data() + 4);
 
-    qToLittleEndian<quint16>(timeRef, payload.data() + 4);
+        m_frameCache.store(UbxFrameCache::FrameCfgRate, UBX_CLASS_CFG, UBX_CFG_RATE, payload);
+    }
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_RATE, payload);
-    appendToLog(tr("CFG-RATE sent: MeasRate=%1ms, NavRate=%2, TimeRef=%3")
-                    .arg(measRate)
-                    .arg(navRate)
-                    .arg(timeRef),
-                    "config");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgRate));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgRateSent,
+             { UbxLog::num(measRate), UbxLog::num(navRate), UbxLog::num(timeRef) },
+             UBX_CLASS_CFG, UBX_CFG_RATE);
 }
 
 void GNSSWindow::onClassIdChanged()
@@ -1252,11 +1276,12 @@ void GNSSWindow::setupConnections()
 {
     m_timer = new QTimer(this);
     connect(m_timer, &QTimer::timeout, this, &GNSSWindow::sendUbxNavPvt);
-    connect(m_pvtTimer, &QTimer::timeout, this, &GNSSWindow::sendUbxNavPvt);
-    connect(m_statusTimer, &QTimer::timeout, this, &GNSSWindow::sendUbxNavStatus);
+    connect(m_epochTimer, &QTimer::timeout, this, &GNSSWindow::onNavigationEpoch);
     connect(m_initTimer, &QTimer::timeout, this, &GNSSWindow::handleInitTimeout);
     connect(m_ackTimeoutTimer, &QTimer::timeout, this, &GNSSWindow::handleAckTimeout);
     connect(m_utcTimer, &QTimer::timeout, this, &GNSSWindow::updateUTCTime);
+    connect(m_utcTimer, &QTimer::timeout, this, &GNSSWindow::updateBandwidthBudget);
+    connect(m_utcTimer, &QTimer::timeout, this, &GNSSWindow::reportVehicleInput);
 
     connect(ui->actionSaveSettings, &QAction::triggered,
             this, &GNSSWindow::onActionSaveSettingsTriggered);
@@ -1303,7 +1328,27 @@ void GNSSWindow::setupConnections()
     connect(ui->cbAutoSendInfTest, &QCheckBox::toggled, this, &GNSSWindow::onAutoSendInfTestToggled);
     connect(ui->cbAutoSendSecUniqid, &QCheckBox::toggled, this, &GNSSWindow::onAutoSendSecUniqidToggled);
 
+    connect(ui->cbBaudRate, &QComboBox::currentTextChanged, this, [this](const QString &text) {
+        if (m_transport) {
+            m_transport->setBaudRate(text.toUInt());
+        }
+    });
+
+    // Anything that changes the periodic output re-plans the UART budget
+    const QList<QCheckBox*> budgetCheckBoxes = findChildren<QCheckBox*>(QRegularExpression("cbAutoSend.*"));
+    for (QCheckBox *checkBox : budgetCheckBoxes) {
+        connect(checkBox, &QCheckBox::toggled, this, &GNSSWindow::updateBandwidthBudget);
+    }
+    connect(ui->autoSendCheck, &QCheckBox::toggled, this, &GNSSWindow::updateBandwidthBudget);
+    connect(ui->rateSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &GNSSWindow::updateEpochTimer);
+    connect(ui->rateSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &GNSSWindow::updateBandwidthBudget);
+    connect(ui->cbBaudRate, &QComboBox::currentTextChanged, this, &GNSSWindow::updateBandwidthBudget);
+    connect(ui->sbNumSatsSat, QOverload<int>::of(&QSpinBox::valueChanged), this, &GNSSWindow::updateBandwidthBudget);
+    connect(ui->sbRfBlocks, QOverload<int>::of(&QSpinBox::valueChanged), this, &GNSSWindow::updateBandwidthBudget);
+
     registerHandlers();
+    setupFrameCacheInvalidation();
+    setupSimStatePublishing();
 
     if (m_parentDialog) {
         connect(m_parentDialog, &Dialog::logMessage,
@@ -1313,18 +1358,147 @@ void GNSSWindow::setupConnections()
     }
 }
 
-void GNSSWindow::stopAllAutoSendTimers()
+void GNSSWindow::setupFrameCacheInvalidation()
 {
-    if (m_pvtTimer && m_pvtTimer->isActive()) {
-        m_pvtTimer->stop();
+    const QList<QPair<UbxFrameCache::FrameSlot, QList<QWidget*>>> sources = {
+        { UbxFrameCache::FrameMonVer, { ui->leSwVersion, ui->leHwVersion, ui->teExtensions } },
+        { UbxFrameCache::FrameSecUniqid, { ui->sbUniqidVersion, ui->leChipId } },
+        { UbxFrameCache::FrameCfgPrt, { ui->cbPortId, ui->cbBaudRate, ui->cbInUbx, ui->cbInNmea,
+                                        ui->cbInRtcm, ui->cbOutUbx, ui->cbOutNmea, ui->cbOutRtcm } },
+        { UbxFrameCache::FrameCfgItfm, { ui->sbBbThreshold, ui->sbCwThreshold, ui->cbEnable,
+                                         ui->cbAntSetting, ui->cbEnable2 } },
+        { UbxFrameCache::FrameCfgNav5, { ui->cbDynModel, ui->cbFixMode, ui->dsbFixedAlt, ui->sbMinElev,
+                                         ui->dsbPDOP, ui->dsbTDOP, ui->dsbPAcc, ui->dsbTAcc,
+                                         ui->dsbStaticHoldThresh, ui->sbDgnssTimeout, ui->sbCnoThresh,
+                                         ui->sbCnoThreshNumSVs, ui->cbUtcStandard, ui->dsbStaticHoldMaxDist } },
+        { UbxFrameCache::FrameCfgRate, { ui->sbMeasRate, ui->sbNavRate, ui->cbTimeRef } },
+        { UbxFrameCache::FrameCfgAnt, { ui->cbAntSupplyCtrl, ui->cbAntShortDetect, ui->cbAntOpenDetect,
+                                        ui->cbAntPowerDown, ui->cbAntAutoRecover, ui->sbAntSwitchPin,
+                                        ui->sbAntShortPin, ui->sbAntOpenPin, ui->cbAntReconfig } },
+        { UbxFrameCache::FrameNavStatus, { ui->sbFixTypeStatus, ui->sbTtff } },
+        { UbxFrameCache::FrameNavPvt, { ui->dsbLat, ui->dsbLon, ui->dsbHeight, ui->dsbSpeed, ui->dsbHeading,
+                                        ui->sbNumSats, ui->dsbVelN, ui->dsbVelE, ui->dsbVelU,
+                                        ui->dsbRmsPos, ui->dsbRmsVel, ui->dsbPdop } }
+    };
+
+    for (const auto &source : sources) {
+        for (QWidget *widget : source.second) {
+            const UbxFrameCache::FrameSlot slot = source.first;
+            connectEdited(widget, [this, slot]() { m_frameCache.invalidate(slot); });
+        }
     }
-    if (m_statusTimer && m_statusTimer->isActive()) {
-        m_statusTimer->stop();
+}
+
+// Periodic messages are generated from SimState, republished on every edit
+void GNSSWindow::setupSimStatePublishing()
+{
+    const QList<QWidget*> sources = {
+        ui->dsbLat, ui->dsbLon, ui->dsbHeight, ui->dsbSpeed, ui->dsbHeading, ui->sbNumSats,
+        ui->dsbVelN, ui->dsbVelE, ui->dsbVelU, ui->dsbRmsPos, ui->dsbRmsVel, ui->dsbPdop,
+        ui->sbFixTypeStatus, ui->sbTtff,
+        ui->sbSatVersion, ui->sbNumSatsSat, ui->cbQualityInd, ui->cbHealth, ui->cbSvUsed,
+        ui->cbDiffCorr, ui->cbSmoothed, ui->cbOrbitSource, ui->dsbPrResMin, ui->dsbPrResMax,
+        ui->sbTimeUtcTAcc, ui->sbTimeUtcNano, ui->cbTimeUtcValid, ui->cbTimeUtcStandard,
+        ui->sbHwNoise, ui->sbHwAgc, ui->cbHwAntStatus, ui->cbHwAntPower, ui->cbHwJamming,
+        ui->sbHwCwSuppression,
+        ui->sbRfVersion, ui->sbRfBlocks, ui->cbRfJamState, ui->cbRfAntStatus, ui->cbRfAntPower,
+        ui->dsbRfNoise, ui->dsbRfAgc, ui->sbRfCwSuppression,
+        ui->sbUniqidVersion, ui->leChipId
+    };
+
+    for (QWidget *widget : sources) {
+        connectEdited(widget, [this]() { publishSimState(); });
     }
+    publishSimState();
+}
 
-    QList<QTimer*> allTimers = findChildren<QTimer*>();
+void GNSSWindow::publishSimState()
+{
+    SimState state;
+    state.lat = ui->dsbLat->value();
+    state.lon = ui->dsbLon->value();
+    state.height = ui->dsbHeight->value();
+    state.speed = ui->dsbSpeed->value();
+    state.heading = ui->dsbHeading->value();
+    state.velN = ui->dsbVelN->value();
+    state.velE = ui->dsbVelE->value();
+    state.velU = ui->dsbVelU->value();
+    state.rmsPos = ui->dsbRmsPos->value();
+    state.rmsVel = ui->dsbRmsVel->value();
+    state.hAcc = state.rmsPos;
+    state.vAcc = state.rmsPos;
+    state.sAcc = state.rmsVel;
+    state.pdop = ui->dsbPdop->value();
+    state.numSats = ui->sbNumSats->value();
+
+    state.statusFixType = ui->sbFixTypeStatus->value();
+    state.ttff = ui->sbTtff->value();
+
+    state.satVersion = ui->sbSatVersion->value();
+    state.numSatsSat = ui->sbNumSatsSat->value();
+    state.qualityInd = ui->cbQualityInd->currentIndex();
+    state.health = ui->cbHealth->currentIndex();
+    state.svUsed = ui->cbSvUsed->isChecked();
+    state.diffCorr = ui->cbDiffCorr->isChecked();
+    state.smoothed = ui->cbSmoothed->isChecked();
+    state.orbitSource = ui->cbOrbitSource->currentIndex();
+    state.prResMin = ui->dsbPrResMin->value();
+    state.prResMax = ui->dsbPrResMax->value();
+
+    state.timeUtcTAcc = ui->sbTimeUtcTAcc->value();
+    state.timeUtcNano = ui->sbTimeUtcNano->value();
+    state.timeUtcValid = ui->cbTimeUtcValid->currentIndex();
+    state.timeUtcStandard = ui->cbTimeUtcStandard->currentIndex();
+
+    state.hwNoise = ui->sbHwNoise->value();
+    state.hwAgc = ui->sbHwAgc->value();
+    state.hwAntStatus = ui->cbHwAntStatus->currentIndex();
+    state.hwAntPower = ui->cbHwAntPower->currentIndex();
+    state.hwJamming = ui->cbHwJamming->currentIndex();
+    state.hwCwSuppression = ui->sbHwCwSuppression->value();
+
+    state.rfVersion = ui->sbRfVersion->value();
+    state.rfBlocks = ui->sbRfBlocks->value();
+    state.rfJamState = ui->cbRfJamState->currentIndex();
+    state.rfAntStatus = ui->cbRfAntStatus->currentIndex();
+    state.rfAntPower = ui->cbRfAntPower->currentIndex();
+    state.rfNoise = ui->dsbRfNoise->value();
+    state.rfAgc = ui->dsbRfAgc->value();
+    state.rfCwSuppression = ui->sbRfCwSuppression->value();
+
+    state.uniqidVersion = ui->sbUniqidVersion->value();
+    state.chipId = ui->leChipId->text().toULongLong(&state.chipIdValid, 16);
+
+    m_simState.publish(state);
+}
+
+void GNSSWindow::connectEdited(QWidget *widget, const std::function<void()> &handler)
+{
+    if (auto *spinBox = qobject_cast<QSpinBox*>(widget)) {
+        connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, handler);
+    } else if (auto *doubleSpinBox = qobject_cast<QDoubleSpinBox*>(widget)) {
+        connect(doubleSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, handler);
+    } else if (auto *comboBox = qobject_cast<QComboBox*>(widget)) {
+        connect(comboBox, &QComboBox::currentTextChanged, this, handler);
+    } else if (auto *checkBox = qobject_cast<QCheckBox*>(widget)) {
+        connect(checkBox, &QCheckBox::toggled, this, handler);
+    } else if (auto *lineEdit = qobject_cast<QLineEdit*>(widget)) {
+        connect(lineEdit, &QLineEdit::textChanged, this, handler);
+    } else if (auto *textEdit = qobject_cast<QTextEdit*>(widget)) {
+        connect(textEdit, &QTextEdit::textChanged, this, handler);
+    }
+}
+
+void GNSSWindow::stopAllAutoSendTimers()
+{
+    if (m_epochTimer && m_epochTimer->isActive()) {
+        m_epochTimer->stop();
+    }
+
+    // Auto-send timers are direct children; helpers own their own timers
+    QList<QTimer*> allTimers = findChildren<QTimer*>(QString(), Qt::FindDirectChildrenOnly);
     foreach (QTimer* timer, allTimers) {
-        if (timer->isActive() && timer != m_utcTimer) {
+        if (timer->isActive() && timer != m_utcTimer && timer != m_logDrainTimer) {
             timer->stop();
         }
     }
@@ -1391,13 +1565,7 @@ void GNSSWindow::onActionLoadSettingsTriggered()
 
         applySettings(doc.object());
 
-        if (ui->autoSendCheck->isChecked()) {
-            int rate = ui->rateSpin->value();
-            if (rate > 0) {
-                m_pvtTimer->start(1000 / rate);
-                m_statusTimer->start(1000 / rate);
-            }
-        }
+        updateEpochTimer();
 
         appendToLog(tr("Settings successfully loaded from %1").arg(fileName), "system");
         ui->statusbar->showMessage(tr("Settings loaded successfully"), 3000);
@@ -1409,18 +1577,12 @@ void GNSSWindow::onActionLoadSettingsTriggered()
         QMessageBox::warning(this, tr("Error"), tr(e.what()));
         appendToLog(tr("Failed to load settings: %1").arg(e.what()), "error");
 
-        if (ui->autoSendCheck->isChecked()) {
-            int rate = ui->rateSpin->value();
-            if (rate > 0) {
-                m_pvtTimer->start(1000 / rate);
-                m_statusTimer->start(1000 / rate);
-            }
-        }
+        updateEpochTimer();
     }
 }
 
 void GNSSWindow::sendInitialConfiguration() {
-    if (m_settingsLoaded || !m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (m_settingsLoaded || !m_transport || !m_transport->isOpen()) {
         return;
     }
 
@@ -1435,7 +1597,6 @@ void GNSSWindow::sendInitialConfiguration() {
     m_ackTimeoutTimer->start();
     m_initTimer->start(20000);
 
-    sendUbxCfgPrtResponse();
     sendUbxCfgMsg(UBX_CLASS_NAV, UBX_NAV_PVT, 1);
     sendUbxCfgMsg(UBX_CLASS_NAV, UBX_NAV_STATUS, 1);
     sendUbxCfgMsg(UBX_CLASS_MON, UBX_MON_RF, 1);
@@ -1517,14 +1678,62 @@ void GNSSWindow::onReadyRead() {
 */
 
 void GNSSWindow::registerHandlers() {
-    connect(&m_ubxParser, &UbxParser::navPvtReceived, this, &GNSSWindow::displayNavPvt);
-    connect(&m_ubxParser, &UbxParser::navStatusReceived, this, &GNSSWindow::displayNavStatus);
+    connect(&m_configDb, &UbxConfigDb::valueChanged, this, &GNSSWindow::applyConfigValue);
+
+    // Widgets follow the latest message at a capped rate, the log sees every one
+    m_presenter = new UiPresenter(this);
+    connect(m_presenter, &UiPresenter::navPvtChanged, this, &GNSSWindow::displayNavPvt);
+    connect(m_presenter, &UiPresenter::navStatusChanged, this, &GNSSWindow::displayNavStatus);
+    connect(m_presenter, &UiPresenter::monHwChanged, this, &GNSSWindow::processMonHw);
+    connect(m_presenter, &UiPresenter::monRfChanged, this, &GNSSWindow::displayMonRf);
+    connect(m_presenter, &UiPresenter::cfgPrtChanged, this, &GNSSWindow::displayCfgPrt);
+
+    connect(&m_ubxParser, &UbxParser::navPvtReceived, this, [this](const UbxParser::NavPvtHandle &pvt) {
+        m_presenter->post(pvt);
+        logEvent(UbxLog::Info, UbxLog::In, UbxLog::NavPvtReceived,
+                 { UbxLog::real(pvt->lat / 1e7, 7), UbxLog::real(pvt->lon / 1e7, 7),
+                   UbxLog::num(pvt->fixType), UbxLog::num(pvt->numSV) }, UBX_CLASS_NAV, UBX_NAV_PVT);
+    });
+    connect(&m_ubxParser, &UbxParser::navStatusReceived, this, [this](const UbxParser::NavStatusHandle &status) {
+        m_presenter->post(status);
+        logEvent(UbxLog::Info, UbxLog::In, UbxLog::NavStatusReceived,
+                 { UbxLog::num(status->fixType), UbxLog::num(status->ttff) }, UBX_CLASS_NAV, UBX_NAV_STATUS);
+    });
+    connect(&m_ubxParser, &UbxParser::navSatReceived, this, [this](const UbxParser::NavSatHandle &sat) {
+        logEvent(UbxLog::Info, UbxLog::In, UbxLog::NavSatReceived,
+                 { UbxLog::num(sat->version), UbxLog::num(sat->numSvs) }, UBX_CLASS_NAV, UBX_NAV_SAT);
+    });
 
-    connect(&m_ubxParser, &UbxParser::monVerReceived, this, &GNSSWindow::displayMonVer);
-    connect(&m_ubxParser, &UbxParser::monHwReceived, this, &GNSSWindow::processMonHw);
-    connect(&m_ubxParser, &UbxParser::monRfReceived, this, &GNSSWindow::displayMonRf);
+    connect(&m_ubxParser, &UbxParser::monVerReceived, this, [this](const UbxParser::MonVerHandle &ver) {
+        displayMonVer(*ver);
+        appendToLog(QString("MON-VER: SW=%1 HW=%2")
+                        .arg(ver->swVersion)
+                        .arg(ver->hwVersion), "in");
+    });
+    connect(&m_ubxParser, &UbxParser::monHwReceived, this, [this](const UbxParser::MonHwHandle &hw) {
+        m_presenter->post(hw);
+        logEvent(UbxLog::Info, UbxLog::In, UbxLog::MonHwReceived,
+                 { UbxLog::text(), UbxLog::num(hw->jamInd) }, UBX_CLASS_MON, UBX_MON_HW,
+                 hw->aPower ? QStringLiteral("ON") : QStringLiteral("OFF"));
+    });
+    connect(&m_ubxParser, &UbxParser::monRfReceived, this, [this](const UbxParser::MonRfHandle &rf) {
+        m_presenter->post(rf);
+        logEvent(UbxLog::Info, UbxLog::In, UbxLog::MonRfReceived,
+                 { UbxLog::num(rf->nBlocks) }, UBX_CLASS_MON, UBX_MON_RF);
+    });
 
-    connect(&m_ubxParser, &UbxParser::cfgPrtReceived, this, &GNSSWindow::displayCfgPrt);
+    connect(&m_ubxParser, &UbxParser::cfgPrtReceived, this, [this](const UbxParser::CfgPrtHandle &prt) {
+        // The port change itself cannot wait for the next UI refresh
+        applyCfgPrt(*prt);
+        if (prt->baudRate != 0) {
+            m_presenter->post(prt);
+        }
+    });
+
+    connect(&m_ubxParser, &UbxParser::secUniqidReceived, this, [this](const UbxParser::SecUniqidHandle &uniqid) {
+        emit secUniqidReceived(*uniqid);
+        appendToLog(QString("SEC-UNIQID: 0x%1").arg(uniqid->uniqueId, 10, 16, QLatin1Char('0')), "in");
+    });
 
     connect(&m_ubxParser, &UbxParser::infErrorReceived, this, [this](const QString& msg) {
         appendToLog(tr("INF-ERROR: %1").arg(msg), "error");
@@ -1538,39 +1747,43 @@ void GNSSWindow::sendUbxSecUniqidReq() {
 }
 
 void GNSSWindow::sendUbxCfgItfm() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-ITFM"), "error");
         return;
     }
 
-    QByteArray payload(8, 0x00);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgItfm)) {
+        QByteArray payload(8, 0x00);
 
-    quint32 config = 0;
-    config |= (ui->sbBbThreshold->value() & 0x0F);
-    config |= (ui->sbCwThreshold->value() & 0x1F) << 4;
-    config |= 0x16B156 << 9;
-    if (ui->cbEnable->isChecked()) {
-        config |= 0x80000000;
-    }
-    qToLittleEndian<quint32>(config, payload.data());
+        quint32 config = 0;
+        config |= (ui->sbBbThreshold->value() & 0x0F);
+        config |= (ui->sbCwThreshold->value() & 0x1F) << 4;
+        config |= 0x16B156 << 9;
+        if (ui->cbEnable->isChecked()) {
+            config |= 0x80000000;
+        }
+        qToLittleEndian<quint32>(config, payload.data());
 
-    quint32 config2 = 0;
-    config2 |= 0x31E;
-    config2 |= (ui->cbAntSetting->currentIndex() & 0x03) << 12;
-    if (ui->cbEnable2->isChecked()) {
-        config2 |= 0x00004000;
+        quint32 config2 = 0;
+        config2 |= 0x31E;
+        config2 |= (ui->cbAntSetting->currentIndex() & 0x03) << 12;
+        if (ui->cbEnable2->isChecked()) {
+            config2 |= 0x00004000;
+        }
+        qToLittleEndian<quint32>(config2, payload.data() + 4);
+
+        m_frameCache.store(UbxFrameCache::FrameCfgItfm, UBX_CLASS_CFG, UBX_CFG_ITFM, payload);
     }
-    qToLittleEndian<quint32>(config2, payload.data() + 4);
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_ITFM, payload);
-    appendToLog(tr("CFG-ITFM sent: BB=%1, CW=%2, Enable=%3")
-                    .arg(ui->sbBbThreshold->value())
-                    .arg(ui->sbCwThreshold->value())
-                    .arg(ui->cbEnable->isChecked() ? "ON" : "OFF"), "out");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgItfm));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgItfmSent,
+             { UbxLog::num(ui->sbBbThreshold->value()), UbxLog::num(ui->sbCwThreshold->value()),
+               UbxLog::tag(ui->cbEnable->isChecked() ? "ON" : "OFF") },
+             UBX_CLASS_CFG, UBX_CFG_ITFM);
 }
 
 void GNSSWindow::sendUbxCfgValset() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-VALSET"), "error");
         return;
     }
@@ -1583,15 +1796,16 @@ void GNSSWindow::sendUbxCfgValset() {
 
     QString kvPairsStr = ui->leValsetKeysValues->text();
 
-    QList<QPair<quint32, quint32>> kvPairs;
+    QList<QPair<quint32, quint64>> kvPairs;
     QStringList pairs = kvPairsStr.split(',', Qt::SkipEmptyParts);
     for (const QString &pair : pairs) {
         QStringList kv = pair.split('=', Qt::SkipEmptyParts);
         if (kv.size() == 2) {
             bool keyOk, valueOk;
             quint32 key = kv[0].trimmed().toUInt(&keyOk, 16);
-            quint32 value = kv[1].trimmed().toUInt(&valueOk, 16);
-            if (keyOk && valueOk) {
+            quint64 value = kv[1].trimmed().toULongLong(&valueOk, 16);
+            // The value width comes from the key ID
+            if (keyOk && valueOk && UbxConfigKeys::valueBytes(key) > 0) {
                 kvPairs.append(qMakePair(key, value));
             }
         }
@@ -1609,35 +1823,25 @@ void GNSSWindow::sendUbxCfgValset() {
     payload.append('\0');
 
     for (const auto &kv : kvPairs) {
-        quint32 key = kv.first;
-        quint32 value = kv.second;
-
-        payload.append(static_cast<char>(key & 0xFF));
-        payload.append(static_cast<char>((key >> 8) & 0xFF));
-        payload.append(static_cast<char>((key >> 16) & 0xFF));
-        payload.append(static_cast<char>((key >> 24) & 0xFF));
-
-        payload.append(static_cast<char>(value & 0xFF));
-        payload.append(static_cast<char>((value >> 8) & 0xFF));
-        payload.append(static_cast<char>((value >> 16) & 0xFF));
-        payload.append(static_cast<char>((value >> 24) & 0xFF));
+        UbxConfigDb::appendValue(payload, kv.first, kv.second);
     }
 
     createUbxPacket(UBX_CLASS_CFG, UBX_CFG_VALSET, payload);
-    appendToLog(tr("CFG-VALSET sent: Version=%1, Layers=0x%2, %n key-value pair(s)", "", kvPairs.size())
-                    .arg(version)
-                    .arg(layers, 2, 16, QLatin1Char('0')),
-                "config");
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgValsetSent,
+             { UbxLog::num(version), UbxLog::hex(layers), UbxLog::num(kvPairs.size()) },
+             UBX_CLASS_CFG, UBX_CFG_VALSET);
 }
 
 void GNSSWindow::sendUbxCfgValGet() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-VALGET"), "error");
         return;
     }
 
     quint8 version = static_cast<quint8>(ui->sbValgetVersion->value());
-    quint8 layer = static_cast<quint8>(ui->cbValgetLayer->currentIndex());
+    // Combo entries are RAM, BBR, Flash and Default (layer 7)
+    const int layerIndex = ui->cbValgetLayer->currentIndex();
+    quint8 layer = static_cast<quint8>(layerIndex == 3 ? UbxConfigDb::Default : layerIndex);
     quint16 position = static_cast<quint16>(ui->sbValgetPosition->value());
     QString keysStr = ui->leValgetKeys->text();
 
@@ -1670,161 +1874,467 @@ void GNSSWindow::sendUbxCfgValGet() {
     }
 
     createUbxPacket(UBX_CLASS_CFG, UBX_CFG_VALGET, payload);
-    appendToLog(tr("CFG-VALGET sent: Version=%1, Layer=%2, Position=%3, Keys=%4")
-                    .arg(version)
-                    .arg(layer)
-                    .arg(position)
-                    .arg(keysStr),
-                    "config");
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgValgetSent,
+             { UbxLog::num(version), UbxLog::num(layer), UbxLog::num(position), UbxLog::text() },
+             UBX_CLASS_CFG, UBX_CFG_VALGET, keysStr);
 }
 
 void GNSSWindow::sendUbxNavTimeUtc() {
-    QByteArray payload(20, 0x00);
-    QDateTime currentTime = QDateTime::currentDateTimeUtc();
+    sendUbxFrame(m_epochBuilder.buildNavTimeUtc(m_simState.read(), UbxTime::now()));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::NavTimeUtcSent, {}, UBX_CLASS_NAV, UBX_NAV_TIMEUTC);
+}
 
-    quint32 iTOW = static_cast<quint32>(currentTime.toMSecsSinceEpoch() % (7 * 24 * 60 * 60 * 1000));
-    qToLittleEndian<quint32>(iTOW, payload.data());
+void GNSSWindow::processCfgValGet(const QByteArray& payload) {
+    QByteArray response;
+    if (!m_configDb.handleValGet(payload, response)) {
+        sendUbxNack(UBX_CLASS_CFG, UBX_CFG_VALGET);
+        appendToLog(tr("CFG-VALGET rejected: %1").arg(m_configDb.lastError()), "warning");
+        return;
+    }
 
-    quint32 tAcc = static_cast<quint32>(ui->sbTimeUtcTAcc->value());
-    qToLittleEndian<quint32>(tAcc, payload.data() + 4);
+    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_VALGET, response);
+    sendUbxAck(UBX_CLASS_CFG, UBX_CFG_VALGET);
+    appendToLog(tr("CFG-VALGET answered: Layer=%1, %2 bytes of key/value data")
+                    .arg(quint8(payload[1]))
+                    .arg(response.size() - 4),
+                "config");
+}
 
-    qint32 nano = static_cast<qint32>(ui->sbTimeUtcNano->value());
-    qToLittleEndian<qint32>(nano, payload.data() + 8);
+void GNSSWindow::processCfgValSet(const QByteArray &payload) {
+    if (!m_configDb.handleValSet(payload)) {
+        sendUbxNack(UBX_CLASS_CFG, UBX_CFG_VALSET);
+        appendToLog(tr("CFG-VALSET rejected: %1").arg(m_configDb.lastError()), "warning");
+        return;
+    }
 
-    qToLittleEndian<quint16>(currentTime.date().year(), payload.data() + 12);
-    payload[14] = static_cast<quint8>(currentTime.date().month());
-    payload[15] = static_cast<quint8>(currentTime.date().day());
-    payload[16] = static_cast<quint8>(currentTime.time().hour());
-    payload[17] = static_cast<quint8>(currentTime.time().minute());
-    payload[18] = static_cast<quint8>(currentTime.time().second());
+    sendUbxAck(UBX_CLASS_CFG, UBX_CFG_VALSET);
+    appendToLog(tr("CFG-VALSET applied: Layers=0x%1, %2 bytes of key/value data")
+                    .arg(quint8(payload[1]), 2, 16, QLatin1Char('0'))
+                    .arg(payload.size() - 4),
+                "config");
+}
 
-    quint8 validFlags = 0;
-    switch(ui->cbTimeUtcValid->currentIndex()) {
-    case 0: validFlags |= 0x01; break; // Valid TOW
-    case 1: validFlags |= 0x02; break; // Valid WKN
-    case 2: validFlags |= 0x04; break; // Valid UTC
-    case 3: validFlags |= 0x08; break; // Authenticated
+void GNSSWindow::processCfgValDel(const QByteArray &payload) {
+    if (!m_configDb.handleValDel(payload)) {
+        sendUbxNack(UBX_CLASS_CFG, UBX_CFG_VALDEL);
+        appendToLog(tr("CFG-VALDEL rejected: %1").arg(m_configDb.lastError()), "warning");
+        return;
     }
 
-    quint8 utcStandard = static_cast<quint8>(ui->cbTimeUtcStandard->currentIndex());
-    validFlags |= (utcStandard << 4);
+    sendUbxAck(UBX_CLASS_CFG, UBX_CFG_VALDEL);
+    appendToLog(tr("CFG-VALDEL applied: Layers=0x%1").arg(quint8(payload[1]), 2, 16, QLatin1Char('0')), "config");
+}
 
-    payload[19] = validFlags;
+void GNSSWindow::loadRfScenario() {
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Load RF Scenario"), "",
+                                                          tr("JSON Files (*.json);;All Files (*)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
 
-    createUbxPacket(UBX_CLASS_NAV, UBX_NAV_TIMEUTC, payload);
-    appendToLog(tr("Sent NAV-TIMEUTC"), "out");
+    if (!m_rfScenario.load(fileName)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not load RF scenario: %1").arg(m_rfScenario.errorString()));
+        m_stopRfScenarioAction->setEnabled(false);
+        return;
+    }
+
+    m_rfScenarioClock.start();
+    m_stopRfScenarioAction->setEnabled(true);
+    appendToLog(tr("RF scenario started: %1 segments over %2 s")
+                    .arg(m_rfScenario.segmentCount())
+                    .arg(m_rfScenario.durationMs() / 1000.0, 0, 'f', 1), "system");
 }
 
-void GNSSWindow::processCfgValGet(const QByteArray& payload) {
-    if (payload.size() < 4) {
-        appendToLog(tr("CFG-VALGET response too short"), "error");
+void GNSSWindow::loadFaultConfig() {
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Load Fault Configuration"), "",
+                                                          tr("JSON Files (*.json);;All Files (*)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    UbxFaultInjector::Config config;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+    } else {
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (!doc.isObject()) {
+            error = tr("Invalid fault configuration format");
+        } else {
+            UbxFaultInjector::Config::fromJson(doc.object(), config, error);
+        }
+    }
+
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not load fault configuration: %1").arg(error));
         return;
     }
 
-    quint8 version = static_cast<quint8>(payload[0]);
-    quint8 layer = static_cast<quint8>(payload[1]);
+    m_faults->setConfig(config);
+    m_stopFaultsAction->setEnabled(config.enabled);
+    appendToLog(tr("Fault injection %1 (seed %2, %3 windows)")
+                    .arg(config.enabled ? tr("enabled") : tr("disabled"))
+                    .arg(config.seed)
+                    .arg(config.windows.size()), "system");
+}
 
-    QString message = tr("CFG-VALGET response: Version=%1, Layer=%2").arg(version).arg(layer);
+void GNSSWindow::stopFaults() {
+    const QString summary = m_faults->summary();
+    m_faults->setConfig(UbxFaultInjector::Config());
+    m_stopFaultsAction->setEnabled(false);
+    appendToLog(tr("Fault injection stopped: %1").arg(summary), "system");
+}
 
-    for (int i = 4; i + 7 < payload.size(); i += 8) {
-        quint32 key = qFromLittleEndian<quint32>(payload.mid(i, 4).constData());
-        quint32 value = qFromLittleEndian<quint32>(payload.mid(i + 4, 4).constData());
+void GNSSWindow::stopRfScenario() {
+    m_rfScenario.clear();
+    m_stopRfScenarioAction->setEnabled(false);
+    appendToLog(tr("RF scenario stopped, configured RF levels apply"), "system");
+}
 
-        message += QString("\nKey: 0x%1, Value: 0x%2").arg(key, 8, 16, QLatin1Char('0'))
-                       .arg(value, 8, 16, QLatin1Char('0'));
+// { "port": 14560, "latencyMs": 50 }
+void GNSSWindow::loadVehicleInput() {
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Load Vehicle Input Configuration"), "",
+                                                          tr("JSON Files (*.json);;All Files (*)"));
+    if (fileName.isEmpty()) {
+        return;
     }
 
-    appendToLog(message, "in");
+    QString error;
+    QJsonObject config;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+    } else {
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        config = doc.object();
+        const int port = config["port"].toInt(0);
+        if (!doc.isObject() || port <= 0 || port > 65535 || config["latencyMs"].toInt(0) < 0) {
+            error = tr("Need a UDP port and a non-negative latencyMs");
+        } else if (!m_vehicleInput->open(static_cast<quint16>(port))) {
+            error = m_vehicleInput->errorString();
+        }
+    }
+
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not start vehicle input: %1").arg(error));
+        return;
+    }
+
+    m_vehicleLatencyMs = config["latencyMs"].toInt(0);
+    m_vehicleReportTicks = 0;
+    m_stopVehicleInputAction->setEnabled(true);
+    appendToLog(tr("Vehicle input listening on UDP port %1, latency %2 ms")
+                    .arg(config["port"].toInt())
+                    .arg(m_vehicleLatencyMs), "system");
 }
 
-void GNSSWindow::processCfgValSet(const QByteArray &payload) {
-    sendUbxAck(UBX_CLASS_CFG, UBX_CFG_VALSET);
-    appendToLog(tr("CFG-VALSET processed"), "config");
+void GNSSWindow::stopVehicleInput() {
+    m_vehicleInput->close();
+    m_stopVehicleInputAction->setEnabled(false);
+    m_frameCache.invalidate(UbxFrameCache::FrameNavPvt);
+    appendToLog(tr("Vehicle input stopped, configured position applies"), "system");
 }
 
-void GNSSWindow::sendUbxMonRf() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
-        appendToLog(tr("Error: No active connection to send MON-RF"), "error");
+// Every 10 s while the input is open
+void GNSSWindow::reportVehicleInput() {
+    if (!m_vehicleInput->isOpen() || ++m_vehicleReportTicks < 10) {
+        return;
+    }
+    m_vehicleReportTicks = 0;
+
+    const VehicleInput::Stats stats = m_vehicleInput->takeStats();
+    appendToLog(tr("Vehicle input: %1 Hz, %2 rejected; truth to NAV-PVT delay "
+                   "last %3 ms, mean %4 ms, max %5 ms (+%6 ms configured)")
+                    .arg(stats.rateHz, 0, 'f', 1)
+                    .arg(stats.rejected)
+                    .arg(stats.lastDelayMs, 0, 'f', 3)
+                    .arg(stats.meanDelayMs, 0, 'f', 3)
+                    .arg(stats.maxDelayMs, 0, 'f', 3)
+                    .arg(m_vehicleLatencyMs), "system");
+}
+
+// Truth from the simulator replaces the configured position and velocity
+void GNSSWindow::applyVehicleTruth(const VehicleInput::Sample &truth, SimState &state) {
+    state.lat = truth.lat;
+    state.lon = truth.lon;
+    state.height = truth.alt;
+    state.velN = truth.velN;
+    state.velE = truth.velE;
+    state.velU = -truth.velD;
+
+    state.speed = std::hypot(state.velN, state.velE);
+    state.heading = std::fmod(qRadiansToDegrees(std::atan2(state.velE, state.velN)) + 360.0, 360.0);
+    state.headVehValid = truth.attitudeValid;
+    state.headVeh = std::fmod(qRadiansToDegrees(truth.yaw) + 360.0, 360.0);
+}
+
+void GNSSWindow::loadErrorModel() {
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Load Error Model"), "",
+                                                          tr("JSON Files (*.json);;All Files (*)"));
+    if (fileName.isEmpty()) {
         return;
     }
 
-    const int numBlocks = ui->sbRfBlocks->value();
-    const int payloadSize = 4 + 24 * numBlocks;
-    QByteArray payload(payloadSize, 0x00);
+    QString error;
+    GnssErrorModel::Config config;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+    } else {
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (!doc.isObject()) {
+            error = tr("Invalid error model format");
+        } else {
+            GnssErrorModel::Config::fromJson(doc.object(), config, error);
+        }
+    }
 
-    appendToLog(tr("Preparing MON-RF message with %1 blocks (%2 bytes total)")
-                    .arg(numBlocks).arg(payloadSize), "debug");
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not load error model: %1").arg(error));
+        return;
+    }
 
-    payload[0] = static_cast<quint8>(ui->sbRfVersion->value());
-    payload[1] = static_cast<quint8>(numBlocks);
+    m_errorModel.setConfig(config);
+    m_errorModelClock.start();
+    m_stopErrorModelAction->setEnabled(config.enabled);
+    m_frameCache.invalidate(UbxFrameCache::FrameNavPvt);
+    appendToLog(tr("Error model %1 (seed %2, position tau %3 s, bias limit %4 m, %5 bursts/min)")
+                    .arg(config.enabled ? tr("enabled") : tr("disabled"))
+                    .arg(config.seed)
+                    .arg(config.positionTau)
+                    .arg(config.biasLimit)
+                    .arg(config.burstRate), "system");
+}
+
+void GNSSWindow::stopErrorModel() {
+    m_errorModel.setConfig(GnssErrorModel::Config());
+    m_stopErrorModelAction->setEnabled(false);
+    m_frameCache.invalidate(UbxFrameCache::FrameNavPvt);
+    appendToLog(tr("Error model stopped, NAV-PVT reports the configured position"), "system");
+}
+
+// Moves the solution off the truth and reports the accuracy that goes with it
+void GNSSWindow::applyErrorModel(SimState &state) {
+    const double metersPerDegree = 111320.0;
+    const double dt = m_errorModelClock.nsecsElapsed() * 1e-9;
+    m_errorModelClock.restart();
+
+    const GnssErrorModel::Output error = m_errorModel.step(dt, state.rmsPos, state.rmsVel);
+    state.lat += error.position[GnssErrorModel::North] / metersPerDegree;
+    state.lon += error.position[GnssErrorModel::East] /
+                 (metersPerDegree * qMax(1e-6, qCos(qDegreesToRadians(state.lat))));
+    state.height += error.position[GnssErrorModel::Up];
+    state.velN += error.velocity[GnssErrorModel::North];
+    state.velE += error.velocity[GnssErrorModel::East];
+    state.velU += error.velocity[GnssErrorModel::Up];
+    state.speed = std::hypot(state.velN, state.velE);
+    state.hAcc = error.hAcc;
+    state.vAcc = error.vAcc;
+    state.sAcc = error.sAcc;
+}
+
+// BBR and Flash belong to the receiver identified by SEC-UNIQID
+void GNSSWindow::openConfigStore() {
+    bool ok = false;
+    const quint64 uniqueId = ui->leChipId->text().toULongLong(&ok, 16);
+    if (!ok || (m_configStoreOpen && uniqueId == m_configStoreId)) {
+        return;
+    }
 
-    appendToLog(tr("Header: version=%1, nBlocks=%2")
-                    .arg(payload[0]).arg(payload[1]), "debug");
+    m_configStoreId = uniqueId;
+    m_configStoreOpen = true;
+    if (m_configDb.openStore(uniqueId)) {
+        appendToLog(tr("Receiver configuration: %1").arg(m_configDb.storeFileName()), "system");
+    } else {
+        appendToLog(tr("Receiver configuration store unavailable (%1), BBR/Flash will not persist")
+                        .arg(m_configDb.storeError()), "warning");
+    }
+}
 
-    for (int i = 0; i < numBlocks; i++) {
-        int offset = 4 + i * 24;
+// Running-configuration keys that change how the imitator behaves
+void GNSSWindow::applyConfigValue(quint32 id, quint64 value) {
+    switch (id) {
+    case UbxConfigKeys::CFG_UART1_BAUDRATE:
+        if (m_transport && value > 0) {
+            m_transport->setBaudRate(static_cast<quint32>(value));
+        }
+        break;
+    case UbxConfigKeys::CFG_RATE_MEAS:
+        if (value > 0) {
+            ui->rateSpin->setValue(qBound(1, static_cast<int>(1000 / value), ui->rateSpin->maximum()));
+        }
+        break;
+    case UbxConfigKeys::CFG_RATE_NAV:
+        updateEpochTimer();
+        break;
+    default: {
+        int output;
+        int port;
+        if (UbxRateTable::fromKey(id, output, port)) {
+            m_rateTable.setRate(output, port, static_cast<quint8>(value));
+            if (port == m_outputPort) {
+                QCheckBox *check = autoSendCheckFor(output);
+                const QSignalBlocker blocker(check);
+                check->setChecked(value != 0);
+                updateEpochTimer();
+                updateBandwidthBudget();
+            }
+        }
+        break;
+    }
+    }
+}
 
-        payload[offset] = static_cast<quint8>(i); // blockId
-        payload[offset+1] = static_cast<quint8>(ui->cbRfJamState->currentIndex()); // flags
-        payload[offset+2] = static_cast<quint8>(ui->cbRfAntStatus->currentIndex()); // antStatus
-        payload[offset+3] = static_cast<quint8>(ui->cbRfAntPower->currentIndex()); // antPower
+// Periodic messages due this navigation epoch on the output port
+void GNSSWindow::onNavigationEpoch() {
+    static void (GNSSWindow::*const senders[UbxRateTable::OutputCount])() = {
+        &GNSSWindow::sendUbxNavPvt,
+        &GNSSWindow::sendUbxNavStatus,
+        &GNSSWindow::sendUbxNavSat,
+        &GNSSWindow::sendUbxNavTimeUtc,
+        &GNSSWindow::sendUbxMonHw,
+        &GNSSWindow::sendUbxMonRf
+    };
 
-        qToLittleEndian<quint32>(0x00000000, payload.data() + offset + 4);
+    if (!m_transport || !m_transport->isOpen()) {
+        return;
+    }
 
-        quint16 noisePerMS = static_cast<quint16>(ui->dsbRfNoise->value() * 100);
-        quint16 agcCnt = static_cast<quint16>(ui->dsbRfAgc->value() * 100);
-        qToLittleEndian<quint16>(noisePerMS, payload.data() + offset + 12);
-        qToLittleEndian<quint16>(agcCnt, payload.data() + offset + 14);
+    const quint32 epoch = m_epoch++;
+    m_transport->beginEpoch(epoch);
+    for (int output = 0; output < UbxRateTable::OutputCount; output++) {
+        if (m_rateTable.due(output, m_outputPort, epoch)) {
+            (this->*senders[output])();
+        }
+    }
+    m_transport->endEpoch();
+}
 
-        payload[offset+16] = static_cast<quint8>(ui->sbRfCwSuppression->value());
+// Epoch period is CFG-RATE-MEAS times CFG-RATE-NAV; idle with no output enabled
+void GNSSWindow::updateEpochTimer() {
+    const quint64 navRate = qMax<quint64>(1, m_configDb.value(UbxConfigKeys::CFG_RATE_NAV));
+    m_epochTimer->setInterval(static_cast<int>(1000 / ui->rateSpin->value() * navRate));
 
-        payload[offset+17] = static_cast<qint8>(0);    // ofsI
-        payload[offset+18] = static_cast<quint8>(128); // magI
-        payload[offset+19] = static_cast<qint8>(0);    // ofsQ
-        payload[offset+20] = static_cast<quint8>(128); // magQ
+    if (!m_rateTable.anyEnabled(m_outputPort)) {
+        m_epochTimer->stop();
+    } else if (!m_epochTimer->isActive()) {
+        m_epoch = 0;
+        m_epochTimer->start();
+    }
+}
 
-        appendToLog(tr("Block %1: antId=%2, jamState=%3, antStatus=%4, antPower=%5, noise=%6, agc=%7")
-                        .arg(i)
-                        .arg(payload[offset])
-                        .arg(payload[offset+1])
-                        .arg(payload[offset+2])
-                        .arg(payload[offset+3])
-                        .arg(noisePerMS)
-                        .arg(agcCnt), "debug");
+// UI changes go through the database like CFG-MSG and CFG-VALSET do
+void GNSSWindow::setOutputRate(int output, quint8 rate) {
+    m_configDb.set(UbxConfigDb::RamMask, UbxRateTable::keyFor(output, m_outputPort), rate);
+}
+
+// Rate set by the auto-send checkboxes; MON-HW keeps its 5 s period
+quint8 GNSSWindow::autoSendRate(int output) const {
+    if (output == UbxRateTable::MonHw) {
+        return static_cast<quint8>(qMin(255, 5 * ui->rateSpin->value()));
     }
+    return 1;
+}
 
-    appendToLog(tr("MON-RF payload (hex): %1").arg(QString(payload.toHex(' '))), "debug");
+QCheckBox *GNSSWindow::autoSendCheckFor(int output) const {
+    switch (output) {
+    case UbxRateTable::NavPvt: return ui->cbAutoSendNavPvt;
+    case UbxRateTable::NavStatus: return ui->cbAutoSendNavStatus;
+    case UbxRateTable::NavSat: return ui->cbAutoSendNavSat;
+    case UbxRateTable::NavTimeUtc: return ui->cbAutoSendNavTimeUTC;
+    case UbxRateTable::MonHw: return ui->cbAutoSendMonHw;
+    default: return ui->cbAutoSendMonRf;
+    }
+}
+
+// CFG-MSG: 2 bytes poll, 3 bytes set the current port, 8 bytes set all ports
+void GNSSWindow::processCfgMsg(const QByteArray &payload) {
+    const int output = payload.size() >= 2
+                           ? UbxRateTable::outputOf(quint8(payload[0]), quint8(payload[1]))
+                           : -1;
+    if (output < 0 || (payload.size() != 2 && payload.size() != 3 && payload.size() != 8)) {
+        sendUbxNack(UBX_CLASS_CFG, UBX_CFG_MSG);
+        appendToLog(tr("CFG-MSG rejected: %1 bytes for Class=0x%2 ID=0x%3")
+                        .arg(payload.size())
+                        .arg(payload.size() > 0 ? quint8(payload[0]) : 0, 2, 16, QLatin1Char('0'))
+                        .arg(payload.size() > 1 ? quint8(payload[1]) : 0, 2, 16, QLatin1Char('0')),
+                    "warning");
+        return;
+    }
 
-    createUbxPacket(UBX_CLASS_MON, UBX_MON_RF, payload);
-    appendToLog(tr("MON-RF message sent (%1 bytes total)").arg(payloadSize + 8), "out");
+    if (payload.size() == 2) {
+        QByteArray response = payload;
+        for (int port = 0; port < UbxRateTable::PortCount; port++) {
+            response.append(static_cast<char>(m_rateTable.rate(output, port)));
+        }
+        response.append('\0'); // Reserved port
+        createUbxPacket(UBX_CLASS_CFG, UBX_CFG_MSG, response);
+        sendUbxAck(UBX_CLASS_CFG, UBX_CFG_MSG);
+        return;
+    }
+
+    if (payload.size() == 3) {
+        setOutputRate(output, quint8(payload[2]));
+    } else {
+        for (int port = 0; port < UbxRateTable::PortCount; port++) {
+            m_configDb.set(UbxConfigDb::RamMask, UbxRateTable::keyFor(output, port), quint8(payload[2 + port]));
+        }
+    }
+
+    sendUbxAck(UBX_CLASS_CFG, UBX_CFG_MSG);
+    appendToLog(tr("CFG-MSG applied: %1 every %2 epoch(s) on the output port")
+                    .arg(UbxRateTable::name(output))
+                    .arg(m_rateTable.rate(output, m_outputPort)),
+                "config");
 }
 
-void GNSSWindow::sendUbxSecUniqid() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
-        appendToLog(tr("Error: No active connection to send SEC-UNIQID"), "error");
+void GNSSWindow::sendUbxMonRf() {
+    if (!m_transport || !m_transport->isOpen()) {
+        appendToLog(tr("Error: No active connection to send MON-RF"), "error");
         return;
     }
 
-    QByteArray payload(9, 0x00);
+    const SimState state = m_simState.read();
+    const RfScenario::Sample rf = m_rfScenario.evaluate(m_rfScenarioClock.elapsed());
+    UbxEpochBuilder::MonRfInfo info;
+    const UbxPacketArena::Frame frame = m_epochBuilder.buildMonRf(state, rf, info);
 
-    payload[0] = static_cast<quint8>(ui->sbUniqidVersion->value());
+    sendUbxFrame(frame);
+    m_telemetry->addInterference(TelemetryDock::MonRf, info.agcPercent, info.cwSuppression);
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::MonRfSent, { UbxLog::num(frame.size) }, UBX_CLASS_MON, UBX_MON_RF);
+}
 
-    QString chipIdStr = ui->leChipId->text();
-    bool ok;
-    quint32 chipId = chipIdStr.toUInt(&ok, 16);
-    if (!ok) {
-        appendToLog(tr("Invalid Chip ID format (must be hex)"), "error");
+void GNSSWindow::sendUbxSecUniqid() {
+    if (!m_transport || !m_transport->isOpen()) {
+        appendToLog(tr("Error: No active connection to send SEC-UNIQID"), "error");
         return;
     }
 
-    for (int i = 0; i < 5; i++) {
-        payload[4 + i] = static_cast<quint8>((chipId >> (8 * (4 - i))) & 0xFF);
+    const SimState state = m_simState.read();
+
+    if (m_frameCache.isDirty(UbxFrameCache::FrameSecUniqid)) {
+        QByteArray payload(9, 0x00);
+
+        payload[0] = static_cast<quint8>(state.uniqidVersion);
+
+        if (!state.chipIdValid) {
+            appendToLog(tr("Invalid Chip ID format (must be hex)"), "error");
+            return;
+        }
+        const quint64 chipId = state.chipId;
+
+        for (int i = 0; i < 5; i++) {
+            payload[4 + i] = static_cast<quint8>((chipId >> (8 * (4 - i))) & 0xFF);
+        }
+
+        m_frameCache.store(UbxFrameCache::FrameSecUniqid, UBX_CLASS_SEC, UBX_SEC_UNIQID, payload);
     }
 
-    createUbxPacket(UBX_CLASS_SEC, UBX_SEC_UNIQID, payload);
-    appendToLog(tr("SEC-UNIQID sent: Version=%1, ChipID=0x%2")
-                    .arg(ui->sbUniqidVersion->value())
-                    .arg(chipIdStr), "out");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameSecUniqid));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::SecUniqidSent,
+             { UbxLog::num(state.uniqidVersion), UbxLog::hex(state.chipId, 10) },
+             UBX_CLASS_SEC, UBX_SEC_UNIQID);
 }
 
 void GNSSWindow::sendUbxCfgMsg(quint8 msgClass, quint8 msgId, quint8 rate) {
@@ -1841,16 +2351,11 @@ void GNSSWindow::sendUbxCfgMsg(quint8 msgClass, quint8 msgId, quint8 rate) {
         payload.append('\0'); // Reserved
         payload.append('\0'); // Reserved
 
-        quint32 key = 0x20910000 | (msgClass << 8) | msgId;
-        payload.append(static_cast<char>(key & 0xFF));
-        payload.append(static_cast<char>((key >> 8) & 0xFF));
-        payload.append(static_cast<char>((key >> 16) & 0xFF));
-        payload.append(static_cast<char>((key >> 24) & 0xFF));
-
-        payload.append(static_cast<char>(rate));
-        payload.append('\0'); // Padding
-        payload.append('\0'); // Padding
-        payload.append('\0'); // Padding
+        // MSGOUT keys are not derived from class/ID; known outputs use their UART1 key
+        const int output = UbxRateTable::outputOf(msgClass, msgId);
+        const quint32 key = output >= 0 ? UbxRateTable::keyFor(output, UbxRateTable::Uart1)
+                                        : 0x20910000 | (msgClass << 8) | msgId;
+        UbxConfigDb::appendValue(payload, key, rate);
 
         createUbxPacket(UBX_CLASS_CFG, UBX_CFG_VALSET, payload); // UBX-CFG-VALSET
         appendToLog(tr("CFG-VALSET for MSG: Class=0x%1 ID=0x%2 Rate=%3")
@@ -1872,14 +2377,10 @@ void GNSSWindow::sendUbxCfgMsg(quint8 msgClass, quint8 msgId, quint8 rate) {
 }
 
 void GNSSWindow::processUbxMessage(quint8 msgClass, quint8 msgId, const QByteArray& payload) {
-    QString messageInfo;
-    QString timestamp = QDateTime::currentDateTime().toString("[hh:mm:ss.zzz]");
+    logEvent(UbxLog::Debug, UbxLog::In, UbxLog::FrameReceived,
+             { UbxLog::hex(msgClass), UbxLog::hex(msgId), UbxLog::num(payload.size()) }, msgClass, msgId);
 
-    qDebug().nospace() << timestamp << " "
-                       << tr("Processing UBX message:") << " "
-                       << tr("Class=0x%1").arg(QString("%1").arg(msgClass, 2, 16, QLatin1Char('0')).toUpper()) << " "
-                       << tr("ID=0x%1").arg(QString("%1").arg(msgId, 2, 16, QLatin1Char('0')).toUpper()) << " "
-                       << tr("Size=%1 bytes").arg(payload.size());
+    QString messageInfo;
 
     if (msgClass == UBX_CLASS_ACK) {
         if (payload.size() >= 2) {
@@ -1887,19 +2388,15 @@ void GNSSWindow::processUbxMessage(quint8 msgClass, quint8 msgId, const QByteArr
             quint8 ackedId = static_cast<quint8>(payload[1]);
 
             if (msgId == UBX_ACK_ACK) {
-                appendToLog(tr("ACK received for Class=0x%1 ID=0x%2")
-                                .arg(ackedClass, 2, 16, QLatin1Char('0'))
-                                .arg(ackedId, 2, 16, QLatin1Char('0')),
-                            "in");
+                logEvent(UbxLog::Info, UbxLog::In, UbxLog::AckReceived,
+                         { UbxLog::hex(ackedClass), UbxLog::hex(ackedId) }, msgClass, msgId);
                 if (ackedClass == UBX_CLASS_CFG) {
                     completeInitialization();
                 }
             }
             else if (msgId == UBX_ACK_NAK) {
-                appendToLog(tr("NACK received for Class=0x%1 ID=0x%2")
-                                .arg(ackedClass, 2, 16, QLatin1Char('0'))
-                                .arg(ackedId, 2, 16, QLatin1Char('0')),
-                            "error");
+                logEvent(UbxLog::Error, UbxLog::In, UbxLog::NackReceived,
+                         { UbxLog::hex(ackedClass), UbxLog::hex(ackedId) }, msgClass, msgId);
             }
         }
         return;
@@ -1962,11 +2459,8 @@ void GNSSWindow::completeInitialization() {
     m_ackTimeoutTimer->stop();
     m_initTimer->stop();
 
-    int rate = ui->rateSpin->value();
-    m_pvtTimer->start(1000 / rate);
-    m_statusTimer->start(1000 / rate);
-
     ui->autoSendCheck->setChecked(true);
+    onAutoSendToggled(true);
 
     appendToLog(tr("Configuration complete. Starting NAV-PVT and NAV-STATUS."), "system");
 }
@@ -1977,15 +2471,29 @@ void GNSSWindow::processCfgMessages(quint8 msgId, const QByteArray& payload) {
 
     switch (msgId) {
     case UBX_CFG_PRT:
+        // A full port configuration (not a poll) also retunes the link;
+        // the configuration is only replayed when the port actually changed
+        m_portConfigChanged = false;
+        if (payload.size() >= 20) {
+            m_ubxParser.dispatch(UBX_CLASS_CFG, msgId, payload);
+        }
         sendUbxCfgPrtResponse();
-        sendInitialConfiguration();
+        if (m_portConfigChanged) {
+            sendInitialConfiguration();
+        }
         return;
+    case UBX_CFG_MSG:
+        processCfgMsg(payload);
+        break;
     case UBX_CFG_VALSET:
-        processCfgValGet(payload);
+        processCfgValSet(payload);
         break;
     case UBX_CFG_VALGET:
         processCfgValGet(payload);
         break;
+    case UBX_CFG_VALDEL:
+        processCfgValDel(payload);
+        break;
     case UBX_CFG_ITFM:
         sendUbxAck(UBX_CLASS_CFG, UBX_CFG_ITFM);
         sendUbxCfgItfm();
@@ -2019,29 +2527,12 @@ bool GNSSWindow::processInfoRequests(quint8 msgClass, quint8 msgId) {
 }
 
 QString GNSSWindow::processNavMessages(quint8 msgId, const QByteArray& payload) {
-    switch (msgId) {
-    case UBX_NAV_PVT: {
-        UbxParser::NavPvt pvt = UbxParser::parseNavPvt(payload);
-        displayNavPvt(pvt);
-        return QString("NAV-PVT: Lat=%1 Lon=%2 Fix=%3 Sats=%4")
-            .arg(pvt.lat/1e7, 0, 'f', 7)
-            .arg(pvt.lon/1e7, 0, 'f', 7)
-            .arg(pvt.fixType)
-            .arg(pvt.numSV);
-    }
-    case UBX_NAV_STATUS: {
-        UbxParser::NavStatus status = UbxParser::parseNavStatus(payload);
-        displayNavStatus(status);
-        return QString("NAV-STATUS: Fix=%1 TTFF=%2ms")
-            .arg(status.fixType)
-            .arg(status.ttff);
-    }
-    case UBX_NAV_SAT: {
-        UbxParser::NavSat sat = UbxParser::parseNavSat(payload);
-        return QString("NAV-SAT: Version=%1 SVs=%2")
-            .arg(sat.version)
-            .arg(sat.numSvs);
+    // Subscribers registered in registerHandlers() display and log the result
+    if (m_ubxParser.dispatch(UBX_CLASS_NAV, msgId, payload)) {
+        return QString();
     }
+
+    switch (msgId) {
     case UBX_NAV_TIMEUTC: {
         return QString("NAV-TimeUTC");
     }
@@ -2051,47 +2542,23 @@ QString GNSSWindow::processNavMessages(quint8 msgId, const QByteArray& payload)
 }
 
 QString GNSSWindow::processMonMessages(quint8 msgId, const QByteArray& payload) {
-    switch (msgId) {
-    case UBX_MON_VER: {
-        UbxParser::MonVer ver = UbxParser::parseMonVer(payload);
-        displayMonVer(ver);
-        return QString("MON-VER: SW=%1 HW=%2")
-            .arg(ver.swVersion)
-            .arg(ver.hwVersion);
-    }
-    case UBX_MON_HW: {
-        UbxParser::MonHw hw = UbxParser::parseMonHw(payload);
-        processMonHw(hw);
-        return QString("MON-HW: Antenna=%1 Jamming=%2%")
-            .arg(hw.aPower ? "ON" : "OFF")
-            .arg(hw.jamInd);
-    }
-    case UBX_MON_RF: {
-        UbxParser::MonRf rf = UbxParser::parseMonRf(payload);
-        displayMonRf(rf);
-        return QString("MON-RF: %1 RF blocks").arg(rf.nBlocks);
-    }
-    default:
-        return tr("Unknown MON message ID: 0x%1").arg(msgId, 2, 16, QLatin1Char('0'));
+    if (m_ubxParser.dispatch(UBX_CLASS_MON, msgId, payload)) {
+        return QString();
     }
+    return tr("Unknown MON message ID: 0x%1").arg(msgId, 2, 16, QLatin1Char('0'));
 }
 
 QString GNSSWindow::processSecMessages(quint8 msgId, const QByteArray& payload) {
-    switch (msgId) {
-    case UBX_SEC_UNIQID: {
-        UbxParser::SecUniqid uniqid = UbxParser::parseSecUniqid(payload);
-        emit secUniqidReceived(uniqid);
-        return QString("SEC-UNIQID: 0x%1").arg(uniqid.uniqueId, 8, 16, QLatin1Char('0'));
-    }
-    default:
-        return tr("Unknown SEC message ID: 0x%1").arg(msgId, 2, 16, QLatin1Char('0'));
+    if (m_ubxParser.dispatch(UBX_CLASS_SEC, msgId, payload)) {
+        return QString();
     }
+    return tr("Unknown SEC message ID: 0x%1").arg(msgId, 2, 16, QLatin1Char('0'));
 }
 
 void GNSSWindow::processInfMessages(quint8 msgId, const QByteArray& payload) {
     switch (msgId) {
     case UBX_INF_ERROR:
-        emit infErrorReceived(QString::fromLatin1(payload));
+        m_ubxParser.dispatch(UBX_CLASS_INF, msgId, payload);
         break;
     case UBX_INF_WARNING:
         appendToLog(QString("INF-WARNING: %1").arg(QString::fromLatin1(payload)), "warning");
@@ -2181,7 +2648,7 @@ void GNSSWindow::displayMonRf(const UbxParser::MonRf &data) {
                        .arg(data.version)
                        .arg(data.nBlocks);
 
-    for (int i = 0; i < data.nBlocks && i < 4; i++) {
+    for (int i = 0; i < data.blocks.size(); i++) {
         const auto& block = data.blocks[i];
 
         QString jammingState;
@@ -2218,12 +2685,26 @@ void GNSSWindow::displayMonRf(const UbxParser::MonRf &data) {
     appendToLog(info, "status");
 }
 
-void GNSSWindow::displayCfgPrt(const UbxParser::CfgPrt &data) {
+void GNSSWindow::applyCfgPrt(const UbxParser::CfgPrt &data) {
+    // Baud rate 0 asks for the current configuration, which
+    // processCfgMessages() answers
     if (data.baudRate == 0) {
-        qDebug() << "Received CFG-PRT ACK, requesting current config...";
-        sendUbxCfgPrtResponse();
         return;
     }
+    if (data.portID == m_portConfig.portID && data.baudRate == m_portConfig.baudRate &&
+        data.inProtoMask == m_portConfig.inProtoMask && data.outProtoMask == m_portConfig.outProtoMask) {
+        return;
+    }
+    m_portConfig = data;
+    m_portConfigChanged = true;
+
+    // The port switches to the requested rate like a real receiver would
+    if (m_transport) {
+        m_transport->setBaudRate(data.baudRate);
+    }
+}
+
+void GNSSWindow::displayCfgPrt(const UbxParser::CfgPrt &data) {
     ui->statusbar->showMessage(
         QString("Port config: Baud=%1, InProto=0x%2, OutProto=0x%3")
             .arg(data.baudRate)
@@ -2259,55 +2740,161 @@ void GNSSWindow::displayMonVer(const UbxParser::MonVer &data) {
         5000);
 }
 
+bool GNSSWindow::isLogPaused() const {
+    return !ui || !ui->actionPauseLog || ui->actionPauseLog->isChecked();
+}
+
 void GNSSWindow::appendToLog(const QString &message, const QString &type) {
-    if (!ui || !ui->actionPauseLog || ui->actionPauseLog->isChecked()) {
+    if (isLogPaused()) {
         return;
     }
 
-    QString timestamp = QDateTime::currentDateTime().toString("[hh:mm:ss]");
-    QString formattedMessage;
+    UbxLog::Level level;
+    UbxLog::Direction direction;
+    UbxLog::classify(type, level, direction);
+    m_logRing.push(level, direction, UbxLog::FreeText, { UbxLog::text() }, 0, 0, message);
+}
 
-    if (type.compare("in", Qt::CaseInsensitive) == 0) {
-        formattedMessage = QString("<div style='color:#2E7D32;'><b>%1 IN:</b> %2</div>")
-                               .arg(timestamp, message.toHtmlEscaped());
+void GNSSWindow::logEvent(UbxLog::Level level, UbxLog::Direction direction, UbxLog::Template templateId,
+                          std::initializer_list<UbxLog::Arg> args, quint8 msgClass, quint8 msgId,
+                          const QString &text) {
+    if (isLogPaused()) {
+        return;
     }
-    else if (type.compare("out", Qt::CaseInsensitive) == 0) {
-        formattedMessage = QString("<div style='color:#1565C0;'><b>%1 OUT:</b> %2</div>")
-                               .arg(timestamp, message.toHtmlEscaped());
+    m_logRing.push(level, direction, templateId, args, msgClass, msgId, text);
+}
+
+void GNSSWindow::setupLogSearch() {
+    m_logFilterModel = new UbxLogFilterModel(&m_logIndex, m_logJournal, this);
+
+    m_logFilterClass = new QComboBox;
+    m_logFilterClass->addItem(tr("Any class"), -1);
+    m_logFilterClass->addItem("NAV (0x01)", UBX_CLASS_NAV);
+    m_logFilterClass->addItem("CFG (0x06)", UBX_CLASS_CFG);
+    m_logFilterClass->addItem("MON (0x0A)", UBX_CLASS_MON);
+    m_logFilterClass->addItem("SEC (0x27)", UBX_CLASS_SEC);
+    m_logFilterClass->addItem("INF (0x04)", UBX_CLASS_INF);
+    m_logFilterClass->addItem("ACK (0x05)", UBX_CLASS_ACK);
+
+    m_logFilterId = new QLineEdit;
+    m_logFilterId->setPlaceholderText(tr("ID (hex)"));
+    m_logFilterId->setMaximumWidth(70);
+
+    m_logFilterDirection = new QComboBox;
+    m_logFilterDirection->addItem(tr("Any direction"), -1);
+    m_logFilterDirection->addItem(tr("In"), UbxLog::In);
+    m_logFilterDirection->addItem(tr("Out"), UbxLog::Out);
+
+    m_logFilterLevel = new QComboBox;
+    m_logFilterLevel->addItem(tr("Debug and above"), UbxLog::Debug);
+    m_logFilterLevel->addItem(tr("Info and above"), UbxLog::Info);
+    m_logFilterLevel->addItem(tr("System and above"), UbxLog::System);
+    m_logFilterLevel->addItem(tr("Warning and above"), UbxLog::Warning);
+    m_logFilterLevel->addItem(tr("Errors only"), UbxLog::Error);
+
+    m_logFilterMinutes = new QSpinBox;
+    m_logFilterMinutes->setRange(0, 24 * 60);
+    m_logFilterMinutes->setSpecialValueText(tr("Whole session"));
+    m_logFilterMinutes->setSuffix(tr(" min"));
+
+    QListView *view = new QListView;
+    view->setModel(m_logFilterModel);
+    view->setUniformItemSizes(true);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    controls->addWidget(m_logFilterClass);
+    controls->addWidget(m_logFilterId);
+    controls->addWidget(m_logFilterDirection);
+    controls->addWidget(m_logFilterLevel);
+    controls->addWidget(m_logFilterMinutes);
+
+    QWidget *panel = new QWidget;
+    QVBoxLayout *layout = new QVBoxLayout(panel);
+    layout->addLayout(controls);
+    layout->addWidget(view);
+
+    QDockWidget *dock = new QDockWidget(tr("Log Search"), this);
+    dock->setObjectName("logSearchDock");
+    dock->setWidget(panel);
+    addDockWidget(Qt::BottomDockWidgetArea, dock);
+    dock->hide();
+    ui->toolBar->addAction(dock->toggleViewAction());
+
+    connect(m_logFilterClass, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GNSSWindow::applyLogFilter);
+    connect(m_logFilterId, &QLineEdit::editingFinished, this, &GNSSWindow::applyLogFilter);
+    connect(m_logFilterDirection, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GNSSWindow::applyLogFilter);
+    connect(m_logFilterLevel, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &GNSSWindow::applyLogFilter);
+    connect(m_logFilterMinutes, QOverload<int>::of(&QSpinBox::valueChanged), this, &GNSSWindow::applyLogFilter);
+}
+
+void GNSSWindow::applyLogFilter() {
+    UbxLogIndex::Filter filter;
+    filter.msgClass = m_logFilterClass->currentData().toInt();
+    bool ok = false;
+    const int id = m_logFilterId->text().trimmed().toInt(&ok, 16);
+    filter.msgId = ok ? id : -1;
+    filter.direction = m_logFilterDirection->currentData().toInt();
+    filter.minLevel = m_logFilterLevel->currentData().toInt();
+    filter.lastMinutes = m_logFilterMinutes->value();
+
+    m_logFilterModel->setFilter(filter);
+}
+
+void GNSSWindow::setLogFilterControls(const UbxLogIndex::Filter &filter) {
+    const QList<QWidget*> controls = { m_logFilterClass, m_logFilterId, m_logFilterDirection,
+                                       m_logFilterLevel, m_logFilterMinutes };
+    for (QWidget *control : controls) {
+        control->blockSignals(true);
+    }
+
+    m_logFilterClass->setCurrentIndex(qMax(0, m_logFilterClass->findData(filter.msgClass)));
+    m_logFilterId->setText(filter.msgId >= 0 ? QString::number(filter.msgId, 16).toUpper() : QString());
+    m_logFilterDirection->setCurrentIndex(qMax(0, m_logFilterDirection->findData(filter.direction)));
+    m_logFilterLevel->setCurrentIndex(qMax(0, m_logFilterLevel->findData(filter.minLevel)));
+    m_logFilterMinutes->setValue(filter.lastMinutes);
+
+    for (QWidget *control : controls) {
+        control->blockSignals(false);
+    }
+    applyLogFilter();
+}
+
+void GNSSWindow::drainLog() {
+    if (!ui || !ui->teReceived) {
+        return;
     }
-    else if (type.compare("system", Qt::CaseInsensitive) == 0) {
-        formattedMessage = QString("<div style='color:#7B1FA2;'><b>%1 SYS:</b> %2</div>")
-                               .arg(timestamp, message.toHtmlEscaped());
+
+    m_logBatch.resize(0);
+    UbxLog::Record record;
+    while (m_logRing.pop(record)) {
+        if (m_logJournal) {
+            m_logIndex.add(record, m_logJournal->append(record));
+        }
+        m_logBatch.append(record);
     }
-    else if (type.compare("error", Qt::CaseInsensitive) == 0) {
-        formattedMessage = QString("<div style='color:#C62828;'><b>%1 ERR:</b> %2</div>")
-                               .arg(timestamp, message.toHtmlEscaped());
+    if (m_logBatch.isEmpty()) {
+        return;
     }
-    else {
-        formattedMessage = QString("<div style='color:#000000;'>%1 %2</div>")
-                               .arg(timestamp, message.toHtmlEscaped());
+
+    // Only the lines the view keeps are worth formatting
+    QString html;
+    for (int i = qMax(0, m_logBatch.size() - LogViewMaxLines); i < m_logBatch.size(); i++) {
+        html += UbxLog::formatHtml(m_logBatch.at(i));
     }
 
-    if (ui && ui->teReceived) {
-        if (ui->teReceived->document()->lineCount() > 10000) {
-            ui->teReceived->clear();
-            ui->teReceived->append(QString("<div style='color:#7B1FA2;'><b>%1</b></div>")
-                                       .arg(tr("Log cleared automatically")));
-        }
+    if (m_logFilterModel) {
+        m_logFilterModel->update();
+    }
 
-        ui->teReceived->append(formattedMessage);
+    // The view keeps the newest lines only, the journal has the full session
+    ui->teReceived->append(html);
 
-        if (!ui->actionPauseLog->isChecked()) {
-            QTextCursor cursor = ui->teReceived->textCursor();
-            cursor.movePosition(QTextCursor::End);
-            ui->teReceived->setTextCursor(cursor);
-        }
+    if (!ui->actionPauseLog->isChecked()) {
+        QTextCursor cursor = ui->teReceived->textCursor();
+        cursor.movePosition(QTextCursor::End);
+        ui->teReceived->setTextCursor(cursor);
     }
-
-    qDebug().noquote() << QString("%1 %2: %3")
-                              .arg(timestamp)
-                              .arg(type.toUpper())
-                              .arg(message);
 }
 
 void GNSSWindow::processMonHw(const UbxParser::MonHw &hw) {
@@ -2322,13 +2909,11 @@ void GNSSWindow::processMonHw(const UbxParser::MonHw &hw) {
 }
 
 void GNSSWindow::sendUbxCfgAnt() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-ANT"), "error");
         return;
     }
 
-    QByteArray payload(4, 0x00);
-
     quint16 flags = 0;
     if (ui->cbAntSupplyCtrl->isChecked()) flags |= 0x0001;
     if (ui->cbAntShortDetect->isChecked()) flags |= 0x0002;
@@ -2342,72 +2927,40 @@ void GNSSWindow::sendUbxCfgAnt() {
     pins |= ((ui->sbAntOpenPin->value() & 0x1F) << 10);
     if (ui->cbAntReconfig->isChecked()) pins |= 0x8000;
 
-    qToLittleEndian<quint16>(flags, payload.data());
-    qToLittleEndian<quint16>(pins, payload.data() + 2);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgAnt)) {
+        QByteArray payload(4, 0x00);
+        qToLittleEndian<quint16>(flags, payload.data());
+        qToLittleEndian<quint16>(pins, payload.data() + 2);
+        m_frameCache.store(UbxFrameCache::FrameCfgAnt, UBX_CLASS_CFG, UBX_CFG_ANT, payload);
+    }
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_ANT, payload);
-    appendToLog(tr("CFG-ANT sent: flags=0x%1, pins=0x%2")
-                    .arg(flags, 4, 16, QLatin1Char('0'))
-                    .arg(pins, 4, 16, QLatin1Char('0')), "config");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgAnt));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgAntSent,
+             { UbxLog::hex(flags, 4), UbxLog::hex(pins, 4) }, UBX_CLASS_CFG, UBX_CFG_ANT);
 }
 
 void GNSSWindow::sendUbxNavSat() {
-    QByteArray payload;
-    QRandomGenerator *generator = QRandomGenerator::global();
-
-    payload.append("\x00\x00\x00\x00", 4); // iTOW (fill later)
-    payload.append(static_cast<char>(ui->sbSatVersion->value())); // version
-    payload.append(static_cast<char>(ui->sbNumSatsSat->value())); // numSvs
-    payload.append("\x00\x00", 2); // reserved
-
-    quint8 qualityInd = static_cast<quint8>(ui->cbQualityInd->currentIndex());
-    quint8 health = static_cast<quint8>(ui->cbHealth->currentIndex());
-    bool svUsed = ui->cbSvUsed->isChecked();
-    bool diffCorr = ui->cbDiffCorr->isChecked();
-    bool smoothed = ui->cbSmoothed->isChecked();
-    quint8 orbitSource = static_cast<quint8>(ui->cbOrbitSource->currentIndex());
-    double prResMin = ui->dsbPrResMin->value();
-    double prResMax = ui->dsbPrResMax->value();
-
-    for(int i = 0; i < ui->sbNumSatsSat->value(); i++) {
-        payload.append(static_cast<char>(1)); // gnssId (GPS)
-        payload.append(static_cast<char>(i+1)); // svId
-        payload.append(static_cast<char>(35 + generator->bounded(20))); // cno (35-55 dBHz)
-        payload.append(static_cast<char>(30 + generator->bounded(50))); // elev (30-80 deg)
+    const SimState state = m_simState.read();
+    const RfScenario::Sample rf = m_rfScenario.evaluate(m_rfScenarioClock.elapsed());
+    const UbxPacketArena::Frame frame = m_epochBuilder.buildNavSat(state, m_epoch, UbxTime::now(), rf);
 
-        qint16 azim = generator->bounded(360);
-        payload.append(static_cast<char>(azim & 0xFF));
-        payload.append(static_cast<char>((azim >> 8) & 0xFF));
-
-        double prResMeters = prResMin + generator->bounded(prResMax - prResMin);
-        qint16 prRes = static_cast<qint16>(prResMeters * 10); // convert to 0.1m units
-        payload.append(static_cast<char>(prRes & 0xFF));
-        payload.append(static_cast<char>((prRes >> 8) & 0xFF));
-
-        quint32 flags = 0;
-
-        flags |= (qualityInd & 0x07) << 0;  // qualityInd (bits 0-2)
-        flags |= (svUsed ? 1 : 0) << 3;     // svUsed (bit 3)
-        flags |= (health & 0x03) << 4;      // health (bits 4-5)
-        flags |= (diffCorr ? 1 : 0) << 6;   // diffCorr (bit 6)
-        flags |= (smoothed ? 1 : 0) << 7;   // smoothed (bit 7)
-        flags |= (orbitSource & 0x07) << 8; // orbitSource (bits 8-10)
-
-        if (orbitSource == 1) flags |= 1 << 11; // ephAvail if ephemeris
-        flags |= 1 << 12; // almAvail (always available)
-
-        payload.append(static_cast<char>((flags >> 0) & 0xFF));
-        payload.append(static_cast<char>((flags >> 8) & 0xFF));
-        payload.append(static_cast<char>((flags >> 16) & 0xFF));
-        payload.append(static_cast<char>((flags >> 24) & 0xFF));
+    // The tracked SVs lead the list, read them back for the sky plot
+    m_telemetry->clearSatellites();
+    const char *payload = frame.data + 6;
+    for (int i = 0; i < m_epochBuilder.navSatTracked(); i++) {
+        const char *sat = payload + 8 + 12 * i;
+        SkyPlotWidget::Satellite skySat;
+        skySat.gnssId = static_cast<quint8>(sat[0]);
+        skySat.svId = static_cast<quint8>(sat[1]);
+        skySat.cno = static_cast<quint8>(sat[2]);
+        skySat.elev = static_cast<qint8>(sat[3]);
+        skySat.azim = qFromLittleEndian<qint16>(sat + 4);
+        skySat.used = state.svUsed;
+        m_telemetry->addSatellite(skySat);
     }
 
-    QDateTime currentTime = QDateTime::currentDateTimeUtc();
-    quint32 iTOW = static_cast<quint32>(currentTime.toMSecsSinceEpoch() % (7 * 24 * 60 * 60 * 1000));
-    qToLittleEndian<quint32>(iTOW, payload.data());
-
-    createUbxPacket(UBX_CLASS_NAV, UBX_NAV_SAT, payload);
-    appendToLog(tr("Sent NAV-SAT message"), "out");
+    sendUbxFrame(frame);
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::NavSatSent, {}, UBX_CLASS_NAV, UBX_NAV_SAT);
 }
 
 void GNSSWindow::onSendButtonClicked() {
@@ -2454,54 +3007,26 @@ void GNSSWindow::onAutoSendToggled(bool checked) {
         return;
     }
 
-    if (checked) {
-        int rate = ui->rateSpin->value();
-        m_pvtTimer->start(1000 / rate);
-        m_statusTimer->start(1000 / rate);
-    } else {
-        m_pvtTimer->stop();
-        m_statusTimer->stop();
-    }
+    // NAV-PVT and NAV-STATUS every epoch, the other outputs keep their rates
+    const quint8 rate = checked ? 1 : 0;
+    setOutputRate(UbxRateTable::NavPvt, rate);
+    setOutputRate(UbxRateTable::NavStatus, rate);
 }
 
 void GNSSWindow::onAutoSendNavPvtToggled(bool checked) {
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxNavPvt);
-        m_pvtTimer->start(1000 / ui->rateSpin->value());
-    } else {
-        m_pvtTimer->stop();
-    }
+    setOutputRate(UbxRateTable::NavPvt, checked ? autoSendRate(UbxRateTable::NavPvt) : 0);
 }
 
 void GNSSWindow::onAutoSendNavStatusToggled(bool checked) {
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxNavStatus);
-        m_statusTimer->start(1000 / ui->rateSpin->value());
-    } else {
-        m_statusTimer->stop();
-    }
+    setOutputRate(UbxRateTable::NavStatus, checked ? autoSendRate(UbxRateTable::NavStatus) : 0);
 }
 
 void GNSSWindow::onAutoSendNavSatToggled(bool checked) {
-    static QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GNSSWindow::sendUbxNavSat);
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxNavSat);
-        timer->start(1000 / ui->rateSpin->value());
-    } else {
-        timer->stop();
-    }
+    setOutputRate(UbxRateTable::NavSat, checked ? autoSendRate(UbxRateTable::NavSat) : 0);
 }
 
 void GNSSWindow::onAutoSendNavTimeUtcToggled(bool checked) {
-    static QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GNSSWindow::sendUbxNavTimeUtc);
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxNavTimeUtc);
-        timer->start(1000 / ui->rateSpin->value());
-    } else {
-        timer->stop();
-    }
+    setOutputRate(UbxRateTable::NavTimeUtc, checked ? autoSendRate(UbxRateTable::NavTimeUtc) : 0);
 }
 
 void GNSSWindow::onAutoSendMonVerToggled(bool checked) {
@@ -2516,25 +3041,11 @@ void GNSSWindow::onAutoSendMonVerToggled(bool checked) {
 }
 
 void GNSSWindow::onAutoSendMonHwToggled(bool checked) {
-    static QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GNSSWindow::sendUbxMonHw);
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxMonHw);
-        timer->start(5000);
-    } else {
-        timer->stop();
-    }
+    setOutputRate(UbxRateTable::MonHw, checked ? autoSendRate(UbxRateTable::MonHw) : 0);
 }
 
 void GNSSWindow::onAutoSendMonRfToggled(bool checked) {
-    static QTimer* timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GNSSWindow::sendUbxMonRf);
-    if (checked) {
-        QTimer::singleShot(0, this, &GNSSWindow::sendUbxMonRf);
-        timer->start(1000 / ui->rateSpin->value());
-    } else {
-        timer->stop();
-    }
+    setOutputRate(UbxRateTable::MonRf, checked ? autoSendRate(UbxRateTable::MonRf) : 0);
 }
 
 void GNSSWindow::onAutoSendCfgPrtToggled(bool checked) {
@@ -2680,113 +3191,210 @@ void GNSSWindow::onAutoSendSecUniqidToggled(bool checked) {
     }
 }
 
+void GNSSWindow::updateBandwidthBudget() {
+    if (!m_bandwidthLabel) {
+        return;
+    }
+
+    // Epoch outputs follow the rate table, the rest the timers in the onAutoSend*Toggled slots
+    const int epochMs = m_epochTimer->interval();
+    auto countList = [](const QString &text) { return text.split(',', Qt::SkipEmptyParts).size(); };
+    const int epochPayload[UbxRateTable::OutputCount] = {
+        92, 16, 8 + 12 * UbxEpochBuilder::navSatCount(ui->sbNumSatsSat->value()), 20, 60, 4 + 24 * ui->sbRfBlocks->value()
+    };
+
+    m_bandwidthPlanner.clear();
+    for (int output = 0; output < UbxRateTable::OutputCount; output++) {
+        const int rate = m_rateTable.rate(output, m_outputPort);
+        if (rate > 0) {
+            m_bandwidthPlanner.addOutput(UbxRateTable::name(output), epochPayload[output], epochMs * rate);
+        }
+    }
+    if (ui->cbAutoSendMonVer->isChecked()) {
+        m_bandwidthPlanner.addOutput("MON-VER", 40 + 30 * ui->teExtensions->toPlainText().split('\n', Qt::SkipEmptyParts).size(), 5000);
+    }
+    if (ui->cbAutoSendCfgValget->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-VALGET", 4 + 4 * countList(ui->leValgetKeys->text()), 5000);
+    }
+    if (ui->cbAutoSendCfgValset->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-VALSET", 4 + 8 * countList(ui->leValsetKeysValues->text()), 5000);
+    }
+    if (ui->cbAutoSendCfgPrt->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-PRT", 20, 10000);
+    }
+    if (ui->cbAutoSendCfgItfm->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-ITFM", 8, 10000);
+    }
+    if (ui->cbAutoSendCfgNav5->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-NAV5", 36, 10000);
+    }
+    if (ui->cbAutoSendCfgRate->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-RATE", 6, 10000);
+    }
+    if (ui->cbAutoSendCfgAnt->isChecked()) {
+        m_bandwidthPlanner.addOutput("CFG-ANT", 4, 10000);
+    }
+    if (ui->cbAutoSendSecUniqid->isChecked()) {
+        m_bandwidthPlanner.addOutput("SEC-UNIQID", 9, 10000);
+    }
+    if (ui->cbAutoSendInfDebug->isChecked()) {
+        m_bandwidthPlanner.addOutput("INF-DEBUG", ui->teInfDebugMessage->toPlainText().size(), 2000);
+    }
+    if (ui->cbAutoSendInfError->isChecked()) {
+        m_bandwidthPlanner.addOutput("INF-ERROR", ui->teInfErrorMessage->toPlainText().size(), 5000);
+    }
+    if (ui->cbAutoSendInfWarning->isChecked()) {
+        m_bandwidthPlanner.addOutput("INF-WARNING", ui->teInfWarningMessage->toPlainText().size(), 3000);
+    }
+    if (ui->cbAutoSendInfNotice->isChecked()) {
+        m_bandwidthPlanner.addOutput("INF-NOTICE", ui->teInfNoticeMessage->toPlainText().size(), 4000);
+    }
+    if (ui->cbAutoSendInfTest->isChecked()) {
+        m_bandwidthPlanner.addOutput("INF-TEST", ui->teInfTestMessage->toPlainText().size(), 3000);
+    }
+
+    const quint32 baudRate = ui->cbBaudRate->currentText().toUInt();
+    const UbxBandwidthPlanner::Report report =
+        m_bandwidthPlanner.plan(baudRate, epochMs, PtyTransport::TxQueueCapacity);
+
+    QString text = UbxBandwidthPlanner::summary(report);
+
+    // The paced PTY shows what the budget means in practice
+    if (auto *pty = qobject_cast<PtyTransport*>(m_transport)) {
+        text += tr(" | queue %1 ms (max %2 ms), %3 frames dropped")
+                    .arg(pty->lastQueueDelayMs(), 0, 'f', 1)
+                    .arg(pty->maxQueueDelayMs(), 0, 'f', 1)
+                    .arg(pty->overrunCount());
+    }
+
+    m_bandwidthLabel->setText(text);
+    m_bandwidthLabel->setStyleSheet(report.oversubscribed ? "color: red;" : QString());
+
+    // Each warning is logged once when its condition starts
+    if (report.oversubscribed && !m_bandwidthOversubscribed) {
+        appendToLog(tr("Output exceeds UART bandwidth at %1 baud: %2")
+                        .arg(baudRate)
+                        .arg(UbxBandwidthPlanner::summary(report)), "warning");
+    }
+    if (report.burstDroppedBytes > 0 && !m_bandwidthBurstOverflow) {
+        appendToLog(tr("Worst-case burst exceeds the %1-byte TX buffer by %2 bytes")
+                        .arg(PtyTransport::TxQueueCapacity)
+                        .arg(report.burstDroppedBytes), "warning");
+    }
+    m_bandwidthOversubscribed = report.oversubscribed;
+    m_bandwidthBurstOverflow = report.burstDroppedBytes > 0;
+}
+
 void GNSSWindow::sendUbxCfgPrtResponse() {
-    QByteArray payload(20, 0x00);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgPrtResponse)) {
+        QByteArray payload(20, 0x00);
+
+        payload[0] = 0x01; // Port ID: UART1
+        qToLittleEndian<quint32>(0x000008D0, payload.data() + 4); // Mode: 8N1, no parity
+        qToLittleEndian<quint32>(115200, payload.data() + 8); // BaudRate: 115200
+        qToLittleEndian<quint16>(0x0003, payload.data() + 12); // inProtoMask: UBX + NMEA
+        qToLittleEndian<quint16>(0x0003, payload.data() + 14); // outProtoMask: UBX + NMEA
 
-    payload[0] = 0x01; // Port ID: UART1
-    qToLittleEndian<quint32>(0x000008D0, payload.data() + 4); // Mode: 8N1, no parity
-    qToLittleEndian<quint32>(115200, payload.data() + 8); // BaudRate: 115200
-    qToLittleEndian<quint16>(0x0003, payload.data() + 12); // inProtoMask: UBX + NMEA
-    qToLittleEndian<quint16>(0x0003, payload.data() + 14); // outProtoMask: UBX + NMEA
+        m_frameCache.store(UbxFrameCache::FrameCfgPrtResponse, UBX_CLASS_CFG, UBX_CFG_PRT, payload);
+    }
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_PRT, payload);
-    appendToLog(tr("Sent CFG-PRT"), "config");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgPrtResponse));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgPrtResponseSent, {},
+             UBX_CLASS_CFG, UBX_CFG_PRT);
 }
 
 void GNSSWindow::sendUbxCfgNav5() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-NAV5"), "error");
         return;
     }
 
-    QByteArray payload(36, 0x00);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgNav5)) {
+        QByteArray payload(36, 0x00);
 
-    quint16 mask = 0x05FF;
-    qToLittleEndian<quint16>(mask, payload.data());
+        quint16 mask = 0x05FF;
+        qToLittleEndian<quint16>(mask, payload.data());
 
-    payload[2] = static_cast<quint8>(ui->cbDynModel->currentIndex());
+        payload[2] = static_cast<quint8>(ui->cbDynModel->currentIndex());
 
-    payload[3] = static_cast<quint8>(ui->cbFixMode->currentIndex() + 1);
+        payload[3] = static_cast<quint8>(ui->cbFixMode->currentIndex() + 1);
 
-    qint32 fixedAlt = static_cast<qint32>(ui->dsbFixedAlt->value() * 100);
-    qToLittleEndian<qint32>(fixedAlt, payload.data() + 4);
+        qint32 fixedAlt = static_cast<qint32>(ui->dsbFixedAlt->value() * 100);
+        qToLittleEndian<qint32>(fixedAlt, payload.data() + 4);
 
-    quint32 fixedAltVar = 10000; // Default 1 m^2
-    qToLittleEndian<quint32>(fixedAltVar, payload.data() + 8);
+        quint32 fixedAltVar = 10000; // Default 1 m^2
+        qToLittleEndian<quint32>(fixedAltVar, payload.data() + 8);
 
-    payload[12] = static_cast<quint8>(ui->sbMinElev->value());
+        payload[12] = static_cast<quint8>(ui->sbMinElev->value());
 
-    quint16 pDop = static_cast<quint16>(ui->dsbPDOP->value() * 10);
-    qToLittleEndian<quint16>(pDop, payload.data() + 14);
+        quint16 pDop = static_cast<quint16>(ui->dsbPDOP->value() * 10);
+        qToLittleEndian<quint16>(pDop, payload.data() + 14);
 
-    quint16 tDop = static_cast<quint16>(ui->dsbTDOP->value() * 10);
-    qToLittleEndian<quint16>(tDop, payload.data() + 16);
+        quint16 tDop = static_cast<quint16>(ui->dsbTDOP->value() * 10);
+        qToLittleEndian<quint16>(tDop, payload.data() + 16);
 
-    quint16 pAcc = static_cast<quint16>(ui->dsbPAcc->value());
-    qToLittleEndian<quint16>(pAcc, payload.data() + 18);
+        quint16 pAcc = static_cast<quint16>(ui->dsbPAcc->value());
+        qToLittleEndian<quint16>(pAcc, payload.data() + 18);
 
-    quint16 tAcc = static_cast<quint16>(ui->dsbTAcc->value());
-    qToLittleEndian<quint16>(tAcc, payload.data() + 20);
+        quint16 tAcc = static_cast<quint16>(ui->dsbTAcc->value());
+        qToLittleEndian<quint16>(tAcc, payload.data() + 20);
 
-    payload[22] = static_cast<quint8>(ui->dsbStaticHoldThresh->value());
+        payload[22] = static_cast<quint8>(ui->dsbStaticHoldThresh->value());
 
-    payload[23] = static_cast<quint8>(ui->sbDgnssTimeout->value());
+        payload[23] = static_cast<quint8>(ui->sbDgnssTimeout->value());
 
-    payload[24] = static_cast<quint8>(ui->sbCnoThreshNumSVs->value());
-    payload[25] = static_cast<quint8>(ui->sbCnoThresh->value());
+        payload[24] = static_cast<quint8>(ui->sbCnoThreshNumSVs->value());
+        payload[25] = static_cast<quint8>(ui->sbCnoThresh->value());
 
-    quint16 staticHoldMaxDist = static_cast<quint16>(ui->dsbStaticHoldMaxDist->value());
-    qToLittleEndian<quint16>(staticHoldMaxDist, payload.data() + 28);
+        quint16 staticHoldMaxDist = static_cast<quint16>(ui->dsbStaticHoldMaxDist->value());
+        qToLittleEndian<quint16>(staticHoldMaxDist, payload.data() + 28);
 
-    payload[30] = static_cast<quint8>(ui->cbUtcStandard->currentIndex());
+        payload[30] = static_cast<quint8>(ui->cbUtcStandard->currentIndex());
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_NAV5, payload);
-    appendToLog(tr("Sent CFG-NAV5 configuration"), "config");
+        m_frameCache.store(UbxFrameCache::FrameCfgNav5, UBX_CLASS_CFG, UBX_CFG_NAV5, payload);
+    }
+
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgNav5));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgNav5Sent, {},
+             UBX_CLASS_CFG, UBX_CFG_NAV5);
 }
 
 void GNSSWindow::sendUbxMonVer() {
-    QByteArray payload;
-
-    // Software version (30 bytes, null-terminated)
-    QString swVersion = ui->leSwVersion->text();
-    QByteArray swVersionBytes = swVersion.left(29).toLatin1();
-    payload.append(swVersionBytes);
-    payload.append('\0');
-    while (payload.size() < 30) payload.append('\0');
+    if (m_frameCache.isDirty(UbxFrameCache::FrameMonVer)) {
+        QByteArray payload;
 
-    QString hwVersion = ui->leHwVersion->text();
-    QByteArray hwVersionBytes = hwVersion.left(9).toLatin1();
-    payload.append(hwVersionBytes);
-    payload.append('\0');
-    while (payload.size() < 40) payload.append('\0');
+        // Software version (30 bytes, null-terminated)
+        QByteArray swVersionBytes = ui->leSwVersion->text().left(29).toLatin1();
+        payload.append(swVersionBytes);
+        payload.append('\0');
+        while (payload.size() < 30) payload.append('\0');
 
-    QStringList extensions = ui->teExtensions->toPlainText().split('\n', Qt::SkipEmptyParts);
-    for (const QString &ext : extensions) {
-        QByteArray extBytes = ext.left(29).toLatin1();
-        payload.append(extBytes);
+        QByteArray hwVersionBytes = ui->leHwVersion->text().left(9).toLatin1();
+        payload.append(hwVersionBytes);
         payload.append('\0');
-        while (payload.size() % 30 != 0) payload.append('\0');
+        while (payload.size() < 40) payload.append('\0');
+
+        QStringList extensions = ui->teExtensions->toPlainText().split('\n', Qt::SkipEmptyParts);
+        for (const QString &ext : extensions) {
+            QByteArray extBytes = ext.left(29).toLatin1();
+            payload.append(extBytes);
+            payload.append('\0');
+            while ((payload.size() - 40) % 30 != 0) payload.append('\0');
+        }
+
+        m_frameCache.store(UbxFrameCache::FrameMonVer, UBX_CLASS_MON, UBX_MON_VER, payload);
     }
 
-    createUbxPacket(UBX_CLASS_MON, UBX_MON_VER, payload);
+    const QByteArray &frame = m_frameCache.frame(UbxFrameCache::FrameMonVer);
+    sendUbxFrame(frame);
     appendToLog(tr("Sent MON-VER: SW=%1, HW=%2, %3 extensions")
-                    .arg(swVersion, hwVersion, QString::number(extensions.size())), "config");
+                    .arg(ui->leSwVersion->text(), ui->leHwVersion->text(),
+                         QString::number((frame.size() - 8 - 40) / 30)), "config");
 }
 
 void GNSSWindow::sendUbxNavStatus() {
-    QByteArray payload(16, 0x00);
-    QDateTime currentTime = QDateTime::currentDateTime();
-    quint32 iTOW = static_cast<quint32>(currentTime.toMSecsSinceEpoch() % (7 * 24 * 60 * 60 * 1000));
-
-    quint8 fixType = static_cast<quint8>(ui->sbFixTypeStatus->value());
-    quint32 ttff = static_cast<quint32>(ui->sbTtff->value());
-
-    qToLittleEndian<quint32>(iTOW, payload.data()); // iTOW
-    payload[4] = fixType; // fixType
-    qToLittleEndian<quint32>(ttff, payload.data() + 8); // ttff
-
-    createUbxPacket(UBX_CLASS_NAV, UBX_NAV_STATUS, payload);
-    appendToLog(tr("Sent NAV-STATUS"), "out");
+    sendUbxFrame(m_epochBuilder.buildNavStatus(m_simState.read(), UbxTime::now()));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::NavStatusSent, {}, UBX_CLASS_NAV, UBX_NAV_STATUS);
 }
 
 void GNSSWindow::on_btnClearLog_clicked() {
@@ -2809,8 +3417,17 @@ void GNSSWindow::saveLogToFile() {
     QString fileName = QFileDialog::getSaveFileName(this, tr("Save Log"), "", tr("Text Files (*.txt);;All Files (*)"));
     if (fileName.isEmpty()) return;
 
+    if (!m_logJournal->path().isEmpty()) {
+        // Streamed from the journal on its own thread, see exportFinished
+        m_logJournal->exportText(fileName);
+        return;
+    }
+
     QFile file(fileName);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return;
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not save file"));
+        return;
+    }
 
     QTextStream out(&file);
     out << ui->teReceived->toPlainText();
@@ -2832,27 +3449,23 @@ void GNSSWindow::pauseLog(bool paused) {
 }
 
 void GNSSWindow::sendUbxAck(quint8 msgClass, quint8 msgId) {
-    QByteArray payload;
-    payload.append(static_cast<char>(msgClass));
-    payload.append(static_cast<char>(msgId));
+    char *payload = m_packetArena.beginFrame(UBX_CLASS_ACK, UBX_ACK_ACK, 2);
+    payload[0] = static_cast<char>(msgClass);
+    payload[1] = static_cast<char>(msgId);
 
-    createUbxPacket(UBX_CLASS_ACK, UBX_ACK_ACK, payload);
-    appendToLog(tr("Sent ACK for Class=0x%1 ID=0x%2")
-                    .arg(msgClass, 2, 16, QLatin1Char('0'))
-                    .arg(msgId, 2, 16, QLatin1Char('0')),
-                "config");
+    sendUbxFrame(m_packetArena.finishFrame());
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::AckSent,
+             { UbxLog::hex(msgClass), UbxLog::hex(msgId) }, UBX_CLASS_ACK, UBX_ACK_ACK);
 }
 
 void GNSSWindow::sendUbxNack(quint8 msgClass, quint8 msgId) {
-    QByteArray payload;
-    payload.append(static_cast<char>(msgClass));
-    payload.append(static_cast<char>(msgId));
+    char *payload = m_packetArena.beginFrame(UBX_CLASS_ACK, UBX_ACK_NAK, 2);
+    payload[0] = static_cast<char>(msgClass);
+    payload[1] = static_cast<char>(msgId);
 
-    createUbxPacket(UBX_CLASS_ACK, UBX_ACK_NAK, payload);
-    appendToLog(tr("Sent NACK for Class=0x%1 ID=0x%2")
-                    .arg(msgClass, 2, 16, QLatin1Char('0'))
-                    .arg(msgId, 2, 16, QLatin1Char('0')),
-                "error");
+    sendUbxFrame(m_packetArena.finishFrame());
+    logEvent(UbxLog::Error, UbxLog::Out, UbxLog::NackSent,
+             { UbxLog::hex(msgClass), UbxLog::hex(msgId) }, UBX_CLASS_ACK, UBX_ACK_NAK);
 }
 void GNSSWindow::setupNavPvtFields() {
     ui->gbNavPvtFields->setVisible(true);
@@ -2912,165 +3525,150 @@ void GNSSWindow::setupCfgItfmFields() {
 }
 
 void GNSSWindow::sendUbxCfgPrt() {
-    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+    if (!m_transport || !m_transport->isOpen()) {
         appendToLog(tr("Error: No active connection to send CFG-PRT"), "error");
         return;
     }
 
-    QByteArray payload(20, 0x00);
-
     quint8 portId = static_cast<quint8>(ui->cbPortId->currentIndex() + 1);
-    payload[0] = portId;
-
     quint32 baudRate = ui->cbBaudRate->currentText().toUInt();
-    qToLittleEndian<quint32>(baudRate, payload.data() + 8);
 
     quint16 inProtoMask = 0;
     if (ui->cbInUbx->isChecked()) inProtoMask |= 0x0001;
     if (ui->cbInNmea->isChecked()) inProtoMask |= 0x0002;
     if (ui->cbInRtcm->isChecked()) inProtoMask |= 0x0004;
-    qToLittleEndian<quint16>(inProtoMask, payload.data() + 12);
 
     quint16 outProtoMask = 0;
     if (ui->cbOutUbx->isChecked()) outProtoMask |= 0x0001;
     if (ui->cbOutNmea->isChecked()) outProtoMask |= 0x0002;
     if (ui->cbOutRtcm->isChecked()) outProtoMask |= 0x0004;
-    qToLittleEndian<quint16>(outProtoMask, payload.data() + 14);
 
-    qToLittleEndian<quint32>(0x000008D0, payload.data() + 4);
+    if (m_frameCache.isDirty(UbxFrameCache::FrameCfgPrt)) {
+        QByteArray payload(20, 0x00);
+        payload[0] = portId;
+        qToLittleEndian<quint32>(0x000008D0, payload.data() + 4);
+        qToLittleEndian<quint32>(baudRate, payload.data() + 8);
+        qToLittleEndian<quint16>(inProtoMask, payload.data() + 12);
+        qToLittleEndian<quint16>(outProtoMask, payload.data() + 14);
+        m_frameCache.store(UbxFrameCache::FrameCfgPrt, UBX_CLASS_CFG, UBX_CFG_PRT, payload);
+    }
 
-    createUbxPacket(UBX_CLASS_CFG, UBX_CFG_PRT, payload);
-    appendToLog(tr("Sent CFG-PRT: Port=%1, Baud=%2, InProto=0x%3, OutProto=0x%4")
-                    .arg(portId)
-                    .arg(baudRate)
-                    .arg(inProtoMask, 4, 16, QLatin1Char('0'))
-                    .arg(outProtoMask, 4, 16, QLatin1Char('0')), "config");
+    sendUbxFrame(m_frameCache.frame(UbxFrameCache::FrameCfgPrt));
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::CfgPrtSent,
+             { UbxLog::num(portId), UbxLog::num(baudRate),
+               UbxLog::hex(inProtoMask, 4), UbxLog::hex(outProtoMask, 4) },
+             UBX_CLASS_CFG, UBX_CFG_PRT);
 }
 
 void GNSSWindow::sendUbxMonHw() {
-    QByteArray payload(60, 0x00);
-
-    quint16 noise = static_cast<quint16>(ui->sbHwNoise->value());
-    qToLittleEndian<quint16>(noise, payload.data() + 16);
-
-    quint16 agc = static_cast<quint16>(ui->sbHwAgc->value() * 81.91);
-    qToLittleEndian<quint16>(agc, payload.data() + 18);
+    static const char *const antStatusNames[] = { "INIT", "DONTKNOW", "OK", "SHORT", "OPEN" };
+    static const char *const antPowerNames[] = { "OFF", "ON", "DONTKNOW" };
 
-    payload[20] = static_cast<quint8>(ui->cbHwAntStatus->currentIndex());
+    const SimState state = m_simState.read();
+    const RfScenario::Sample rf = m_rfScenario.evaluate(m_rfScenarioClock.elapsed());
+    UbxEpochBuilder::MonHwInfo info;
+    sendUbxFrame(m_epochBuilder.buildMonHw(state, rf, info));
+    m_telemetry->addInterference(TelemetryDock::MonHw, info.agcPercent, info.jamInd);
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::MonHwSent,
+             { UbxLog::num(info.noise), UbxLog::num(qRound(info.agcPercent)),
+               UbxLog::tag(info.antStatus >= 0 && info.antStatus < 5 ? antStatusNames[info.antStatus] : "?"),
+               UbxLog::tag(state.hwAntPower >= 0 && state.hwAntPower < 3 ? antPowerNames[state.hwAntPower] : "?") },
+             UBX_CLASS_MON, UBX_MON_HW);
+}
 
-    payload[21] = static_cast<quint8>(ui->cbHwAntPower->currentIndex());
+void GNSSWindow::sendUbxNavPvt() {
+    // NAV-PVT opens a navigation epoch, earlier frames are already written
+    m_packetArena.reset();
+    SimState state = m_simState.read();
 
-    quint8 flags = 0;
-    flags |= (ui->cbHwJamming->currentIndex() << 2);
-    payload[22] = flags;
+    // External truth changes every epoch, at the configured latency
+    VehicleInput::Sample truth;
+    const bool external = m_vehicleInput->isOpen() &&
+                          m_vehicleInput->sampleAt(m_vehicleInput->nowNs() - m_vehicleLatencyMs * 1000000LL, truth);
+    if (external) {
+        applyVehicleTruth(truth, state);
+        m_frameCache.invalidate(UbxFrameCache::FrameNavPvt);
+    }
+    if (m_errorModel.isEnabled()) {
+        applyErrorModel(state);
+        m_frameCache.invalidate(UbxFrameCache::FrameNavPvt);
+    }
 
-    payload[45] = static_cast<quint8>(ui->sbHwCwSuppression->value());
+    sendUbxFrame(m_epochBuilder.buildNavPvt(state, UbxTime::now()));
+    if (external) {
+        m_vehicleInput->recordDelay(m_vehicleInput->nowNs() - truth.receivedNs);
+    }
+    logEvent(UbxLog::Info, UbxLog::Out, UbxLog::NavPvtSent, {}, UBX_CLASS_NAV, UBX_NAV_PVT);
+    m_telemetry->addNavSolution(state.lat, state.lon, state.speed, state.numSats);
+}
 
-    createUbxPacket(UBX_CLASS_MON, UBX_MON_HW, payload);
-    appendToLog(tr("MON-HW sent: Noise=%1, AGC=%2%, AntStatus=%3, AntPower=%4")
-                    .arg(noise)
-                    .arg(ui->sbHwAgc->value())
-                    .arg(ui->cbHwAntStatus->currentText())
-                    .arg(ui->cbHwAntPower->currentText()),
-                "out");
+void GNSSWindow::createUbxPacket(quint8 msgClass, quint8 msgId, const QByteArray &payload) {
+    char *out = m_packetArena.beginFrame(msgClass, msgId, payload.size());
+    memcpy(out, payload.constData(), payload.size());
+    sendUbxFrame(m_packetArena.finishFrame());
 }
 
-void GNSSWindow::sendUbxNavPvt() {
-    QByteArray payload(92, 0x00);
-    QDateTime currentTime = QDateTime::currentDateTime();
-    quint32 iTOW = static_cast<quint32>(currentTime.toMSecsSinceEpoch() % (7 * 24 * 60 * 60 * 1000));
-
-    qint32 lat = static_cast<qint32>(ui->dsbLat->value() * 1e7);
-    qint32 lon = static_cast<qint32>(ui->dsbLon->value() * 1e7);
-    qint32 height = static_cast<qint32>(ui->dsbHeight->value() * 1000);
-    quint32 gSpeed = static_cast<quint32>(ui->dsbSpeed->value() * 1000);
-    quint32 headMot = static_cast<quint32>(ui->dsbHeading->value() * 1e5);
-    quint8 fixType = static_cast<quint8>(ui->sbNumSats->value() > 0 ? 3 : 0);
-    quint8 numSV = static_cast<quint8>(ui->sbNumSats->value());
-    qint32 velN = static_cast<qint32>(ui->dsbVelN->value() * 1000);
-    qint32 velE = static_cast<qint32>(ui->dsbVelE->value() * 1000);
-    qint32 velD = static_cast<qint32>(ui->dsbVelU->value() * 1000);
-    quint32 hAcc = static_cast<quint32>(ui->dsbRmsPos->value() * 1000);
-    quint32 vAcc = static_cast<quint32>(ui->dsbRmsPos->value() * 1000);
-    quint32 sAcc = static_cast<quint32>(ui->dsbRmsVel->value() * 1000);
-    quint16 pDOP = static_cast<quint16>(ui->dsbPdop->value() * 100);
-
-    qToLittleEndian<quint32>(iTOW, payload.data()); // iTOW
-    qToLittleEndian<quint16>(currentTime.date().year(), payload.data() + 4);
-    payload[6] = static_cast<quint8>(currentTime.date().month());
-    payload[7] = static_cast<quint8>(currentTime.date().day());
-    payload[8] = static_cast<quint8>(currentTime.time().hour());
-    payload[9] = static_cast<quint8>(currentTime.time().minute());
-    payload[10] = static_cast<quint8>(currentTime.time().second());
-    payload[11] = 0x07; // valid: date, time, fully resolved
-
-    qToLittleEndian<qint32>(lat, payload.data() + 24); // lon
-    qToLittleEndian<qint32>(lon, payload.data() + 28); // lat
-    qToLittleEndian<qint32>(height, payload.data() + 32); // height
-    qToLittleEndian<qint32>(velN, payload.data() + 48); // velN
-    qToLittleEndian<qint32>(velE, payload.data() + 52); // velE
-    qToLittleEndian<qint32>(velD, payload.data() + 56); // velD
-    qToLittleEndian<quint32>(gSpeed, payload.data() + 60); // gSpeed
-    qToLittleEndian<quint32>(headMot, payload.data() + 64); // headMot
-    qToLittleEndian<quint32>(hAcc, payload.data() + 40); // hAcc
-    qToLittleEndian<quint32>(vAcc, payload.data() + 44); // vAcc
-    qToLittleEndian<quint32>(sAcc, payload.data() + 72); // sAcc
-    qToLittleEndian<quint16>(pDOP, payload.data() + 80); // pDOP
-    payload[20] = fixType; // fixType
-    payload[23] = numSV;   // numSV
-
-    createUbxPacket(UBX_CLASS_NAV, UBX_NAV_PVT, payload);
-    appendToLog(tr("Sent NAV-PVT"), "out");
+void GNSSWindow::sendUbxFrame(const QByteArray &packet) {
+    UbxPacketArena::Frame frame;
+    frame.data = packet.constData();
+    frame.size = packet.size();
+    sendUbxFrame(frame);
 }
 
-void GNSSWindow::createUbxPacket(quint8 msgClass, quint8 msgId, const QByteArray &payload) {
-    if (!m_socket) {
-        appendToLog(tr("Error: Socket not initialized"), "error");
+void GNSSWindow::sendUbxFrame(const UbxPacketArena::Frame &frame) {
+    if (!m_transport) {
+        appendToLog(tr("Error: Transport not initialized"), "error");
         return;
     }
 
-    if (m_socket->state() != QAbstractSocket::ConnectedState) {
-        appendToLog(tr("Error: Socket not connected (state: %1)").arg(m_socket->state()), "error");
+    if (!m_transport->isOpen()) {
+        appendToLog(tr("Error: Transport not open (%1)").arg(m_transport->description()), "error");
         return;
     }
 
-    QByteArray packet;
-    packet.append('\xB5'); // Sync char 1
-    packet.append('\x62'); // Sync char 2
-    packet.append(static_cast<char>(msgClass));
-    packet.append(static_cast<char>(msgId));
+    const quint8 msgClass = static_cast<quint8>(frame.data[2]);
+    const quint8 msgId = static_cast<quint8>(frame.data[3]);
+    const quint16 length = static_cast<quint16>(frame.size - 8);
+    const quint8 ck_a = static_cast<quint8>(frame.data[frame.size - 2]);
+    const quint8 ck_b = static_cast<quint8>(frame.data[frame.size - 1]);
+
+    logEvent(UbxLog::Debug, UbxLog::Out, UbxLog::FrameSent,
+             { UbxLog::hex(msgClass), UbxLog::hex(msgId), UbxLog::num(length),
+               UbxLog::hex(ck_a), UbxLog::hex(ck_b) }, msgClass, msgId);
 
-    quint16 length = payload.size();
-    packet.append(static_cast<char>(length & 0xFF));
-    packet.append(static_cast<char>((length >> 8) & 0xFF));
-    packet.append(payload);
+    if (m_faults->isEnabled()) {
+        m_faults->process(frame.data, frame.size);
+    } else {
+        writeFrame(frame.data, frame.size);
+    }
+}
 
-    quint8 ck_a = 0, ck_b = 0;
-    for (int i = 2; i < packet.size(); i++) {
-        quint8 byte = static_cast<quint8>(packet[i]);
-        ck_a += byte;
-        ck_b += ck_a;
+// Last stage before the link, also the sink of the fault injector
+void GNSSWindow::writeFrame(const char *data, int size) {
+    if (!m_transport || !m_transport->isOpen()) {
+        return;
     }
-    packet.append(ck_a);
-    packet.append(ck_b);
 
-    appendToLog(tr("UBX Packet: Class=0x%1, ID=0x%2, Length=%3, Checksum=0x%4 0x%5")
-                    .arg(msgClass, 2, 16, QLatin1Char('0'))
-                    .arg(msgId, 2, 16, QLatin1Char('0'))
-                    .arg(length)
-                    .arg(ck_a, 2, 16, QLatin1Char('0'))
-                    .arg(ck_b, 2, 16, QLatin1Char('0')), "debug");
+    const quint8 msgClass = size > 3 ? static_cast<quint8>(data[2]) : 0;
+    const quint8 msgId = size > 3 ? static_cast<quint8>(data[3]) : 0;
 
-    qint64 bytesWritten = m_socket->write(packet);
+    qint64 bytesWritten = m_transport->write(data, size);
     if (bytesWritten == -1) {
-        appendToLog(tr("Write error: %1").arg(m_socket->errorString()), "error");
-    } else if (bytesWritten != packet.size()) {
-        appendToLog(tr("Partial write: %1/%2 bytes").arg(bytesWritten).arg(packet.size()), "warning");
+        logEvent(UbxLog::Error, UbxLog::NoDirection, UbxLog::WriteError,
+                 { UbxLog::text() }, msgClass, msgId, m_transport->errorString());
+    } else if (bytesWritten == 0) {
+        logEvent(UbxLog::Warning, UbxLog::NoDirection, UbxLog::FrameDropped, {}, msgClass, msgId);
+    } else if (bytesWritten != size) {
+        logEvent(UbxLog::Warning, UbxLog::NoDirection, UbxLog::PartialWrite,
+                 { UbxLog::num(bytesWritten), UbxLog::num(size) }, msgClass, msgId);
     } else {
-        appendToLog(tr("Successfully sent %1 bytes").arg(bytesWritten), "debug");
+        logEvent(UbxLog::Debug, UbxLog::Out, UbxLog::FrameWritten,
+                 { UbxLog::num(bytesWritten) }, msgClass, msgId);
+        m_telemetry->addFrameSent(msgClass, msgId);
     }
 
-    if (!m_socket->flush()) {
-        appendToLog(tr("Flush failed: %1").arg(m_socket->errorString()), "warning");
+    if (!m_transport->flush()) {
+        logEvent(UbxLog::Warning, UbxLog::NoDirection, UbxLog::FlushFailed,
+                 { UbxLog::text() }, msgClass, msgId, m_transport->errorString());
     }
 }
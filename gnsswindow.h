@@ -2,17 +2,40 @@
 #define GNSSWINDOW_H
 
 #include <QMainWindow>
-#include <QTcpSocket>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QStandardItemModel>
 #include <QLabel>
 #include <QMessageBox>
 #include <QMap>
+#include <functional>
 #include "ubxparser.h"
+#include "ubxframecache.h"
+#include "ubxpacketarena.h"
+#include "ubxepochbuilder.h"
+#include "ubxtransport.h"
+#include "ubxbandwidthplanner.h"
+#include "ubxlog.h"
+#include "ubxlogjournal.h"
+#include "ubxlogfiltermodel.h"
+#include "telemetrydock.h"
+#include "uipresenter.h"
+#include "ubxconfigdb.h"
+#include "ubxratetable.h"
+#include "simstate.h"
+#include "rfscenario.h"
+#include "ubxfaultinjector.h"
+#include "ubxframer.h"
+#include "vehicleinput.h"
+#include "gnsserrormodel.h"
 #include "qcustomplot.h"
-#include <QAbstractSocket>
 
 class Dialog;
+class QAction;
+class QCheckBox;
+class QComboBox;
+class QLineEdit;
+class QSpinBox;
 
 namespace Ui {
 class GNSSWindow;
@@ -25,7 +48,7 @@ public:
     explicit GNSSWindow(Dialog* parentDialog = nullptr, QWidget *parent = nullptr);
     ~GNSSWindow();
     void sendUbxCfgPrtResponse();
-    void setSocket(QTcpSocket *socket);
+    void setTransport(UbxTransport *transport);
     void setReceiveBuffer(QByteArray *receiveBuffer);
     void onConnectionStatusChanged(bool connected);
 
@@ -38,8 +61,6 @@ private slots:
     void onActionLoadSettingsTriggered();
     void handleInitTimeout();
     void handleAckTimeout();
-    void handleSocketDisconnected();
-    void handleSocketError(QAbstractSocket::SocketError error);
     void updateAvailableIds();
     void on_btnClearLog_clicked();
     void onReadyRead();
@@ -56,7 +77,7 @@ private slots:
     void pauseLog(bool paused);
     void sendUbxCfgMsg(quint8 msgClass, quint8 msgId, quint8 rate);
     void sendUbxSecUniqidReq();
-    void onError(QAbstractSocket::SocketError error);
+    void onError(const QString &message);
     void onActionSaveLogTriggered();
     void onActionClearLogTriggered();
     void onActionAboutTriggered();
@@ -88,13 +109,12 @@ signals:
 private:
     Dialog* m_parentDialog;
     Ui::GNSSWindow *ui;
-    QTimer *m_pvtTimer;
-    QTimer *m_statusTimer;
+    QTimer *m_epochTimer;
     QTimer *m_ackTimeoutTimer;
     bool m_waitingForAck = false;
     QTimer *m_initTimer;
     float m_protocolVersion = 0.0f;
-    QTcpSocket *m_socket;
+    UbxTransport *m_transport;
     QTimer *m_timer;
     UbxParser m_ubxParser;
     QMap<quint8, QMap<int, QString>> m_classIdMap;
@@ -110,6 +130,7 @@ private:
     QString processSecMessages(quint8 msgId, const QByteArray& payload);
     void processInfMessages(quint8 msgId, const QByteArray& payload);
     QByteArray *m_receiveBuffer;
+    UbxFramer m_framer;
     void processBuffer();
     void setupMonRfFields();
     void displayMonRf(const UbxParser::MonRf &data);
@@ -155,6 +176,21 @@ private:
     void setupConnections();
     void processCfgValGet(const QByteArray &payload);
     void processCfgValSet(const QByteArray &payload);
+    void processCfgValDel(const QByteArray &payload);
+    void applyConfigValue(quint32 id, quint64 value);
+    void processCfgMsg(const QByteArray &payload);
+    UbxRateTable m_rateTable;
+    int m_outputPort = UbxRateTable::Uart1;
+    quint32 m_epoch = 0;
+    void onNavigationEpoch();
+    void updateEpochTimer();
+    void setOutputRate(int output, quint8 rate);
+    quint8 autoSendRate(int output) const;
+    QCheckBox *autoSendCheckFor(int output) const;
+    UbxConfigDb m_configDb;
+    quint64 m_configStoreId = 0;
+    bool m_configStoreOpen = false;
+    void openConfigStore();
     void registerHandlers();
     void initClassIdMapping();
     void processUbxMessage(quint8 msgClass, quint8 msgId, const QByteArray& payload);
@@ -162,8 +198,72 @@ private:
     void displayNavPvt(const UbxParser::NavPvt &data);
     void displayNavStatus(const UbxParser::NavStatus &data);
     void displayCfgPrt(const UbxParser::CfgPrt &data);
+    void applyCfgPrt(const UbxParser::CfgPrt &data);
+    UbxParser::CfgPrt m_portConfig{};
+    bool m_portConfigChanged = false;
+    UiPresenter *m_presenter = nullptr;
     void displayMonVer(const UbxParser::MonVer &data);
     void createUbxPacket(quint8 msgClass, quint8 msgId, const QByteArray &payload);
+    void sendUbxFrame(const QByteArray &packet);
+    void sendUbxFrame(const UbxPacketArena::Frame &frame);
+    void writeFrame(const char *data, int size);
+    UbxFaultInjector *m_faults = nullptr;
+    QAction *m_stopFaultsAction = nullptr;
+    void loadFaultConfig();
+    void stopFaults();
+    UbxFrameCache m_frameCache;
+    UbxPacketArena m_packetArena;
+    UbxEpochBuilder m_epochBuilder{m_packetArena, m_frameCache};
+    void setupFrameCacheInvalidation();
+    void setupSimStatePublishing();
+    void publishSimState();
+    void connectEdited(QWidget *widget, const std::function<void()> &handler);
+    SimStateBuffer m_simState;
+    RfScenario m_rfScenario;
+    QElapsedTimer m_rfScenarioClock;
+    QAction *m_stopRfScenarioAction = nullptr;
+    void loadRfScenario();
+    void stopRfScenario();
+    VehicleInput *m_vehicleInput = nullptr;
+    QAction *m_stopVehicleInputAction = nullptr;
+    int m_vehicleLatencyMs = 0;
+    int m_vehicleReportTicks = 0;
+    void loadVehicleInput();
+    void stopVehicleInput();
+    void reportVehicleInput();
+    void applyVehicleTruth(const VehicleInput::Sample &truth, SimState &state);
+    GnssErrorModel m_errorModel;
+    QElapsedTimer m_errorModelClock;
+    QAction *m_stopErrorModelAction = nullptr;
+    void loadErrorModel();
+    void stopErrorModel();
+    void applyErrorModel(SimState &state);
+    UbxBandwidthPlanner m_bandwidthPlanner;
+    QLabel *m_bandwidthLabel = nullptr;
+    bool m_bandwidthOversubscribed = false;
+    bool m_bandwidthBurstOverflow = false;
+    void updateBandwidthBudget();
+    UbxLog::Ring m_logRing;
+    QVector<UbxLog::Record> m_logBatch;
+    QTimer *m_logDrainTimer = nullptr;
+    UbxLogJournal *m_logJournal = nullptr;
+    static const int LogViewMaxLines = 5000;
+    UbxLogIndex m_logIndex;
+    UbxLogFilterModel *m_logFilterModel = nullptr;
+    QComboBox *m_logFilterClass = nullptr;
+    QLineEdit *m_logFilterId = nullptr;
+    QComboBox *m_logFilterDirection = nullptr;
+    QComboBox *m_logFilterLevel = nullptr;
+    QSpinBox *m_logFilterMinutes = nullptr;
+    void setupLogSearch();
+    void applyLogFilter();
+    void setLogFilterControls(const UbxLogIndex::Filter &filter);
+    TelemetryDock *m_telemetry = nullptr;
+    bool isLogPaused() const;
+    void logEvent(UbxLog::Level level, UbxLog::Direction direction, UbxLog::Template templateId,
+                  std::initializer_list<UbxLog::Arg> args = {}, quint8 msgClass = 0, quint8 msgId = 0,
+                  const QString &text = QString());
+    void drainLog();
     QString getMessageName(quint8 msgClass, quint8 msgId);
     void saveSettings(const QString &filename);
     void loadSettings(const QString &filename);
@@ -1,12 +1,33 @@
 #include "dialog.h"
+#include "receiverswarm.h"
 #include <QApplication>
 #include <QTranslator>
 #include <QLocale>
 #include <QFile>
 #include <QDir>
 #include <QLibraryInfo>
+#include <cstring>
+
+// ImitatorGNSS --swarm swarm.json runs the receivers without any window
+static int runSwarm(int argc, char *argv[], const char *configFile) {
+    QCoreApplication app(argc, argv);
+
+    ReceiverSwarm swarm;
+    if (!swarm.load(QString::fromLocal8Bit(configFile))) {
+        qCritical().noquote() << "Swarm configuration:" << swarm.errorString();
+        return 1;
+    }
+    swarm.start();
+    return app.exec();
+}
 
 int main(int argc, char *argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--swarm") == 0) {
+            return runSwarm(argc, argv, argv[i + 1]);
+        }
+    }
+
     QApplication app(argc, argv);
 
     QTranslator translator;
@@ -0,0 +1,34 @@
+#include "normalblocksampler.h"
+
+#include <cmath>
+
+void NormalBlockSampler::reseed(quint64 seed) {
+    m_engine.seed(seed);
+    m_next = BlockSize;
+}
+
+void NormalBlockSampler::refill() {
+    const int half = BlockSize / 2;
+    double u1[half];
+    double u2[half];
+
+    // 53-bit uniforms in (0, 1], so log() never sees zero
+    for (int i = 0; i < half; i++) {
+        u1[i] = ((m_engine() >> 11) + 1) * (1.0 / 9007199254740992.0);
+        u2[i] = (m_engine() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Separate passes, otherwise sin and cos fuse into sincos, which has
+    // no vector variant
+    for (int i = 0; i < half; i++) {
+        u1[i] = std::sqrt(-2.0 * std::log(u1[i]));
+        u2[i] *= 6.283185307179586;
+    }
+    for (int i = 0; i < half; i++) {
+        m_block[i] = u1[i] * std::cos(u2[i]);
+    }
+    for (int i = 0; i < half; i++) {
+        m_block[half + i] = u1[i] * std::sin(u2[i]);
+    }
+    m_next = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef NORMAL_BLOCK_SAMPLER_H
+#define NORMAL_BLOCK_SAMPLER_H
+
+#include <QtGlobal>
+#include <random>
+
+// Standard normal variates made a block at a time. The Box-Muller passes
+// run over plain arrays with no branches, so GCC vectorizes them with the
+// SIMD log/sin/cos of libmvec. That takes -ffast-math, which CMake applies
+// to normalblocksampler.cpp only; keep anything else out of that file.
+// Drawing from the block is then one load.
+class NormalBlockSampler {
+public:
+    static const int BlockSize = 256;
+
+    explicit NormalBlockSampler(quint64 seed = 1) { reseed(seed); }
+
+    void reseed(quint64 seed);
+    double next() {
+        if (m_next == BlockSize) {
+            refill();
+        }
+        return m_block[m_next++];
+    }
+
+private:
+    void refill();
+
+    std::mt19937_64 m_engine;
+    double m_block[BlockSize];
+    int m_next = BlockSize;
+};
+
+#endif // NORMAL_BLOCK_SAMPLER_H
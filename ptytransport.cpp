@@ -0,0 +1,202 @@
+#include "ptytransport.h"
+
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(Q_OS_MACOS) || defined(Q_OS_FREEBSD)
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+#endif
+
+PtyTransport::PtyTransport(QObject *parent)
+    : UbxTransport(parent), m_pacingTimer(new QTimer(this)) {
+    m_pacingTimer->setTimerType(Qt::PreciseTimer);
+    m_pacingTimer->setInterval(PacingIntervalMs);
+    connect(m_pacingTimer, &QTimer::timeout, this, &PtyTransport::drain);
+    m_txQueue.reserve(TxQueueCapacity);
+}
+
+PtyTransport::~PtyTransport() {
+    close();
+}
+
+void PtyTransport::setError(const QString &message) {
+    m_errorString = message;
+    emit errorOccurred(message);
+}
+
+void PtyTransport::open() {
+#ifdef Q_OS_UNIX
+    if (isOpen()) {
+        return;
+    }
+
+    char name[256] = {};
+    if (::openpty(&m_master, &m_slave, name, nullptr, nullptr) != 0) {
+        setError(tr("openpty failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        return;
+    }
+
+    // Raw slave so UBX bytes pass through the line discipline untouched
+    termios tio;
+    if (tcgetattr(m_slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(m_slave, TCSANOW, &tio);
+    }
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+    m_slavePath = QString::fromLocal8Bit(name);
+
+    // The slave fd stays open so the master does not see EIO while the
+    // consumer reopens the device
+    m_readNotifier = new QSocketNotifier(m_master, QSocketNotifier::Read, this);
+    connect(m_readNotifier, &QSocketNotifier::activated, this, &UbxTransport::readyRead);
+
+    m_txQueue.clear();
+    m_txHead = 0;
+    emit opened();
+#else
+    setError(tr("Pseudo-terminals are not supported on this platform"));
+#endif
+}
+
+void PtyTransport::close() {
+#ifdef Q_OS_UNIX
+    if (!isOpen()) {
+        return;
+    }
+
+    m_pacingTimer->stop();
+    delete m_readNotifier;
+    m_readNotifier = nullptr;
+    ::close(m_master);
+    ::close(m_slave);
+    m_master = -1;
+    m_slave = -1;
+    m_txQueue.clear();
+    m_txHead = 0;
+    emit closed();
+#endif
+}
+
+bool PtyTransport::isOpen() const {
+    return m_master >= 0;
+}
+
+qint64 PtyTransport::write(const char *data, qint64 size) {
+    if (!isOpen()) {
+        return -1;
+    }
+
+    // Compact the consumed prefix before appending
+    if (m_txHead > 0) {
+        m_txQueue.remove(0, m_txHead);
+        m_txHead = 0;
+    }
+
+    if (m_txQueue.size() + size > TxQueueCapacity) {
+        m_overruns++;
+        m_droppedBytes += size;
+        return 0;
+    }
+
+    if (m_txQueue.isEmpty()) {
+        m_pacingClock.start();
+        m_bytesSinceClock = 0;
+    }
+    m_txQueue.append(data, size);
+
+    const double bytesPerSecond = qMax<quint32>(1, m_baudRate / 10);
+    m_lastQueueDelayMs = queuedBytes() * 1000.0 / bytesPerSecond;
+    m_maxQueueDelayMs = qMax(m_maxQueueDelayMs, m_lastQueueDelayMs);
+
+    if (!m_pacingTimer->isActive()) {
+        m_pacingTimer->start();
+    }
+    return size;
+}
+
+void PtyTransport::drain() {
+#ifdef Q_OS_UNIX
+    const qint64 bytesPerSecond = qMax<qint64>(1, m_baudRate / 10);
+    const qint64 allowed = m_pacingClock.nsecsElapsed() * bytesPerSecond / 1000000000LL;
+
+    // Time the reader stalled (EAGAIN) or a tick came late is not made up
+    // later as a burst above the baud rate: at most one tick accrues
+    const qint64 tickBytes = (bytesPerSecond * PacingIntervalMs + 999) / 1000;
+    m_bytesSinceClock = qMax(m_bytesSinceClock, allowed - tickBytes);
+    qint64 budget = qMin<qint64>(allowed - m_bytesSinceClock, queuedBytes());
+
+    if (budget > 0) {
+        const ssize_t written = ::write(m_master, m_txQueue.constData() + m_txHead, budget);
+        if (written > 0) {
+            m_txHead += written;
+            m_bytesSinceClock += written;
+        } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            setError(tr("PTY write failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        }
+        // EAGAIN: the kernel buffer is full because nobody reads the slave,
+        // the queue then fills up and frames start to drop
+    }
+
+    if (queuedBytes() == 0) {
+        m_txQueue.clear();
+        m_txHead = 0;
+        m_pacingTimer->stop();
+    }
+#endif
+}
+
+void PtyTransport::resetStatistics() {
+    m_overruns = 0;
+    m_droppedBytes = 0;
+    m_lastQueueDelayMs = 0.0;
+    m_maxQueueDelayMs = 0.0;
+}
+
+QByteArray PtyTransport::readAll() {
+    QByteArray data;
+#ifdef Q_OS_UNIX
+    char chunk[1024];
+    ssize_t n;
+    while (isOpen() && (n = ::read(m_master, chunk, sizeof(chunk))) > 0) {
+        data.append(chunk, static_cast<int>(n));
+    }
+#endif
+    return data;
+}
+
+QString PtyTransport::errorString() const {
+    return m_errorString;
+}
+
+QString PtyTransport::description() const {
+    return tr("PTY %1 @ %2 baud").arg(m_slavePath).arg(m_baudRate);
+}
+
+void PtyTransport::setBaudRate(quint32 baudRate) {
+    if (baudRate == 0 || baudRate == m_baudRate) {
+        return;
+    }
+    m_baudRate = baudRate;
+    m_pacingClock.start();
+    m_bytesSinceClock = 0;
+
+#ifdef Q_OS_UNIX
+    // Mirror the rate on the slave so stty and the consumer see it too
+    if (m_slave >= 0) {
+        termios tio;
+        if (tcgetattr(m_slave, &tio) == 0) {
+            cfsetspeed(&tio, baudRate);
+            tcsetattr(m_slave, TCSANOW, &tio);
+        }
+    }
+#endif
+}
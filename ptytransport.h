@@ -0,0 +1,70 @@
+#ifndef UBX_PTY_TRANSPORT_H
+#define UBX_PTY_TRANSPORT_H
+
+#include "ubxtransport.h"
+
+#include <QElapsedTimer>
+
+class QSocketNotifier;
+class QTimer;
+
+// Pseudo-terminal backend. The autopilot (or a test) opens the slave side
+// like a real UART; bytes leave the master no faster than the configured
+// baud rate allows (10 bit times per byte, 8N1). Frames that do not fit in
+// the transmit queue are dropped whole and counted as overruns, the way a
+// receiver with a full UART buffer loses messages.
+class PtyTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    explicit PtyTransport(QObject *parent = nullptr);
+    ~PtyTransport() override;
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+
+    void setBaudRate(quint32 baudRate) override;
+    quint32 baudRate() const { return m_baudRate; }
+
+    QString slavePath() const { return m_slavePath; }
+    int queuedBytes() const { return m_txQueue.size() - m_txHead; }
+    quint64 overrunCount() const { return m_overruns; }
+    quint64 droppedBytes() const { return m_droppedBytes; }
+
+    // Time the last accepted frame waits in the queue before its final byte
+    // leaves the line, and the worst such delay since resetStatistics()
+    double lastQueueDelayMs() const { return m_lastQueueDelayMs; }
+    double maxQueueDelayMs() const { return m_maxQueueDelayMs; }
+    void resetStatistics();
+
+    static const int TxQueueCapacity = 4096;
+    static const int PacingIntervalMs = 1;
+
+private:
+    void drain();
+    void setError(const QString &message);
+
+    int m_master = -1;
+    int m_slave = -1;
+    QString m_slavePath;
+    QString m_errorString;
+    QSocketNotifier *m_readNotifier = nullptr;
+    QTimer *m_pacingTimer;
+    QElapsedTimer m_pacingClock;
+    qint64 m_bytesSinceClock = 0;
+    quint32 m_baudRate = 9600;
+
+    QByteArray m_txQueue;
+    int m_txHead = 0;
+    quint64 m_overruns = 0;
+    quint64 m_droppedBytes = 0;
+    double m_lastQueueDelayMs = 0.0;
+    double m_maxQueueDelayMs = 0.0;
+};
+
+#endif // UBX_PTY_TRANSPORT_H
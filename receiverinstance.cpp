@@ -0,0 +1,229 @@
+#include "receiverinstance.h"
+#include "ubxdefs.h"
+
+#include <QCoreApplication>
+#include <QtEndian>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+const double MetersPerDegree = 111320.0;
+
+const char *const s_transportNames[] = {
+    "tcp-client", "tcp-server", "udp", "pty", "shm", "udp-fanout"
+};
+
+} // namespace
+
+static_assert(Constellation::MaxSatellites <= 255, "NAV-SAT numSvs is one byte");
+
+bool ReceiverInstance::Config::fromJson(const QJsonObject &json, Config &config, QString &error) {
+    Config result;
+    result.name = json["name"].toString();
+
+    bool ok = false;
+    result.uniqueId = json["uniqueId"].toString().toULongLong(&ok, 16);
+    if (!ok || result.uniqueId > 0xFFFFFFFFFFULL) {
+        error = QCoreApplication::translate("ReceiverInstance", "%1: uniqueId must be a 40-bit hex number")
+                    .arg(result.name);
+        return false;
+    }
+
+    const QString transport = json["transport"].toString(s_transportNames[UbxTransport::Udp]);
+    int kind = -1;
+    for (int i = 0; i < int(sizeof(s_transportNames) / sizeof(s_transportNames[0])); i++) {
+        if (transport == QLatin1String(s_transportNames[i])) {
+            kind = i;
+        }
+    }
+    const int port = json["port"].toInt(0);
+    if (kind < 0 || (kind != UbxTransport::Pty && (port <= 0 || port > 65535))) {
+        error = QCoreApplication::translate("ReceiverInstance", "%1: unknown transport \"%2\" or bad port")
+                    .arg(result.name, transport);
+        return false;
+    }
+    result.transport = static_cast<UbxTransport::Kind>(kind);
+    result.host = json["host"].toString(result.host);
+    result.port = static_cast<quint16>(port);
+
+    result.lat = json["lat"].toDouble(result.lat);
+    result.lon = json["lon"].toDouble(result.lon);
+    result.height = json["height"].toDouble(result.height);
+    result.velN = json["velN"].toDouble(result.velN);
+    result.velE = json["velE"].toDouble(result.velE);
+    result.velU = json["velU"].toDouble(result.velU);
+    result.rmsPos = json["rmsPos"].toDouble(result.rmsPos);
+    result.rmsVel = json["rmsVel"].toDouble(result.rmsVel);
+    result.elevationMask = json["elevationMask"].toDouble(result.elevationMask);
+
+    if (json.contains("errors")) {
+        QString errorsError;
+        if (!GnssErrorModel::Config::fromJson(json["errors"].toObject(), result.errors, errorsError)) {
+            error = QString("%1: %2").arg(result.name, errorsError);
+            return false;
+        }
+    }
+
+    config = result;
+    return true;
+}
+
+ReceiverInstance::ReceiverInstance(const Config &config)
+    : m_config(config),
+      m_transport(UbxTransport::create(config.transport, config.host, config.port)),
+      m_arena(EpochBytes),
+      m_lat(config.lat),
+      m_lon(config.lon),
+      m_height(config.height) {
+    m_errorModel.setConfig(config.errors);
+
+    // Input from the autopilot is not interpreted, only drained
+    UbxTransport *transport = m_transport;
+    QObject::connect(transport, &UbxTransport::readyRead, transport, [transport] { transport->readAll(); });
+}
+
+ReceiverInstance::~ReceiverInstance() {
+    delete m_transport;
+}
+
+void ReceiverInstance::open() {
+    m_epochsBuilt = 0;
+    m_transport->open();
+}
+
+void ReceiverInstance::close() {
+    m_transport->close();
+}
+
+void ReceiverInstance::buildEpoch(const Constellation::Snapshot &snapshot, double dt) {
+    m_arena.reset();
+    m_frameCount = 0;
+    m_epoch = snapshot.epoch;
+
+    // Dead reckoning along the configured velocity
+    m_lat += m_config.velN * dt / MetersPerDegree;
+    m_lon += m_config.velE * dt / (MetersPerDegree * qMax(1e-6, qCos(qDegreesToRadians(m_lat))));
+    m_height += m_config.velU * dt;
+
+    m_reportedLat = m_lat;
+    m_reportedLon = m_lon;
+    m_reportedHeight = m_height;
+    m_reportedVel[0] = m_config.velN;
+    m_reportedVel[1] = m_config.velE;
+    m_reportedVel[2] = m_config.velU;
+    m_hAcc = m_config.rmsPos;
+    m_vAcc = m_config.rmsPos;
+    m_sAcc = m_config.rmsVel;
+
+    if (m_errorModel.isEnabled()) {
+        const GnssErrorModel::Output error = m_errorModel.step(dt, m_config.rmsPos, m_config.rmsVel);
+        m_reportedLat += error.position[GnssErrorModel::North] / MetersPerDegree;
+        m_reportedLon += error.position[GnssErrorModel::East] /
+                         (MetersPerDegree * qMax(1e-6, qCos(qDegreesToRadians(m_lat))));
+        m_reportedHeight += error.position[GnssErrorModel::Up];
+        for (int axis = 0; axis < GnssErrorModel::AxisCount; axis++) {
+            m_reportedVel[axis] += error.velocity[axis];
+        }
+        m_hAcc = error.hAcc;
+        m_vAcc = error.vAcc;
+        m_sAcc = error.sAcc;
+    }
+
+    m_visible = Constellation::visible(snapshot, m_lat, m_lon, m_height, m_config.elevationMask, m_look);
+
+    static_assert(MaxFrames >= 3, "An epoch holds NAV-PVT, NAV-SAT and SEC-UNIQID");
+
+    buildNavPvt(snapshot);
+    buildNavSat(snapshot);
+    if (m_epochsBuilt++ % UniqidInterval == 0) {
+        buildSecUniqid();
+    }
+
+    // A rewind would have overwritten frames that flush() still points at
+    Q_ASSERT(m_arena.used() == m_frames[m_frameCount - 1].data - m_frames[0].data + m_frames[m_frameCount - 1].size);
+}
+
+void ReceiverInstance::flush() {
+    if (!m_transport->isOpen() || m_frameCount == 0) {
+        return;
+    }
+
+    m_transport->beginEpoch(m_epoch);
+    for (int i = 0; i < m_frameCount; i++) {
+        m_transport->write(m_frames[i].data, m_frames[i].size);
+    }
+    m_transport->endEpoch();
+    m_framesWritten += m_frameCount;
+    m_frameCount = 0;
+}
+
+void ReceiverInstance::buildNavPvt(const Constellation::Snapshot &snapshot) {
+    char *payload = m_arena.beginFrame(UBX_CLASS_NAV, UBX_NAV_PVT, 92);
+    const int numSV = qMin(m_visible, 255);
+    const double speed = std::hypot(m_reportedVel[0], m_reportedVel[1]);
+    const double heading = std::fmod(qRadiansToDegrees(std::atan2(m_reportedVel[1], m_reportedVel[0])) + 360.0, 360.0);
+
+    qToLittleEndian<quint32>(snapshot.iTOW, payload); // iTOW
+    qToLittleEndian<quint16>(snapshot.year, payload + 4);
+    payload[6] = static_cast<char>(snapshot.month);
+    payload[7] = static_cast<char>(snapshot.day);
+    payload[8] = static_cast<char>(snapshot.hour);
+    payload[9] = static_cast<char>(snapshot.minute);
+    payload[10] = static_cast<char>(snapshot.second);
+    payload[11] = 0x07; // valid: date, time, fully resolved
+    payload[20] = static_cast<char>(numSV >= 4 ? 3 : 0); // fixType
+    payload[21] = static_cast<char>(numSV >= 4 ? 0x01 : 0x00); // flags: gnssFixOK
+    payload[23] = static_cast<char>(numSV); // numSV
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedLon * 1e7), payload + 24); // lon
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedLat * 1e7), payload + 28); // lat
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedHeight * 1000), payload + 32); // height
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedHeight * 1000), payload + 36); // hMSL, no geoid model
+    qToLittleEndian<quint32>(static_cast<quint32>(m_hAcc * 1000), payload + 40); // hAcc
+    qToLittleEndian<quint32>(static_cast<quint32>(m_vAcc * 1000), payload + 44); // vAcc
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedVel[0] * 1000), payload + 48); // velN
+    qToLittleEndian<qint32>(static_cast<qint32>(m_reportedVel[1] * 1000), payload + 52); // velE
+    qToLittleEndian<qint32>(static_cast<qint32>(-m_reportedVel[2] * 1000), payload + 56); // velD
+    qToLittleEndian<quint32>(static_cast<quint32>(speed * 1000), payload + 60); // gSpeed
+    qToLittleEndian<quint32>(static_cast<quint32>(heading * 1e5), payload + 64); // headMot
+    qToLittleEndian<quint32>(static_cast<quint32>(m_sAcc * 1000), payload + 68); // sAcc
+
+    // Rough PDOP from the number of satellites in view
+    const double pdop = numSV >= 4 ? 6.0 / std::sqrt(double(numSV)) : 99.99;
+    qToLittleEndian<quint16>(static_cast<quint16>(pdop * 100), payload + 76); // pDOP
+
+    m_frames[m_frameCount++] = m_arena.finishFrame();
+}
+
+void ReceiverInstance::buildNavSat(const Constellation::Snapshot &snapshot) {
+    char *payload = m_arena.beginFrame(UBX_CLASS_NAV, UBX_NAV_SAT, 8 + 12 * m_visible);
+
+    qToLittleEndian<quint32>(snapshot.iTOW, payload); // iTOW
+    payload[4] = 1; // version
+    payload[5] = static_cast<char>(m_visible); // numSvs
+
+    // qualityInd 7, svUsed, healthy, ephemeris orbit with ephAvail
+    const quint32 flags = 0x07 | (1 << 3) | (1 << 4) | (1 << 8) | (1 << 11);
+    for (int i = 0; i < m_visible; i++) {
+        const Constellation::LookAngle &look = m_look[i];
+        const Constellation::Satellite &sv = snapshot.satellites[look.index];
+        char *sat = payload + 8 + 12 * i;
+        sat[0] = static_cast<char>(sv.gnssId);
+        sat[1] = static_cast<char>(sv.svId);
+        sat[2] = static_cast<char>(qRound(30.0 + 20.0 * std::sin(qDegreesToRadians(look.elevation)))); // cno
+        sat[3] = static_cast<char>(qRound(look.elevation)); // elev
+        qToLittleEndian<qint16>(static_cast<qint16>(qRound(look.azimuth) % 360), sat + 4); // azim
+        qToLittleEndian<quint32>(flags, sat + 8);
+    }
+
+    m_frames[m_frameCount++] = m_arena.finishFrame();
+}
+
+void ReceiverInstance::buildSecUniqid() {
+    char *payload = m_arena.beginFrame(UBX_CLASS_SEC, UBX_SEC_UNIQID, 9);
+    payload[0] = 1; // version
+    for (int i = 0; i < 5; i++) {
+        payload[4 + i] = static_cast<char>((m_config.uniqueId >> (8 * (4 - i))) & 0xFF);
+    }
+    m_frames[m_frameCount++] = m_arena.finishFrame();
+}
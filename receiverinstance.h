@@ -0,0 +1,113 @@
+#ifndef RECEIVER_INSTANCE_H
+#define RECEIVER_INSTANCE_H
+
+#include "constellation.h"
+#include "gnsserrormodel.h"
+#include "ubxpacketarena.h"
+#include "ubxtransport.h"
+
+#include <QJsonObject>
+#include <QString>
+
+// One virtual receiver of a swarm: its own configuration, motion state,
+// error model, SEC-UNIQID and transport. buildEpoch() only touches the
+// instance and the shared snapshot, so different instances can build on
+// different threads; flush() writes through the transport and belongs to
+// the thread that owns it.
+class ReceiverInstance {
+public:
+    struct Config {
+        QString name;
+        quint64 uniqueId = 0;           // SEC-UNIQID, 40 bits
+        UbxTransport::Kind transport = UbxTransport::Udp;
+        QString host = "127.0.0.1";
+        quint16 port = 0;
+        double lat = 0.0;               // deg
+        double lon = 0.0;               // deg
+        double height = 0.0;            // m
+        double velN = 0.0;              // m/s
+        double velE = 0.0;
+        double velU = 0.0;
+        double rmsPos = 1.0;            // m
+        double rmsVel = 0.1;            // m/s
+        double elevationMask = 10.0;    // deg
+        GnssErrorModel::Config errors;
+
+        // {
+        //   "name": "uav-1", "uniqueId": "0x12345678AB",
+        //   "transport": "udp", "host": "127.0.0.1", "port": 41000,
+        //   "lat": 55.75, "lon": 37.62, "height": 150,
+        //   "velN": 0, "velE": 5, "velU": 0,
+        //   "rmsPos": 1.5, "rmsVel": 0.1, "elevationMask": 10,
+        //   "errors": { ...GnssErrorModel... }
+        // }
+        // Transports: tcp-client, tcp-server, udp, pty, shm, udp-fanout
+        static bool fromJson(const QJsonObject &json, Config &config, QString &error);
+    };
+
+    // SEC-UNIQID goes out on the first epoch and then this often
+    static const int UniqidInterval = 10;
+
+    explicit ReceiverInstance(const Config &config);
+    ~ReceiverInstance();
+
+    ReceiverInstance(const ReceiverInstance &) = delete;
+    ReceiverInstance &operator=(const ReceiverInstance &) = delete;
+
+    const Config &config() const { return m_config; }
+    UbxTransport *transport() const { return m_transport; }
+
+    void open();
+    void close();
+
+    // Worker side: moves the receiver on by dt seconds and encodes the
+    // epoch's frames into the instance's arena
+    void buildEpoch(const Constellation::Snapshot &snapshot, double dt);
+
+    // Owning thread: writes the frames built for the epoch
+    void flush();
+
+    int visibleCount() const { return m_visible; }
+    quint64 framesWritten() const { return m_framesWritten; }
+
+private:
+    void buildNavPvt(const Constellation::Snapshot &snapshot);
+    void buildNavSat(const Constellation::Snapshot &snapshot);
+    void buildSecUniqid();
+
+    static const int MaxFrames = 4;
+
+    // One epoch's frames stay in the arena until flush(), so they must all
+    // fit without the arena rewinding: NAV-PVT, NAV-SAT and SEC-UNIQID
+    static const int NavPvtBytes = 8 + 92;
+    static const int NavSatBytes = 8 + 8 + 12 * Constellation::MaxSatellites;
+    static const int SecUniqidBytes = 8 + 9;
+    static const int EpochBytes = NavPvtBytes + NavSatBytes + SecUniqidBytes;
+
+    Config m_config;
+    UbxTransport *m_transport;
+    GnssErrorModel m_errorModel;
+    UbxPacketArena m_arena;
+    UbxPacketArena::Frame m_frames[MaxFrames];
+    int m_frameCount = 0;
+    quint32 m_epoch = 0;
+    quint32 m_epochsBuilt = 0;
+    quint64 m_framesWritten = 0;
+
+    // Truth, then the reported solution of the current epoch
+    double m_lat;
+    double m_lon;
+    double m_height;
+    double m_reportedLat = 0.0;
+    double m_reportedLon = 0.0;
+    double m_reportedHeight = 0.0;
+    double m_reportedVel[3] = {};
+    double m_hAcc = 0.0;
+    double m_vAcc = 0.0;
+    double m_sAcc = 0.0;
+
+    int m_visible = 0;
+    Constellation::LookAngle m_look[Constellation::MaxSatellites];
+};
+
+#endif // RECEIVER_INSTANCE_H
@@ -0,0 +1,210 @@
+#include "receiverswarm.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QTimer>
+#include <QtDebug>
+#include <QtMath>
+
+ReceiverSwarm::ReceiverSwarm(QObject *parent)
+    : QObject(parent), m_epochTimer(new QTimer(this)), m_reportTimer(new QTimer(this)) {
+    m_epochTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_epochTimer, &QTimer::timeout, this, &ReceiverSwarm::runEpoch);
+    connect(m_reportTimer, &QTimer::timeout, this, &ReceiverSwarm::report);
+}
+
+ReceiverSwarm::~ReceiverSwarm() {
+    stop();
+    qDeleteAll(m_receivers);
+}
+
+bool ReceiverSwarm::fail(const QString &error) {
+    m_error = error;
+    qDeleteAll(m_receivers);
+    m_receivers.clear();
+    return false;
+}
+
+bool ReceiverSwarm::load(const QString &fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(file.errorString());
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        return fail(parseError.error != QJsonParseError::NoError ? parseError.errorString()
+                                                                 : tr("Swarm configuration must be a JSON object"));
+    }
+    return configure(doc.object());
+}
+
+bool ReceiverSwarm::configure(const QJsonObject &json) {
+    stop();
+    qDeleteAll(m_receivers);
+    m_receivers.clear();
+
+    m_rateHz = json["rateHz"].toDouble(1.0);
+    if (m_rateHz <= 0 || m_rateHz > 50) {
+        return fail(tr("rateHz must be in 0..50"));
+    }
+
+    const int satellites = json["satellites"].toInt(24);
+    if (satellites < 1 || satellites > Constellation::MaxSatellites) {
+        return fail(tr("satellites must be in 1..%1").arg(Constellation::MaxSatellites));
+    }
+
+    QVector<ReceiverInstance::Config> configs;
+    const QJsonArray receivers = json["receivers"].toArray();
+    for (int i = 0; i < receivers.size(); i++) {
+        ReceiverInstance::Config config;
+        QString error;
+        if (!ReceiverInstance::Config::fromJson(receivers[i].toObject(), config, error)) {
+            return fail(tr("Receiver %1: %2").arg(i + 1).arg(error));
+        }
+        configs.append(config);
+    }
+
+    const QJsonObject generate = json["generate"].toObject();
+    const int count = generate["count"].toInt(0);
+    if (count > 0) {
+        ReceiverInstance::Config base;
+        QString error;
+        if (!ReceiverInstance::Config::fromJson(generate["template"].toObject(), base, error)) {
+            return fail(tr("Receiver template: %1").arg(error));
+        }
+        if (base.transport != UbxTransport::Pty && base.port + count - 1 > 65535) {
+            return fail(tr("Generated receivers run out of ports"));
+        }
+
+        const double spacing = generate["spacing"].toDouble(10.0);
+        const double metersPerDegree = 111320.0 * qMax(1e-6, qCos(qDegreesToRadians(base.lat)));
+        for (int i = 0; i < count; i++) {
+            ReceiverInstance::Config config = base;
+            config.name = QString("%1-%2").arg(base.name).arg(i + 1);
+            config.port = static_cast<quint16>(base.port + i);
+            config.uniqueId = (base.uniqueId + i) & 0xFFFFFFFFFFULL;
+            config.lon = base.lon + spacing * i / metersPerDegree;
+            config.errors.seed = base.errors.seed + static_cast<quint32>(i);
+            configs.append(config);
+        }
+    }
+
+    if (configs.isEmpty()) {
+        return fail(tr("Swarm has no receivers"));
+    }
+
+    // Generated IDs wrap at 40 bits and generated ports may run into
+    // listed ones, so both are checked over the final list
+    QSet<quint64> uniqueIds;
+    QSet<quint16> ports;
+    for (const ReceiverInstance::Config &config : qAsConst(configs)) {
+        if (uniqueIds.contains(config.uniqueId)) {
+            return fail(tr("%1: uniqueId 0x%2 is already used")
+                            .arg(config.name).arg(config.uniqueId, 10, 16, QLatin1Char('0')));
+        }
+        uniqueIds.insert(config.uniqueId);
+
+        if (config.transport == UbxTransport::Pty) {
+            continue;
+        }
+        if (ports.contains(config.port)) {
+            return fail(tr("%1: port %2 is already used").arg(config.name).arg(config.port));
+        }
+        ports.insert(config.port);
+    }
+
+    for (const ReceiverInstance::Config &config : qAsConst(configs)) {
+        m_receivers.append(new ReceiverInstance(config));
+    }
+    m_constellation.reset(new Constellation(satellites));
+    m_pool.reset(new WorkStealingPool(json["threads"].toInt(0)));
+    m_error.clear();
+    return true;
+}
+
+void ReceiverSwarm::start() {
+    if (m_receivers.isEmpty()) {
+        return;
+    }
+
+    for (ReceiverInstance *receiver : qAsConst(m_receivers)) {
+        receiver->open();
+    }
+    m_epoch = 0;
+    m_clock.start();
+    m_lastEpochNs = 0;
+    m_epochTimer->start(qMax(1, qRound(1000.0 / m_rateHz)));
+    m_reportTimer->start(10000);
+    qInfo().noquote() << tr("Swarm: %1 receivers, %2 satellites, %3 Hz, %4 threads")
+                             .arg(m_receivers.size())
+                             .arg(m_constellation->satelliteCount())
+                             .arg(m_rateHz)
+                             .arg(m_pool->threadCount());
+}
+
+void ReceiverSwarm::stop() {
+    if (!m_epochTimer->isActive()) {
+        return;
+    }
+    m_epochTimer->stop();
+    m_reportTimer->stop();
+    for (ReceiverInstance *receiver : qAsConst(m_receivers)) {
+        receiver->close();
+    }
+}
+
+void ReceiverSwarm::runEpoch() {
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    const double dt = (nowNs - m_lastEpochNs) * 1e-9;
+    m_lastEpochNs = nowNs;
+
+    // Shared by all receivers and not touched again until they are done
+    const Constellation::Snapshot &snapshot =
+        m_constellation->advance(m_epoch++, QDateTime::currentMSecsSinceEpoch());
+
+    // Workers index the array directly, QVector::operator[] would run a
+    // detach check on every call
+    ReceiverInstance *const *receivers = m_receivers.constData();
+    m_pool->run(m_receivers.size(), [receivers, &snapshot, dt](int index) {
+        receivers[index]->buildEpoch(snapshot, dt);
+    });
+    const qint64 builtNs = m_clock.nsecsElapsed();
+
+    for (ReceiverInstance *receiver : qAsConst(m_receivers)) {
+        receiver->flush();
+    }
+
+    m_reportEpochs++;
+    m_buildNs += builtNs - nowNs;
+    m_maxBuildNs = qMax(m_maxBuildNs, builtNs - nowNs);
+    m_flushNs += m_clock.nsecsElapsed() - builtNs;
+}
+
+void ReceiverSwarm::report() {
+    if (m_reportEpochs == 0) {
+        return;
+    }
+
+    int open = 0;
+    for (const ReceiverInstance *receiver : qAsConst(m_receivers)) {
+        open += receiver->transport()->isOpen() ? 1 : 0;
+    }
+    qInfo().noquote() << tr("Swarm: %1 of %2 links open; epoch build mean %3 ms, max %4 ms, "
+                            "write mean %5 ms; %6 steals")
+                             .arg(open)
+                             .arg(m_receivers.size())
+                             .arg(m_buildNs / 1e6 / m_reportEpochs, 0, 'f', 3)
+                             .arg(m_maxBuildNs / 1e6, 0, 'f', 3)
+                             .arg(m_flushNs / 1e6 / m_reportEpochs, 0, 'f', 3)
+                             .arg(m_pool->takeSteals());
+
+    m_reportEpochs = 0;
+    m_buildNs = 0;
+    m_maxBuildNs = 0;
+    m_flushNs = 0;
+}
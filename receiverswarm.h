@@ -0,0 +1,74 @@
+#ifndef RECEIVER_SWARM_H
+#define RECEIVER_SWARM_H
+
+#include "constellation.h"
+#include "receiverinstance.h"
+#include "workstealingpool.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+class QTimer;
+
+// Many virtual receivers in one process, for swarm and dual-antenna tests.
+// Every epoch the constellation snapshot is computed once, the receivers
+// build their frames from it in parallel on a work-stealing pool, and the
+// frames are then written on this object's thread.
+//
+// {
+//   "rateHz": 5,
+//   "threads": 0,          0 = one per core
+//   "satellites": 24,      1..Constellation::MaxSatellites
+//   "receivers": [ { ...ReceiverInstance... } ],
+//   "generate": {          optional, appended after "receivers"
+//     "count": 100,
+//     "spacing": 10,       m east between consecutive receivers
+//     "template": { ...ReceiverInstance... }
+//   }
+// }
+//
+// Generated receivers take the template's port and uniqueId plus their
+// index and the name "<template name>-<index>". Every receiver needs its
+// own uniqueId, and its own port unless it uses a PTY.
+class ReceiverSwarm : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ReceiverSwarm(QObject *parent = nullptr);
+    ~ReceiverSwarm();
+
+    bool load(const QString &fileName);
+    bool configure(const QJsonObject &json);
+    QString errorString() const { return m_error; }
+
+    int receiverCount() const { return m_receivers.size(); }
+
+    void start();
+    void stop();
+
+private:
+    void runEpoch();
+    void report();
+    bool fail(const QString &error);
+
+    QVector<ReceiverInstance *> m_receivers;
+    std::unique_ptr<WorkStealingPool> m_pool;
+    std::unique_ptr<Constellation> m_constellation;
+    QTimer *m_epochTimer;
+    QTimer *m_reportTimer;
+    QElapsedTimer m_clock;
+    qint64 m_lastEpochNs = 0;
+    quint32 m_epoch = 0;
+    double m_rateHz = 1.0;
+    QString m_error;
+
+    // Since the last report
+    int m_reportEpochs = 0;
+    qint64 m_buildNs = 0;
+    qint64 m_maxBuildNs = 0;
+    qint64 m_flushNs = 0;
+};
+
+#endif // RECEIVER_SWARM_H
@@ -0,0 +1,238 @@
+#include "rfscenario.h"
+#include "ubxdefs.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+
+namespace {
+
+enum Channel {
+    Wideband,
+    Cw,
+    Antenna
+};
+
+// One event contribution over [start, end): intercept + slope * t, or an
+// antenna status
+struct Piece {
+    qint64 start;
+    qint64 end;
+    Channel channel;
+    double intercept;
+    double slope;
+    int antStatus;
+};
+
+QString tr(const char *text) {
+    return QCoreApplication::translate("RfScenario", text);
+}
+
+} // namespace
+
+quint8 RfScenario::Sample::jammingState() const {
+    const double level = qMax(wideband, cw);
+    if (level < 0.25) {
+        return JAMMING_OK;
+    }
+    return level < 0.6 ? JAMMING_WARNING : JAMMING_CRITICAL;
+}
+
+quint8 RfScenario::Sample::jamInd() const {
+    return static_cast<quint8>(qRound(cw * 255));
+}
+
+double RfScenario::Sample::noiseFactor() const {
+    return 1.0 + 3.0 * wideband;
+}
+
+double RfScenario::Sample::agcFactor() const {
+    return 1.0 - 0.7 * wideband;
+}
+
+double RfScenario::Sample::cnoDrop() const {
+    return 25.0 * wideband + 10.0 * cw;
+}
+
+bool RfScenario::fail(const QString &error) {
+    m_error = error;
+    clear();
+    return false;
+}
+
+void RfScenario::clear() {
+    m_segments.clear();
+    m_duration = 0;
+    m_loop = false;
+    m_cursor = 0;
+}
+
+bool RfScenario::load(const QString &fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(file.errorString());
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        return fail(parseError.error != QJsonParseError::NoError ? parseError.errorString()
+                                                                 : tr("Scenario must be a JSON object"));
+    }
+    return compile(doc.object());
+}
+
+bool RfScenario::compile(const QJsonObject &scenario) {
+    clear();
+
+    QVector<Piece> pieces;
+    qint64 duration = qRound64(scenario["duration"].toDouble(0) * 1000);
+    const QJsonArray events = scenario["events"].toArray();
+
+    for (int i = 0; i < events.size(); i++) {
+        const QJsonObject event = events[i].toObject();
+        const QString type = event["type"].toString();
+        const qint64 start = qRound64(event["start"].toDouble(-1) * 1000);
+        const qint64 length = qRound64(event["duration"].toDouble(0) * 1000);
+        if (start < 0 || length <= 0) {
+            return fail(tr("Event %1: start and duration are required").arg(i + 1));
+        }
+        const qint64 end = start + length;
+        const Channel channel = event["source"].toString() == QLatin1String("cw") ? Cw : Wideband;
+        duration = qMax(duration, end);
+
+        if (type == QLatin1String("ramp")) {
+            const double from = event["from"].toDouble(0);
+            const double to = event["to"].toDouble(1);
+            const double slope = (to - from) / length;
+            pieces.append({ start, end, channel, from - slope * start, slope, -1 });
+        } else if (type == QLatin1String("burst")) {
+            const qint64 period = qRound64(event["period"].toDouble(0) * 1000);
+            const qint64 on = qRound64(event["on"].toDouble(0) * 1000);
+            const double level = event["level"].toDouble(1);
+            if (period <= 0 || on <= 0 || on > period) {
+                return fail(tr("Event %1: a burst needs 0 < on <= period").arg(i + 1));
+            }
+            if (length / period > MaxSegments / 2) {
+                return fail(tr("Event %1: too many bursts").arg(i + 1));
+            }
+            for (qint64 t = start; t < end; t += period) {
+                pieces.append({ t, qMin(t + on, end), channel, level, 0.0, -1 });
+            }
+        } else if (type == QLatin1String("cw")) {
+            pieces.append({ start, end, Cw, event["level"].toDouble(1), 0.0, -1 });
+        } else if (type == QLatin1String("open")) {
+            pieces.append({ start, end, Antenna, 0.0, 0.0, ANT_STATUS_OPEN });
+        } else if (type == QLatin1String("short")) {
+            pieces.append({ start, end, Antenna, 0.0, 0.0, ANT_STATUS_SHORT });
+        } else {
+            return fail(tr("Event %1: unknown type \"%2\"").arg(i + 1).arg(type));
+        }
+    }
+
+    if (pieces.isEmpty()) {
+        return fail(tr("Scenario has no events"));
+    }
+
+    // Every start and end is a breakpoint; between two of them the sum of
+    // the active pieces is linear
+    QVector<qint64> breakpoints;
+    breakpoints.reserve(2 * pieces.size() + 2);
+    breakpoints.append(0);
+    breakpoints.append(duration);
+    for (const Piece &piece : qAsConst(pieces)) {
+        breakpoints.append(piece.start);
+        breakpoints.append(piece.end);
+    }
+    std::sort(breakpoints.begin(), breakpoints.end());
+    breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+    if (breakpoints.size() > MaxSegments) {
+        return fail(tr("Scenario needs more than %1 segments").arg(MaxSegments));
+    }
+
+    // Difference arrays over the breakpoints, summed into the segments below
+    const int count = breakpoints.size();
+    QVector<double> wideband(count + 1, 0.0), widebandSlope(count + 1, 0.0);
+    QVector<double> cw(count + 1, 0.0), cwSlope(count + 1, 0.0);
+    QVector<int> opens(count + 1, 0), shorts(count + 1, 0);
+    auto indexOf = [&breakpoints](qint64 t) {
+        return int(std::lower_bound(breakpoints.begin(), breakpoints.end(), t) - breakpoints.begin());
+    };
+
+    for (const Piece &piece : qAsConst(pieces)) {
+        const int first = indexOf(piece.start);
+        const int last = indexOf(piece.end);
+        switch (piece.channel) {
+        case Wideband:
+            wideband[first] += piece.intercept;
+            wideband[last] -= piece.intercept;
+            widebandSlope[first] += piece.slope;
+            widebandSlope[last] -= piece.slope;
+            break;
+        case Cw:
+            cw[first] += piece.intercept;
+            cw[last] -= piece.intercept;
+            cwSlope[first] += piece.slope;
+            cwSlope[last] -= piece.slope;
+            break;
+        case Antenna: {
+            QVector<int> &counter = piece.antStatus == ANT_STATUS_SHORT ? shorts : opens;
+            counter[first]++;
+            counter[last]--;
+            break;
+        }
+        }
+    }
+
+    m_segments.reserve(count);
+    Segment running = { 0, 0.0, 0.0, 0.0, 0.0, -1 };
+    int openCount = 0;
+    int shortCount = 0;
+    for (int i = 0; i < count; i++) {
+        running.start = breakpoints[i];
+        running.wideband += wideband[i];
+        running.widebandSlope += widebandSlope[i];
+        running.cw += cw[i];
+        running.cwSlope += cwSlope[i];
+        openCount += opens[i];
+        shortCount += shorts[i];
+        // A short wins over an open antenna
+        running.antStatus = shortCount > 0 ? ANT_STATUS_SHORT : (openCount > 0 ? ANT_STATUS_OPEN : -1);
+        m_segments.append(running);
+    }
+
+    m_duration = duration;
+    m_loop = scenario["loop"].toBool(false);
+    m_error.clear();
+    return true;
+}
+
+RfScenario::Sample RfScenario::evaluate(qint64 ms) const {
+    Sample sample;
+    if (m_segments.isEmpty()) {
+        return sample;
+    }
+
+    if (m_loop && m_duration > 0) {
+        ms %= m_duration;
+    }
+    ms = qMax<qint64>(0, ms);
+
+    if (m_cursor >= m_segments.size() || m_segments[m_cursor].start > ms) {
+        auto next = std::upper_bound(m_segments.begin(), m_segments.end(), ms,
+                                     [](qint64 t, const Segment &segment) { return t < segment.start; });
+        m_cursor = qMax(0, int(next - m_segments.begin()) - 1);
+    }
+    while (m_cursor + 1 < m_segments.size() && m_segments[m_cursor + 1].start <= ms) {
+        m_cursor++;
+    }
+
+    const Segment &segment = m_segments[m_cursor];
+    sample.active = true;
+    sample.wideband = qBound(0.0, segment.wideband + segment.widebandSlope * ms, 1.0);
+    sample.cw = qBound(0.0, segment.cw + segment.cwSlope * ms, 1.0);
+    sample.antStatus = segment.antStatus;
+    return sample;
+}
@@ -0,0 +1,76 @@
+#ifndef RF_SCENARIO_H
+#define RF_SCENARIO_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+// Interference timeline for MON-HW, MON-RF and NAV-SAT. A scenario is a
+// list of events (ramps, bursts, CW tones, antenna open/short) that is
+// compiled once into a piecewise-linear table: between two breakpoints
+// every channel is intercept + slope * t, so one lookup gives the whole
+// RF picture for an epoch.
+//
+// {
+//   "loop": true,
+//   "events": [
+//     { "type": "ramp",  "start": 10, "duration": 30, "from": 0, "to": 0.8 },
+//     { "type": "burst", "start": 60, "duration": 20, "period": 2, "on": 0.5, "level": 1 },
+//     { "type": "cw",    "start": 90, "duration": 15, "level": 0.6 },
+//     { "type": "open",  "start": 120, "duration": 5 },
+//     { "type": "short", "start": 130, "duration": 5 }
+//   ]
+// }
+//
+// Times are in seconds, levels are 0..1 of full-scale interference. Ramps
+// and bursts are wideband unless "source" is "cw"; overlapping events add.
+class RfScenario {
+public:
+    struct Sample {
+        bool active = false;
+        double wideband = 0.0;  // Broadband interference, 0..1
+        double cw = 0.0;        // Narrowband interference, 0..1
+        int antStatus = -1;     // ANT_STATUS_*, -1 keeps the configured status
+
+        quint8 jammingState() const;    // JAMMING_*
+        quint8 jamInd() const;          // CW jamming indicator, 0..255
+        double noiseFactor() const;     // Applied to noisePerMS
+        double agcFactor() const;       // Applied to agcCnt, the AGC backs off
+        double cnoDrop() const;         // dB taken off every satellite
+    };
+
+    static const int MaxSegments = 100000;
+
+    bool load(const QString &fileName);
+    bool compile(const QJsonObject &scenario);
+    void clear();
+
+    bool isActive() const { return !m_segments.isEmpty(); }
+    qint64 durationMs() const { return m_duration; }
+    int segmentCount() const { return m_segments.size(); }
+    QString errorString() const { return m_error; }
+
+    // Amortized O(1) while time only moves forward, which is how epochs
+    // come; a jump back costs one binary search
+    Sample evaluate(qint64 ms) const;
+
+private:
+    struct Segment {
+        qint64 start;
+        double wideband;        // Absolute-time intercepts and slopes (per ms)
+        double widebandSlope;
+        double cw;
+        double cwSlope;
+        int antStatus;
+    };
+
+    bool fail(const QString &error);
+
+    QVector<Segment> m_segments;
+    qint64 m_duration = 0;
+    bool m_loop = false;
+    mutable int m_cursor = 0;
+    QString m_error;
+};
+
+#endif // RF_SCENARIO_H
@@ -0,0 +1,67 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer seqlock around a plain value. One thread publishes, any
+// number of threads read without locking; a reader that overlaps a publish
+// retries. The value is copied as relaxed atomic words, so a torn copy is
+// detected rather than being undefined behaviour.
+template <typename T>
+class SeqLock {
+public:
+    SeqLock() {
+        for (std::atomic<quint64> &word : m_words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+        publish(T());
+    }
+
+    void publish(const T &value) {
+        quint64 words[WordCount] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const quint32 sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < WordCount; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T read() const {
+        quint64 words[WordCount];
+        quint32 before;
+        quint32 after;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            for (int i = 0; i < WordCount; i++) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    // Bumped by every publish, lets readers skip unchanged values
+    quint32 sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+    static const int WordCount = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64);
+
+    std::atomic<quint32> m_sequence { 0 };  // Odd while a publish is in progress
+    std::atomic<quint64> m_words[WordCount];
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,180 @@
+#include "shmtransport.h"
+#include "ubxshmring.h"
+
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ShmTransport::ShmTransport(const QString &name, QObject *parent)
+    : UbxTransport(parent), m_name(name), m_pollTimer(new QTimer(this)) {
+    m_pollTimer->setTimerType(Qt::PreciseTimer);
+    m_pollTimer->setInterval(1);
+    connect(m_pollTimer, &QTimer::timeout, this, &ShmTransport::poll);
+}
+
+ShmTransport::~ShmTransport() {
+    close();
+}
+
+QString ShmTransport::segmentName(quint16 port) {
+    return QString("/ubx-imitator-%1").arg(port);
+}
+
+void ShmTransport::setError(const QString &message) {
+    m_errorString = message;
+    emit errorOccurred(message);
+}
+
+void ShmTransport::open() {
+#ifdef Q_OS_UNIX
+    if (isOpen()) {
+        return;
+    }
+
+    const QByteArray name = m_name.toLocal8Bit();
+    const size_t size = static_cast<size_t>(ubx_shm_segment_size(RingCapacity));
+
+    // A segment left behind by a crashed run is replaced, not reused; one
+    // whose producer is still running belongs to someone else
+    const int existing = shm_open(name.constData(), O_RDONLY, 0);
+    if (existing >= 0) {
+        pid_t owner = 0;
+        struct stat info;
+        if (fstat(existing, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(ubx_shm_segment))) {
+            void *header = mmap(nullptr, sizeof(ubx_shm_segment), PROT_READ, MAP_SHARED, existing, 0);
+            if (header != MAP_FAILED) {
+                const ubx_shm_segment *segment = static_cast<const ubx_shm_segment *>(header);
+                if (__atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) == UBX_SHM_MAGIC) {
+                    owner = static_cast<pid_t>(segment->producer_pid);
+                }
+                munmap(header, sizeof(ubx_shm_segment));
+            }
+        }
+        ::close(existing);
+
+        if (owner > 0 && (owner == getpid() || kill(owner, 0) == 0 || errno == EPERM)) {
+            setError(tr("%1 is in use by producer process %2").arg(m_name).arg(owner));
+            return;
+        }
+        shm_unlink(name.constData());
+    }
+    m_fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (m_fd < 0) {
+        setError(tr("shm_open failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        return;
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        setError(tr("ftruncate failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(name.constData());
+        return;
+    }
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (memory == MAP_FAILED) {
+        setError(tr("mmap failed: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(name.constData());
+        return;
+    }
+
+    // ftruncate zero-fills, so both rings start empty
+    m_segment = static_cast<ubx_shm_segment *>(memory);
+    m_segment->version = UBX_SHM_VERSION;
+    m_segment->capacity = RingCapacity;
+    m_segment->producer_pid = static_cast<uint32_t>(getpid());
+    __atomic_store_n(&m_segment->magic, UBX_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    m_overruns = 0;
+    m_pollTimer->start();
+    emit opened();
+#else
+    setError(tr("Shared memory is not supported on this platform"));
+#endif
+}
+
+void ShmTransport::close() {
+#ifdef Q_OS_UNIX
+    if (!isOpen()) {
+        return;
+    }
+
+    m_pollTimer->stop();
+
+    // Tell a sleeping consumer that the producer is gone
+    __atomic_store_n(&m_segment->magic, 0u, __ATOMIC_RELEASE);
+    ubx_shm_wake(&m_segment->out);
+
+    munmap(m_segment, static_cast<size_t>(ubx_shm_segment_size(RingCapacity)));
+    ::close(m_fd);
+    shm_unlink(m_name.toLocal8Bit().constData());
+    m_segment = nullptr;
+    m_fd = -1;
+    emit closed();
+#endif
+}
+
+bool ShmTransport::isOpen() const {
+    return m_segment != nullptr;
+}
+
+qint64 ShmTransport::write(const char *data, qint64 size) {
+    if (!isOpen()) {
+        return -1;
+    }
+
+    if (!ubx_shm_write(&m_segment->out, ubx_shm_out_data(m_segment), RingCapacity, data,
+                       static_cast<uint32_t>(size))) {
+        m_overruns++;
+        return 0;
+    }
+    return size;
+}
+
+void ShmTransport::poll() {
+    if (isOpen() && __atomic_load_n(&m_segment->in.head, __ATOMIC_ACQUIRE) != m_segment->in.tail) {
+        emit readyRead();
+    }
+}
+
+QByteArray ShmTransport::readAll() {
+    QByteArray data;
+    if (!isOpen()) {
+        return data;
+    }
+
+    const unsigned char *frame;
+    uint32_t size;
+    int status;
+    while ((status = ubx_shm_peek(&m_segment->in, ubx_shm_in_data(m_segment), RingCapacity,
+                                  &frame, &size)) == UBX_SHM_FRAME) {
+        data.append(reinterpret_cast<const char *>(frame), static_cast<int>(size));
+        ubx_shm_release(&m_segment->in, size);
+    }
+
+    // The peer wrote a length or index that does not fit the ring; nothing
+    // after it can be trusted
+    if (status == UBX_SHM_CORRUPT) {
+        setError(tr("%1: corrupt record in the input ring, link closed").arg(m_name));
+        close();
+    }
+    return data;
+}
+
+QString ShmTransport::errorString() const {
+    return m_errorString;
+}
+
+QString ShmTransport::description() const {
+    return tr("Shared memory %1").arg(m_name);
+}
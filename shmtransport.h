@@ -0,0 +1,50 @@
+#ifndef UBX_SHM_TRANSPORT_H
+#define UBX_SHM_TRANSPORT_H
+
+#include "ubxtransport.h"
+
+class QTimer;
+struct ubx_shm_segment;
+
+// POSIX shared-memory backend for a consumer on the same host. Frames go
+// into the "out" ring of ubxshmring.h with one copy and no syscall unless
+// the consumer sleeps on the futex; the consumer reads them in place.
+// Frames that do not fit are dropped whole and counted as overruns.
+// Replies in the "in" ring are polled every millisecond, which is plenty
+// for configuration traffic.
+class ShmTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    ShmTransport(const QString &name, QObject *parent = nullptr);
+    ~ShmTransport() override;
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+
+    QString name() const { return m_name; }
+    quint64 overrunCount() const { return m_overruns; }
+
+    // Bytes per ring, a power of two
+    static const quint32 RingCapacity = 256 * 1024;
+
+    static QString segmentName(quint16 port);
+
+private:
+    void poll();
+    void setError(const QString &message);
+
+    QString m_name;
+    QString m_errorString;
+    ubx_shm_segment *m_segment = nullptr;
+    int m_fd = -1;
+    QTimer *m_pollTimer;
+    quint64 m_overruns = 0;
+};
+
+#endif // UBX_SHM_TRANSPORT_H
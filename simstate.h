@@ -0,0 +1,79 @@
+#ifndef SIM_STATE_H
+#define SIM_STATE_H
+
+#include "seqlock.h"
+
+#include <QtGlobal>
+
+// Everything the periodic messages are generated from, in display units.
+// Plain data so it can be copied between threads without touching a widget.
+struct SimState {
+    // NAV-PVT
+    double lat = 0.0;           // deg
+    double lon = 0.0;           // deg
+    double height = 0.0;        // m
+    double speed = 0.0;         // m/s
+    double heading = 0.0;       // deg
+    double velN = 0.0;          // m/s
+    double velE = 0.0;          // m/s
+    double velU = 0.0;          // m/s
+    double rmsPos = 0.0;        // m
+    double rmsVel = 0.0;        // m/s
+    double hAcc = 0.0;          // m, reported accuracies
+    double vAcc = 0.0;          // m
+    double sAcc = 0.0;          // m/s
+    double pdop = 0.0;
+    int numSats = 0;
+    double headVeh = 0.0;       // deg, from external attitude
+    bool headVehValid = false;
+
+    // NAV-STATUS
+    int statusFixType = 0;
+    int ttff = 0;               // ms
+
+    // NAV-SAT
+    int satVersion = 1;
+    int numSatsSat = 0;
+    int qualityInd = 0;
+    int health = 0;
+    bool svUsed = false;
+    bool diffCorr = false;
+    bool smoothed = false;
+    int orbitSource = 0;
+    double prResMin = 0.0;      // m
+    double prResMax = 0.0;      // m
+
+    // NAV-TIMEUTC
+    int timeUtcTAcc = 0;        // ns
+    int timeUtcNano = 0;        // ns
+    int timeUtcValid = 0;
+    int timeUtcStandard = 0;
+
+    // MON-HW
+    int hwNoise = 0;
+    int hwAgc = 0;              // %
+    int hwAntStatus = 0;
+    int hwAntPower = 0;
+    int hwJamming = 0;
+    int hwCwSuppression = 0;
+
+    // MON-RF
+    int rfVersion = 0;
+    int rfBlocks = 0;
+    int rfJamState = 0;
+    int rfAntStatus = 0;
+    int rfAntPower = 0;
+    double rfNoise = 0.0;
+    double rfAgc = 0.0;
+    int rfCwSuppression = 0;
+
+    // SEC-UNIQID
+    int uniqidVersion = 1;
+    bool chipIdValid = false;
+    quint64 chipId = 0;
+};
+
+// The UI thread publishes, emitter threads read without locking
+using SimStateBuffer = SeqLock<SimState>;
+
+#endif // SIM_STATE_H
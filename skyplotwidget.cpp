@@ -0,0 +1,128 @@
+#include "skyplotwidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QtMath>
+
+SkyPlotWidget::SkyPlotWidget(QWidget *parent) : QWidget(parent) {
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(200, 200);
+}
+
+QColor SkyPlotWidget::cnoColor(int cno) {
+    if (cno < 25) return QColor("#C62828");
+    if (cno < 35) return QColor("#EF6C00");
+    if (cno < 42) return QColor("#F9A825");
+    return QColor("#2E7D32");
+}
+
+QRect SkyPlotWidget::markerRect(const Satellite &sat) const {
+    if (sat.elev < 0 || m_radius <= 0) {
+        return QRect();
+    }
+
+    const double distance = m_radius * (90.0 - qMin<int>(sat.elev, 90)) / 90.0;
+    const double azimuth = qDegreesToRadians(static_cast<double>(sat.azim));
+    const int x = m_center.x() + qRound(distance * qSin(azimuth));
+    const int y = m_center.y() - qRound(distance * qCos(azimuth));
+    return QRect(x - MarkerSize / 2, y - MarkerSize / 2, MarkerSize, MarkerSize);
+}
+
+void SkyPlotWidget::setSatellites(const QVector<Satellite> &satellites) {
+    QRegion dirty;
+
+    QHash<quint16, int> byKey;
+    byKey.reserve(satellites.size());
+    for (int i = 0; i < satellites.size(); i++) {
+        const Satellite &sat = satellites[i];
+        byKey.insert(key(sat), i);
+
+        auto old = m_byKey.constFind(key(sat));
+        if (old == m_byKey.constEnd()) {
+            dirty += markerRect(sat);
+        } else if (!samePosition(m_satellites[old.value()], sat)) {
+            dirty += markerRect(m_satellites[old.value()]);
+            dirty += markerRect(sat);
+        }
+    }
+    for (const Satellite &sat : qAsConst(m_satellites)) {
+        if (!byKey.contains(key(sat))) {
+            dirty += markerRect(sat);
+        }
+    }
+
+    m_satellites = satellites;
+    m_byKey.swap(byKey);
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void SkyPlotWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    renderBackground();
+    update();
+}
+
+void SkyPlotWidget::renderBackground() {
+    const qreal dpr = devicePixelRatioF();
+    m_background = QPixmap(size() * dpr);
+    m_background.setDevicePixelRatio(dpr);
+    m_background.fill(palette().color(QPalette::Base));
+
+    m_center = rect().center();
+    m_radius = qMin(width(), height()) / 2 - MarkerSize;
+
+    QPainter painter(&m_background);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().color(QPalette::Mid), 1));
+
+    for (int elev = 0; elev < 90; elev += 30) {
+        const int r = m_radius * (90 - elev) / 90;
+        painter.drawEllipse(m_center, r, r);
+        painter.drawText(m_center + QPoint(3, -r + 12), QString::number(elev));
+    }
+    painter.drawLine(m_center.x() - m_radius, m_center.y(), m_center.x() + m_radius, m_center.y());
+    painter.drawLine(m_center.x(), m_center.y() - m_radius, m_center.x(), m_center.y() + m_radius);
+
+    painter.setPen(palette().color(QPalette::Text));
+    const QFontMetrics metrics(font());
+    painter.drawText(m_center.x() - metrics.horizontalAdvance("N") / 2, m_center.y() - m_radius - 4, "N");
+    painter.drawText(m_center.x() - metrics.horizontalAdvance("S") / 2, m_center.y() + m_radius + metrics.ascent() + 2, "S");
+    painter.drawText(m_center.x() + m_radius + 4, m_center.y() + metrics.ascent() / 2, "E");
+    painter.drawText(m_center.x() - m_radius - 4 - metrics.horizontalAdvance("W"), m_center.y() + metrics.ascent() / 2, "W");
+}
+
+void SkyPlotWidget::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    const QRegion region = event->region();
+    painter.setClipRegion(region);
+    painter.drawPixmap(0, 0, m_background);
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    QFont labelFont = font();
+    labelFont.setPointSize(7);
+    painter.setFont(labelFont);
+
+    for (const Satellite &sat : qAsConst(m_satellites)) {
+        const QRect marker = markerRect(sat);
+        if (marker.isNull() || !region.intersects(marker)) {
+            continue;
+        }
+
+        const QColor color = cnoColor(sat.cno);
+        const QRect circle = marker.adjusted(1, 1, -1, -1);
+        painter.setPen(QPen(color, 2));
+        if (sat.used) {
+            painter.setBrush(color);
+            painter.drawEllipse(circle);
+            painter.setPen(Qt::white);
+        } else {
+            painter.setBrush(palette().color(QPalette::Base));
+            painter.drawEllipse(circle);
+            painter.setPen(palette().color(QPalette::Text));
+        }
+        painter.drawText(marker, Qt::AlignCenter, QString::number(sat.svId));
+    }
+}
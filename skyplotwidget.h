@@ -0,0 +1,55 @@
+#ifndef SKY_PLOT_WIDGET_H
+#define SKY_PLOT_WIDGET_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QVector>
+#include <QWidget>
+
+// Azimuth/elevation chart of the satellites in the last NAV-SAT epoch.
+// The grid is rendered once per size into a pixmap; a new snapshot only
+// repaints the markers that moved, appeared or disappeared.
+class SkyPlotWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    struct Satellite {
+        quint8 gnssId = 0;
+        quint8 svId = 0;
+        qint8 elev = 0;     // deg
+        qint16 azim = 0;    // deg
+        quint8 cno = 0;     // dBHz
+        bool used = false;
+    };
+
+    explicit SkyPlotWidget(QWidget *parent = nullptr);
+
+    void setSatellites(const QVector<Satellite> &satellites);
+
+    QSize sizeHint() const override { return QSize(320, 320); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    static const int MarkerSize = 18;
+
+    static quint16 key(const Satellite &sat) { return static_cast<quint16>((sat.gnssId << 8) | sat.svId); }
+    static QColor cnoColor(int cno);
+    static bool samePosition(const Satellite &a, const Satellite &b) {
+        return a.elev == b.elev && a.azim == b.azim && a.cno == b.cno && a.used == b.used;
+    }
+
+    QRect markerRect(const Satellite &sat) const;
+    void renderBackground();
+
+    QPixmap m_background;
+    QPoint m_center;
+    int m_radius = 0;
+
+    QVector<Satellite> m_satellites;
+    QHash<quint16, int> m_byKey;    // Index into m_satellites
+};
+
+#endif // SKY_PLOT_WIDGET_H
@@ -0,0 +1,265 @@
+#include "telemetrydock.h"
+#include "qcustomplot.h"
+
+#include <QTabWidget>
+#include <QTimer>
+
+namespace {
+
+const QColor s_jitterColors[TelemetryDock::MaxJitterSeries] = {
+    QColor("#1565C0"), QColor("#C62828"), QColor("#2E7D32"),
+    QColor("#EF6C00"), QColor("#7B1FA2"), QColor("#00838F")
+};
+
+QString messageName(quint8 msgClass, quint8 msgId) {
+    return QString("0x%1/0x%2")
+        .arg(QString::number(msgClass, 16).rightJustified(2, '0').toUpper())
+        .arg(QString::number(msgId, 16).rightJustified(2, '0').toUpper());
+}
+
+} // namespace
+
+TelemetryDock::TelemetryDock(QWidget *parent)
+    : QDockWidget(tr("Telemetry"), parent),
+      m_tabs(new QTabWidget(this)),
+      m_refreshTimer(new QTimer(this)) {
+    setObjectName("telemetryDock");
+
+    m_trackPlot = createPlot();
+    m_trackCurve = new QCPCurve(m_trackPlot->xAxis, m_trackPlot->yAxis);
+    m_trackPlot->xAxis->setLabel(tr("Longitude, deg"));
+    m_trackPlot->yAxis->setLabel(tr("Latitude, deg"));
+    m_tabs->addTab(m_trackPlot, tr("Track"));
+
+    m_navPlot = createPlot();
+    m_speedGraph = m_navPlot->addGraph();
+    m_speedGraph->setName(tr("Speed, m/s"));
+    m_numSvGraph = m_navPlot->addGraph(m_navPlot->xAxis, m_navPlot->yAxis2);
+    m_numSvGraph->setName(tr("numSV"));
+    m_numSvGraph->setPen(QPen(QColor("#EF6C00")));
+    m_navPlot->yAxis->setLabel(tr("Speed, m/s"));
+    m_navPlot->yAxis2->setLabel(tr("numSV"));
+    m_navPlot->yAxis2->setVisible(true);
+    m_tabs->addTab(m_navPlot, tr("Speed / SV"));
+
+    m_satPlot = createPlot();
+    m_cnoBars = new QCPBars(m_satPlot->xAxis, m_satPlot->yAxis);
+    m_cnoBars->setWidth(0.8);
+    m_satPlot->xAxis->setLabel(tr("svId"));
+    m_satPlot->xAxis->setRange(0, 33);
+    m_satPlot->yAxis->setLabel(tr("C/N0, dBHz"));
+    m_satPlot->yAxis->setRange(0, 60);
+    m_tabs->addTab(m_satPlot, tr("C/N0"));
+
+    m_skyPlot = new SkyPlotWidget;
+    m_tabs->addTab(m_skyPlot, tr("Sky"));
+
+    m_rfPlot = createPlot();
+    m_hwAgcGraph = m_rfPlot->addGraph();
+    m_hwAgcGraph->setName(tr("MON-HW AGC, %"));
+    m_rfAgcGraph = m_rfPlot->addGraph();
+    m_rfAgcGraph->setName(tr("MON-RF AGC, %"));
+    m_rfAgcGraph->setPen(QPen(QColor("#2E7D32")));
+    m_hwJamGraph = m_rfPlot->addGraph(m_rfPlot->xAxis, m_rfPlot->yAxis2);
+    m_hwJamGraph->setName(tr("MON-HW jamInd"));
+    m_hwJamGraph->setPen(QPen(QColor("#C62828")));
+    m_rfJamGraph = m_rfPlot->addGraph(m_rfPlot->xAxis, m_rfPlot->yAxis2);
+    m_rfJamGraph->setName(tr("MON-RF jamInd"));
+    m_rfJamGraph->setPen(QPen(QColor("#EF6C00")));
+    m_rfPlot->yAxis->setLabel(tr("AGC, %"));
+    m_rfPlot->yAxis->setRange(0, 100);
+    m_rfPlot->yAxis2->setLabel(tr("jamInd"));
+    m_rfPlot->yAxis2->setRange(0, 255);
+    m_rfPlot->yAxis2->setVisible(true);
+    m_tabs->addTab(m_rfPlot, tr("Interference"));
+
+    m_jitterPlot = createPlot();
+    m_jitterPlot->yAxis->setLabel(tr("Interval change, ms"));
+    m_tabs->addTab(m_jitterPlot, tr("Jitter"));
+
+    setWidget(m_tabs);
+
+    m_clock.start();
+    connect(m_refreshTimer, &QTimer::timeout, this, &TelemetryDock::refresh);
+    m_refreshTimer->start(1000 / MaxRefreshHz);
+}
+
+TelemetryDock::~TelemetryDock() {
+    for (Jitter &jitter : m_jitter) {
+        delete jitter.series;
+    }
+}
+
+QCustomPlot *TelemetryDock::createPlot() {
+    QCustomPlot *plot = new QCustomPlot;
+    plot->setNotAntialiasedElements(QCP::aeAll);
+    plot->xAxis->setLabel(tr("Time, s"));
+    plot->legend->setVisible(true);
+    plot->legend->setFont(QFont(font().family(), 8));
+    return plot;
+}
+
+void TelemetryDock::addNavSolution(double lat, double lon, double speed, int numSv) {
+    const double t = now();
+    m_track.append(lon, lat);
+    m_speed.append(t, speed);
+    m_numSv.append(t, numSv);
+    m_trackDirty = true;
+    m_navDirty = true;
+}
+
+void TelemetryDock::clearSatellites() {
+    m_satellites.resize(0);
+    m_satDirty = true;
+    m_skyDirty = true;
+}
+
+void TelemetryDock::addSatellite(const SkyPlotWidget::Satellite &satellite) {
+    m_satellites.append(satellite);
+}
+
+void TelemetryDock::addInterference(InterferenceSource source, double agcPercent, int jamInd) {
+    const double t = now();
+    if (source == MonHw) {
+        m_hwAgc.append(t, agcPercent);
+        m_hwJam.append(t, jamInd);
+    } else {
+        m_rfAgc.append(t, agcPercent);
+        m_rfJam.append(t, jamInd);
+    }
+    m_rfDirty = true;
+}
+
+void TelemetryDock::addFrameSent(quint8 msgClass, quint8 msgId) {
+    const quint16 key = static_cast<quint16>((msgClass << 8) | msgId);
+    auto it = m_jitter.find(key);
+    if (it == m_jitter.end()) {
+        if (m_jitter.size() >= MaxJitterSeries) {
+            return;
+        }
+        it = m_jitter.insert(key, Jitter());
+    }
+
+    Jitter &jitter = it.value();
+    const qint64 sentNs = m_clock.nsecsElapsed();
+    if (jitter.lastSentNs >= 0) {
+        const double intervalMs = (sentNs - jitter.lastSentNs) / 1e6;
+        if (jitter.lastIntervalMs >= 0) {
+            if (!jitter.series) {
+                jitter.series = new TelemetrySeries;
+                jitter.graph = m_jitterPlot->addGraph();
+                jitter.graph->setName(messageName(msgClass, msgId));
+                jitter.graph->setPen(QPen(s_jitterColors[m_jitterPlot->graphCount() - 1]));
+            }
+            jitter.series->append(sentNs / 1e9, intervalMs - jitter.lastIntervalMs);
+            m_jitterDirty = true;
+        }
+        jitter.lastIntervalMs = intervalMs;
+    }
+    jitter.lastSentNs = sentNs;
+}
+
+void TelemetryDock::clear() {
+    m_track.clear();
+    m_speed.clear();
+    m_numSv.clear();
+    m_hwAgc.clear();
+    m_rfAgc.clear();
+    m_hwJam.clear();
+    m_rfJam.clear();
+    m_satellites.resize(0);
+    for (Jitter &jitter : m_jitter) {
+        delete jitter.series;
+    }
+    m_jitter.clear();
+    m_jitterPlot->clearGraphs();
+
+    m_trackDirty = m_navDirty = m_satDirty = m_skyDirty = m_rfDirty = m_jitterDirty = true;
+}
+
+void TelemetryDock::refresh() {
+    // Hidden plots cost nothing; their samples are drawn when shown
+    if (!isVisible()) {
+        return;
+    }
+
+    QWidget *current = m_tabs->currentWidget();
+    if (current == m_trackPlot && m_trackDirty) {
+        refreshTrack();
+    } else if (current == m_navPlot && m_navDirty) {
+        refreshNavigation();
+    } else if (current == m_satPlot && m_satDirty) {
+        refreshSatellites();
+    } else if (current == m_skyPlot && m_skyDirty) {
+        refreshSky();
+    } else if (current == m_rfPlot && m_rfDirty) {
+        refreshInterference();
+    } else if (current == m_jitterPlot && m_jitterDirty) {
+        refreshJitter();
+    }
+}
+
+void TelemetryDock::setGraphData(QCPGraph *graph, const TelemetrySeries &series, int buckets) {
+    series.decimate(buckets, m_keys, m_values);
+    graph->setData(m_keys, m_values, true);
+}
+
+void TelemetryDock::refreshTrack() {
+    m_track.thin(2 * m_trackPlot->axisRect()->width(), m_keys, m_values);
+    m_trackCurve->setData(m_keys, m_values);
+    m_trackPlot->rescaleAxes();
+    m_trackPlot->replot(QCustomPlot::rpQueuedReplot);
+    m_trackDirty = false;
+}
+
+void TelemetryDock::refreshNavigation() {
+    const int buckets = m_navPlot->axisRect()->width();
+    setGraphData(m_speedGraph, m_speed, buckets);
+    setGraphData(m_numSvGraph, m_numSv, buckets);
+    m_navPlot->rescaleAxes();
+    m_navPlot->replot(QCustomPlot::rpQueuedReplot);
+    m_navDirty = false;
+}
+
+void TelemetryDock::refreshSatellites() {
+    m_keys.resize(0);
+    m_values.resize(0);
+    double maxSvId = 32;
+    for (const SkyPlotWidget::Satellite &sat : qAsConst(m_satellites)) {
+        m_keys.append(sat.svId);
+        m_values.append(sat.cno);
+        maxSvId = qMax<double>(maxSvId, sat.svId);
+    }
+    m_cnoBars->setData(m_keys, m_values);
+    m_satPlot->xAxis->setRange(0, maxSvId + 1);
+    m_satPlot->replot(QCustomPlot::rpQueuedReplot);
+    m_satDirty = false;
+}
+
+void TelemetryDock::refreshSky() {
+    m_skyPlot->setSatellites(m_satellites);
+    m_skyDirty = false;
+}
+
+void TelemetryDock::refreshInterference() {
+    const int buckets = m_rfPlot->axisRect()->width();
+    setGraphData(m_hwAgcGraph, m_hwAgc, buckets);
+    setGraphData(m_rfAgcGraph, m_rfAgc, buckets);
+    setGraphData(m_hwJamGraph, m_hwJam, buckets);
+    setGraphData(m_rfJamGraph, m_rfJam, buckets);
+    m_rfPlot->xAxis->rescale();
+    m_rfPlot->replot(QCustomPlot::rpQueuedReplot);
+    m_rfDirty = false;
+}
+
+void TelemetryDock::refreshJitter() {
+    const int buckets = m_jitterPlot->axisRect()->width();
+    for (const Jitter &jitter : m_jitter) {
+        if (jitter.series) {
+            setGraphData(jitter.graph, *jitter.series, buckets);
+        }
+    }
+    m_jitterPlot->rescaleAxes();
+    m_jitterPlot->replot(QCustomPlot::rpQueuedReplot);
+    m_jitterDirty = false;
+}
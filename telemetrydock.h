@@ -0,0 +1,108 @@
+#ifndef TELEMETRY_DOCK_H
+#define TELEMETRY_DOCK_H
+
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+#include "telemetryseries.h"
+#include "skyplotwidget.h"
+
+class QCustomPlot;
+class QCPGraph;
+class QCPCurve;
+class QCPBars;
+class QTabWidget;
+class QTimer;
+
+// Live plots of the values the imitator sends. Samples go into fixed-size
+// TelemetrySeries; a timer capped at MaxRefreshHz decimates the visible tab
+// to its pixel width and queues a single replot.
+class TelemetryDock : public QDockWidget {
+    Q_OBJECT
+
+public:
+    enum InterferenceSource {
+        MonHw,
+        MonRf
+    };
+
+    explicit TelemetryDock(QWidget *parent = nullptr);
+    ~TelemetryDock();
+
+    static const int MaxRefreshHz = 10;
+    static const int MaxJitterSeries = 6;
+
+    void addNavSolution(double lat, double lon, double speed, int numSv);
+    void clearSatellites();
+    void addSatellite(const SkyPlotWidget::Satellite &satellite);
+    void addInterference(InterferenceSource source, double agcPercent, int jamInd);
+
+    // Call once per frame written; jitter is the change between consecutive
+    // send intervals of the same class/ID
+    void addFrameSent(quint8 msgClass, quint8 msgId);
+
+    void clear();
+
+private:
+    struct Jitter {
+        qint64 lastSentNs = -1;
+        double lastIntervalMs = -1;
+        TelemetrySeries *series = nullptr;
+        QCPGraph *graph = nullptr;
+    };
+
+    QCustomPlot *createPlot();
+    void refresh();
+    void refreshTrack();
+    void refreshNavigation();
+    void refreshSatellites();
+    void refreshSky();
+    void refreshInterference();
+    void refreshJitter();
+    void setGraphData(QCPGraph *graph, const TelemetrySeries &series, int buckets);
+    double now() const { return m_clock.nsecsElapsed() / 1e9; }
+
+    QTabWidget *m_tabs;
+    QTimer *m_refreshTimer;
+    QElapsedTimer m_clock;
+
+    QCustomPlot *m_trackPlot;
+    QCustomPlot *m_navPlot;
+    QCustomPlot *m_satPlot;
+    SkyPlotWidget *m_skyPlot;
+    QCustomPlot *m_rfPlot;
+    QCustomPlot *m_jitterPlot;
+
+    QCPCurve *m_trackCurve;
+    QCPGraph *m_speedGraph;
+    QCPGraph *m_numSvGraph;
+    QCPBars *m_cnoBars;
+    QCPGraph *m_hwAgcGraph;
+    QCPGraph *m_rfAgcGraph;
+    QCPGraph *m_hwJamGraph;
+    QCPGraph *m_rfJamGraph;
+
+    TelemetrySeries m_track;    // key = lon, value = lat
+    TelemetrySeries m_speed;
+    TelemetrySeries m_numSv;
+    TelemetrySeries m_hwAgc;
+    TelemetrySeries m_rfAgc;
+    TelemetrySeries m_hwJam;
+    TelemetrySeries m_rfJam;
+    QVector<SkyPlotWidget::Satellite> m_satellites;   // Last NAV-SAT epoch
+    QHash<quint16, Jitter> m_jitter;
+
+    // Scratch buffers reused by every refresh
+    QVector<double> m_keys;
+    QVector<double> m_values;
+
+    bool m_trackDirty = false;
+    bool m_navDirty = false;
+    bool m_satDirty = false;
+    bool m_skyDirty = false;
+    bool m_rfDirty = false;
+    bool m_jitterDirty = false;
+};
+
+#endif // TELEMETRY_DOCK_H
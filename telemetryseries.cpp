@@ -0,0 +1,99 @@
+#include "telemetryseries.h"
+
+TelemetrySeries::TelemetrySeries(int capacity)
+    : m_keys(qMax(1, capacity)), m_values(qMax(1, capacity)) {
+}
+
+void TelemetrySeries::append(double key, double value) {
+    if (m_count < m_keys.size()) {
+        const int idx = index(m_count);
+        m_keys[idx] = key;
+        m_values[idx] = value;
+        m_count++;
+        return;
+    }
+
+    // Full: overwrite the oldest sample
+    m_keys[m_start] = key;
+    m_values[m_start] = value;
+    m_start = index(1);
+}
+
+void TelemetrySeries::clear() {
+    m_start = 0;
+    m_count = 0;
+}
+
+void TelemetrySeries::decimate(int buckets, QVector<double> &keys, QVector<double> &values) const {
+    keys.resize(0);
+    values.resize(0);
+    if (m_count == 0) {
+        return;
+    }
+
+    buckets = qMax(1, buckets);
+    if (m_count <= 2 * buckets) {
+        for (int i = 0; i < m_count; i++) {
+            keys.append(keyAt(i));
+            values.append(valueAt(i));
+        }
+        return;
+    }
+
+    const double first = firstKey();
+    const double width = (lastKey() - first) / buckets;
+    if (width <= 0) {
+        keys.append(lastKey());
+        values.append(lastValue());
+        return;
+    }
+
+    int bucket = -1;
+    int minIdx = 0;
+    int maxIdx = 0;
+    auto flush = [&]() {
+        const int a = qMin(minIdx, maxIdx);
+        const int b = qMax(minIdx, maxIdx);
+        keys.append(keyAt(a));
+        values.append(valueAt(a));
+        if (b != a) {
+            keys.append(keyAt(b));
+            values.append(valueAt(b));
+        }
+    };
+
+    for (int i = 0; i < m_count; i++) {
+        const double value = valueAt(i);
+        const int b = qMin(buckets - 1, static_cast<int>((keyAt(i) - first) / width));
+        if (b != bucket) {
+            if (bucket >= 0) {
+                flush();
+            }
+            bucket = b;
+            minIdx = maxIdx = i;
+        } else if (value < valueAt(minIdx)) {
+            minIdx = i;
+        } else if (value > valueAt(maxIdx)) {
+            maxIdx = i;
+        }
+    }
+    flush();
+}
+
+void TelemetrySeries::thin(int maxPoints, QVector<double> &keys, QVector<double> &values) const {
+    keys.resize(0);
+    values.resize(0);
+    if (m_count == 0) {
+        return;
+    }
+
+    const int step = qMax(1, (m_count + maxPoints - 1) / qMax(1, maxPoints));
+    for (int i = 0; i < m_count; i += step) {
+        keys.append(keyAt(i));
+        values.append(valueAt(i));
+    }
+    if ((m_count - 1) % step != 0) {
+        keys.append(lastKey());
+        values.append(lastValue());
+    }
+}
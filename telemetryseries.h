@@ -0,0 +1,50 @@
+#ifndef TELEMETRY_SERIES_H
+#define TELEMETRY_SERIES_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Fixed-capacity ring of (key, value) samples. Once full, the oldest sample
+// is overwritten, so memory stays constant however long the session runs.
+class TelemetrySeries {
+public:
+    explicit TelemetrySeries(int capacity = DefaultCapacity);
+
+    // One hour of 20 Hz samples
+    static const int DefaultCapacity = 20 * 3600;
+
+    void append(double key, double value);
+    void clear();
+
+    int size() const { return m_count; }
+    int capacity() const { return m_keys.size(); }
+    bool isEmpty() const { return m_count == 0; }
+    double keyAt(int i) const { return m_keys[index(i)]; }
+    double valueAt(int i) const { return m_values[index(i)]; }
+    double firstKey() const { return keyAt(0); }
+    double lastKey() const { return keyAt(m_count - 1); }
+    double lastValue() const { return valueAt(m_count - 1); }
+
+    // Min/max decimation for keys appended in ascending order: the range is
+    // split into `buckets` columns and each column contributes its minimum
+    // and maximum sample, so spikes survive while at most 2 * buckets
+    // points reach the plot.
+    void decimate(int buckets, QVector<double> &keys, QVector<double> &values) const;
+
+    // Every n-th sample plus the newest one, for series whose keys are not
+    // ordered (e.g. a lat/lon track)
+    void thin(int maxPoints, QVector<double> &keys, QVector<double> &values) const;
+
+private:
+    int index(int i) const {
+        const int idx = m_start + i;
+        return idx >= m_keys.size() ? idx - m_keys.size() : idx;
+    }
+
+    QVector<double> m_keys;
+    QVector<double> m_values;
+    int m_start = 0;
+    int m_count = 0;
+};
+
+#endif // TELEMETRY_SERIES_H
@@ -0,0 +1,97 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<quint64> s_count { 0 };
+
+} // namespace
+
+quint64 AllocationCounter::count() {
+    return s_count.load(std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+
+// The C library's own entry points, so the interposed functions below do
+// not recurse. operator new goes through them too and is counted once.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+
+namespace {
+
+void *allocate(size_t size) {
+    return __libc_malloc(size ? size : 1);
+}
+
+} // namespace
+
+#else
+
+namespace {
+
+void *allocate(size_t size) {
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+#endif
+
+void *operator new(size_t size) {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    s_count.fetch_add(1, std::memory_order_relaxed);
+    return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
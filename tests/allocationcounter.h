@@ -0,0 +1,16 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <QtGlobal>
+
+// Counts heap allocations of the whole process. Linking allocationcounter.cpp
+// replaces the global operator new and, on glibc, interposes malloc(),
+// calloc() and realloc(), which is what Qt's containers allocate through.
+// For test executables only.
+namespace AllocationCounter {
+
+quint64 count();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATION_COUNTER_H
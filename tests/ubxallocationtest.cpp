@@ -0,0 +1,170 @@
+#include "allocationcounter.h"
+#include "gnsserrormodel.h"
+#include "ubxchecksum.h"
+#include "ubxdefs.h"
+#include "ubxepochbuilder.h"
+#include "ubxlog.h"
+#include "ubxtransport.h"
+
+#include <QtMath>
+#include <cmath>
+#include <cstdio>
+
+// Runs navigation epochs through the builders GNSSWindow's senders use
+// (NAV-PVT rebuilt in the frame cache as with the error model running,
+// NAV-STATUS patched, NAV-SAT, NAV-TIMEUTC, MON-HW and MON-RF in the
+// arena, one log record each) into a transport, and checks that after a
+// warm-up the epochs make no heap allocation at all.
+namespace {
+
+const int WarmupEpochs = 10;
+const int Epochs = 1000;
+
+// Open link that checks and counts what it is given
+class SinkTransport : public UbxTransport {
+public:
+    quint64 frames = 0;
+    quint64 bytes = 0;
+    quint64 badChecksums = 0;
+    quint64 epochs = 0;
+
+    void open() override {}
+    void close() override {}
+    bool isOpen() const override { return true; }
+    qint64 write(const char *data, qint64 size) override {
+        const int length = static_cast<int>(size);
+        const UbxChecksum::Value ck = UbxChecksum::ofFrame(data, length);
+        if (ck.ckA != static_cast<quint8>(data[length - 2]) || ck.ckB != static_cast<quint8>(data[length - 1])) {
+            badChecksums++;
+        }
+        frames++;
+        bytes += size;
+        return size;
+    }
+    QByteArray readAll() override { return QByteArray(); }
+    QString errorString() const override { return QString(); }
+    QString description() const override { return QString(); }
+    void endEpoch() override { epochs++; }
+};
+
+struct Epoch {
+    UbxPacketArena arena;
+    UbxFrameCache cache;
+    UbxEpochBuilder builder { arena, cache };
+    GnssErrorModel errorModel;
+    UbxLog::Ring log { 256 };
+    SinkTransport transport;
+    SimState base;
+    RfScenario::Sample rf;
+
+    Epoch() {
+        base.lat = 55.75;
+        base.lon = 37.62;
+        base.height = 150.0;
+        base.numSats = 12;
+        base.numSatsSat = 24;
+        base.prResMin = -2.0;
+        base.prResMax = 2.0;
+        base.rfBlocks = 2;
+        base.rmsPos = 1.5;
+        base.rmsVel = 0.1;
+        rf.active = true;
+        rf.wideband = 0.3;
+        rf.cw = 0.2;
+    }
+
+    void write(const UbxPacketArena::Frame &frame) { transport.write(frame.data, frame.size); }
+
+    void run(quint32 epoch) {
+        const UbxTime now = UbxTime::fromMSecs(1760000000000LL + epoch * 1000LL);
+        transport.beginEpoch(epoch);
+
+        // NAV-PVT, solution changes every epoch
+        arena.reset();
+        SimState state = base;
+        const GnssErrorModel::Output error = errorModel.step(1.0, state.rmsPos, state.rmsVel);
+        state.lat += error.position[GnssErrorModel::North] / 111320.0;
+        state.lon += error.position[GnssErrorModel::East] / (111320.0 * qCos(qDegreesToRadians(state.lat)));
+        state.height += error.position[GnssErrorModel::Up];
+        state.speed = std::hypot(error.velocity[GnssErrorModel::North], error.velocity[GnssErrorModel::East]);
+        state.hAcc = error.hAcc;
+        state.vAcc = error.vAcc;
+        state.sAcc = error.sAcc;
+        cache.invalidate(UbxFrameCache::FrameNavPvt);
+        write(builder.buildNavPvt(state, now));
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::NavPvtSent, {}, UBX_CLASS_NAV, UBX_NAV_PVT);
+
+        write(builder.buildNavStatus(state, now));
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::NavStatusSent, {}, UBX_CLASS_NAV, UBX_NAV_STATUS);
+
+        write(builder.buildNavSat(state, epoch, now, rf));
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::NavSatSent, {}, UBX_CLASS_NAV, UBX_NAV_SAT);
+
+        write(builder.buildNavTimeUtc(state, now));
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::NavTimeUtcSent, {}, UBX_CLASS_NAV, UBX_NAV_TIMEUTC);
+
+        UbxEpochBuilder::MonHwInfo hw;
+        write(builder.buildMonHw(state, rf, hw));
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::MonHwSent,
+                 { UbxLog::num(hw.noise), UbxLog::num(qRound(hw.agcPercent)), UbxLog::tag("OK"), UbxLog::tag("ON") },
+                 UBX_CLASS_MON, UBX_MON_HW);
+
+        UbxEpochBuilder::MonRfInfo rfInfo;
+        const UbxPacketArena::Frame monRf = builder.buildMonRf(state, rf, rfInfo);
+        write(monRf);
+        log.push(UbxLog::Info, UbxLog::Out, UbxLog::MonRfSent, { UbxLog::num(monRf.size) }, UBX_CLASS_MON, UBX_MON_RF);
+
+        transport.endEpoch();
+
+        // The GUI drains the log ring on a timer
+        UbxLog::Record record;
+        while (log.pop(record)) {
+        }
+    }
+};
+
+} // namespace
+
+int main() {
+    Epoch epoch;
+
+    GnssErrorModel::Config errors;
+    errors.enabled = true;
+    epoch.errorModel.setConfig(errors);
+
+    for (int i = 0; i < WarmupEpochs; i++) {
+        epoch.run(i);
+    }
+
+    const quint64 before = AllocationCounter::count();
+    for (int i = WarmupEpochs; i < WarmupEpochs + Epochs; i++) {
+        epoch.run(i);
+    }
+    const quint64 allocations = AllocationCounter::count() - before;
+
+    std::printf("%d epochs, %llu frames, %llu bytes, %llu allocations\n", Epochs,
+                static_cast<unsigned long long>(epoch.transport.frames),
+                static_cast<unsigned long long>(epoch.transport.bytes),
+                static_cast<unsigned long long>(allocations));
+
+    if (epoch.transport.badChecksums) {
+        std::fprintf(stderr, "%llu frames with a bad checksum\n",
+                     static_cast<unsigned long long>(epoch.transport.badChecksums));
+        return 1;
+    }
+    if (epoch.transport.frames != 6ULL * (WarmupEpochs + Epochs) ||
+        epoch.transport.epochs != static_cast<quint64>(WarmupEpochs + Epochs)) {
+        std::fprintf(stderr, "expected six frames in each of %d epochs\n", WarmupEpochs + Epochs);
+        return 1;
+    }
+    if (epoch.builder.navSatTracked() <= 0) {
+        std::fprintf(stderr, "NAV-SAT tracked no satellites\n");
+        return 1;
+    }
+    if (allocations != 0) {
+        std::fprintf(stderr, "steady-state epochs allocated %llu times\n",
+                     static_cast<unsigned long long>(allocations));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "ubxchecksum.h"
+
+#include <QByteArray>
+#include <cstdio>
+#include <random>
+
+// Checks the unrolled compute() and the incremental update()/patchFrame()
+// against a byte-at-a-time Fletcher loop on random data.
+namespace {
+
+UbxChecksum::Value reference(const char *data, int size) {
+    UbxChecksum::Value ck;
+    for (int i = 0; i < size; i++) {
+        ck.ckA = static_cast<quint8>(ck.ckA + static_cast<quint8>(data[i]));
+        ck.ckB = static_cast<quint8>(ck.ckB + ck.ckA);
+    }
+    return ck;
+}
+
+bool same(const UbxChecksum::Value &a, const UbxChecksum::Value &b) {
+    return a.ckA == b.ckA && a.ckB == b.ckB;
+}
+
+int failures = 0;
+
+void fail(const char *what, int size, int index) {
+    if (failures++ < 10) {
+        std::fprintf(stderr, "%s mismatch: size %d, index %d\n", what, size, index);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(27);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    // Every length up to a few blocks of 8, then random longer ones
+    for (int round = 0; round < 2000; round++) {
+        const int size = round < 200 ? round : std::uniform_int_distribution<int>(0, 4000)(rng);
+        QByteArray data(size, '\0');
+        for (int i = 0; i < size; i++) {
+            data[i] = static_cast<char>(byte(rng));
+        }
+        if (!same(UbxChecksum::compute(data.constData(), size), reference(data.constData(), size))) {
+            fail("compute", size, -1);
+        }
+    }
+
+    // Random single-byte patches through update() and patchFrame()
+    for (int round = 0; round < 2000; round++) {
+        const int payloadSize = std::uniform_int_distribution<int>(1, 1000)(rng);
+        const int frameSize = payloadSize + 8;
+        QByteArray frame(frameSize, '\0');
+        frame[0] = static_cast<char>(0xB5);
+        frame[1] = 0x62;
+        for (int i = 2; i < frameSize - 2; i++) {
+            frame[i] = static_cast<char>(byte(rng));
+        }
+        UbxChecksum::seal(frame.data(), frameSize);
+
+        UbxChecksum::Value ck = UbxChecksum::ofFrame(frame.constData(), frameSize);
+        for (int patch = 0; patch < 16; patch++) {
+            const int offset = std::uniform_int_distribution<int>(0, payloadSize - 1)(rng);
+            const char value = static_cast<char>(byte(rng));
+
+            // update() alone, tracked across patches
+            const int rangeIndex = 4 + offset;
+            UbxChecksum::update(ck, frameSize - 4, rangeIndex,
+                                static_cast<quint8>(frame[6 + offset]), static_cast<quint8>(value));
+
+            UbxChecksum::patchFrame(frame.data(), frameSize, offset, &value, 1);
+
+            const UbxChecksum::Value expected = reference(frame.constData() + 2, frameSize - 4);
+            if (!same(ck, expected)) {
+                fail("update", payloadSize, offset);
+            }
+            const UbxChecksum::Value stored = { static_cast<quint8>(frame[frameSize - 2]),
+                                                static_cast<quint8>(frame[frameSize - 1]) };
+            if (!same(stored, expected)) {
+                fail("patchFrame", payloadSize, offset);
+            }
+        }
+        if (!UbxChecksum::verify(frame)) {
+            fail("verify", payloadSize, -1);
+        }
+    }
+
+    if (failures) {
+        std::fprintf(stderr, "%d checksum mismatches\n", failures);
+        return 1;
+    }
+    std::printf("checksum: all cases match the reference\n");
+    return 0;
+}
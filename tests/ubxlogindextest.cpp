@@ -0,0 +1,159 @@
+#include "ubxlogindex.h"
+
+#include <QDateTime>
+#include <cstdio>
+#include <random>
+
+// Checks UbxLogIndex::match() against a plain per-record predicate for
+// random records and filters, including a resumed scan and a time window.
+namespace {
+
+struct Entry {
+    UbxLog::Record record;
+    quint64 offset;
+};
+
+bool passes(const UbxLogIndex::Filter &filter, const UbxLog::Record &record) {
+    return (filter.msgClass < 0 || record.msgClass == filter.msgClass) &&
+           (filter.msgId < 0 || record.msgId == filter.msgId) &&
+           (filter.direction < 0 || record.direction == filter.direction) &&
+           record.level >= filter.minLevel;
+}
+
+int failures = 0;
+
+void fail(const char *what, int round, int row) {
+    if (failures++ < 10) {
+        std::fprintf(stderr, "%s mismatch: round %d, row %d\n", what, round, row);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(34);
+    const quint8 classes[] = { 0, 0x01, 0x05, 0x06, 0x0A };
+    const quint8 ids[] = { 0, 0x00, 0x01, 0x07, 0x35 };
+    auto pick = [&rng](int count) { return std::uniform_int_distribution<int>(0, count - 1)(rng); };
+
+    // Ten minutes of records ending now, a few per second
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int recordCount = 5000;
+    QVector<Entry> entries;
+    UbxLogIndex index;
+    quint64 offset = 0;
+    for (int i = 0; i < recordCount; i++) {
+        Entry entry;
+        entry.record.timestamp = now - 600000 + qint64(i) * 600000 / recordCount;
+        entry.record.level = static_cast<UbxLog::Level>(pick(UbxLog::Error + 1));
+        entry.record.direction = static_cast<UbxLog::Direction>(pick(UbxLog::Out + 1));
+        entry.record.msgClass = classes[pick(5)];
+        entry.record.msgId = ids[pick(5)];
+        entry.offset = offset;
+        offset += 16 + pick(64);
+        index.add(entry.record, entry.offset);
+        entries.append(entry);
+    }
+
+    if (index.size() != recordCount) {
+        fail("size", -1, index.size());
+    }
+    for (int row = 0; row < recordCount; row++) {
+        if (index.offset(row) != entries[row].offset) {
+            fail("offset", -1, row);
+        }
+    }
+
+    // An empty filter matches everything
+    QVector<quint32> rows;
+    index.match(UbxLogIndex::Filter(), 0, rows);
+    if (rows.size() != recordCount) {
+        fail("empty filter", -1, rows.size());
+    }
+
+    // Each direction on its own, so Out picks up exactly the sent frames
+    for (int direction = UbxLog::NoDirection; direction <= UbxLog::Out; direction++) {
+        UbxLogIndex::Filter filter;
+        filter.direction = direction;
+        rows.clear();
+        index.match(filter, 0, rows);
+        int expected = 0;
+        for (const Entry &entry : entries) {
+            expected += entry.record.direction == direction;
+        }
+        if (rows.size() != expected) {
+            fail("direction count", direction, rows.size());
+        }
+        for (quint32 row : rows) {
+            if (entries[row].record.direction != direction) {
+                fail("direction", direction, static_cast<int>(row));
+            }
+        }
+    }
+
+    // Random combinations, scanning the whole index or resuming part way
+    for (int round = 0; round < 500; round++) {
+        UbxLogIndex::Filter filter;
+        filter.msgClass = pick(2) ? -1 : classes[pick(5)];
+        filter.msgId = pick(2) ? -1 : ids[pick(5)];
+        filter.direction = pick(2) ? -1 : pick(UbxLog::Out + 1);
+        filter.minLevel = pick(UbxLog::Error + 1);
+        const int from = pick(2) ? 0 : pick(recordCount);
+
+        rows.clear();
+        index.match(filter, from, rows);
+
+        int next = 0;
+        for (int row = from; row < recordCount; row++) {
+            if (!passes(filter, entries[row].record)) {
+                continue;
+            }
+            if (next >= rows.size() || rows[next] != static_cast<quint32>(row)) {
+                fail("filter", round, row);
+                break;
+            }
+            next++;
+        }
+        if (next != rows.size()) {
+            fail("filter extra rows", round, rows.size() - next);
+        }
+
+        // The JSON form used by saved views round-trips
+        const UbxLogIndex::Filter restored = UbxLogIndex::Filter::fromJson(filter.toJson());
+        if (restored.msgClass != filter.msgClass || restored.msgId != filter.msgId ||
+            restored.direction != filter.direction || restored.minLevel != filter.minLevel) {
+            fail("json", round, -1);
+        }
+    }
+
+    // A time window starts at the bucket holding its start, so it may take
+    // in up to one bucket of older records (plus the clock moving on while
+    // the test runs) but never drops a newer one
+    for (int minutes = 1; minutes <= 12; minutes++) {
+        UbxLogIndex::Filter filter;
+        filter.lastMinutes = minutes;
+        rows.clear();
+        index.match(filter, 0, rows);
+        const qint64 since = QDateTime::currentMSecsSinceEpoch() - qint64(minutes) * 60000;
+        int expected = 0;
+        for (const Entry &entry : entries) {
+            expected += entry.record.timestamp >= since;
+        }
+        if (rows.size() < expected) {
+            fail("window dropped rows", minutes, expected - rows.size());
+        }
+        for (quint32 row : rows) {
+            if (entries[row].record.timestamp < since - 2 * UbxLogIndex::BucketMs) {
+                fail("window", minutes, static_cast<int>(row));
+                break;
+            }
+        }
+    }
+
+    if (failures) {
+        std::fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+    std::printf("ubx log index: ok\n");
+    return 0;
+}
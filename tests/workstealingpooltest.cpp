@@ -0,0 +1,94 @@
+#include "workstealingpool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+// Checks that WorkStealingPool::run() calls the task exactly once for every
+// index, whatever the thread count and range size, and that an idle thread
+// takes over part of a slow range.
+namespace {
+
+int failures = 0;
+
+void fail(const char *what, int threads, int count, int detail) {
+    if (failures++ < 10) {
+        std::fprintf(stderr, "%s: %d threads, count %d, %d\n", what, threads, count, detail);
+    }
+}
+
+void checkCoverage(WorkStealingPool &pool, int count) {
+    std::vector<std::atomic<int>> hits(static_cast<size_t>(count));
+    for (std::atomic<int> &hit : hits) {
+        hit.store(0, std::memory_order_relaxed);
+    }
+    pool.run(count, [&hits](int index) { hits[static_cast<size_t>(index)].fetch_add(1, std::memory_order_relaxed); });
+    for (int i = 0; i < count; i++) {
+        const int n = hits[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+        if (n != 1) {
+            fail("coverage", pool.threadCount(), count, i);
+            return;
+        }
+    }
+}
+
+// The slow indices all start out in one thread's range; the others finish
+// theirs at once and have to steal to help
+void checkStealing(int threads, int slowQueue) {
+    const int count = 64;
+    const int slowBegin = count * slowQueue / threads;
+    const int slowEnd = count * (slowQueue + 1) / threads;
+
+    WorkStealingPool pool(threads);
+    pool.takeSteals();
+    std::vector<std::thread::id> ranOn(count);
+    pool.run(count, [&](int index) {
+        if (index >= slowBegin && index < slowEnd) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        ranOn[static_cast<size_t>(index)] = std::this_thread::get_id();
+    });
+
+    if (pool.takeSteals() == 0) {
+        fail("no steals", threads, count, slowQueue);
+    }
+    std::set<std::thread::id> helpers;
+    for (int i = slowBegin; i < slowEnd; i++) {
+        helpers.insert(ranOn[static_cast<size_t>(i)]);
+    }
+    if (helpers.size() < 2) {
+        fail("slow range ran on one thread", threads, count, slowQueue);
+    }
+}
+
+} // namespace
+
+int main() {
+    const int threadCounts[] = { 1, 2, 3, 4, 8 };
+    const int counts[] = { 0, 1, 2, 3, 7, 8, 9, 100, 1000, 100000 };
+
+    for (int threads : threadCounts) {
+        WorkStealingPool pool(threads);
+        if (pool.threadCount() != threads) {
+            fail("threadCount", threads, 0, pool.threadCount());
+        }
+        for (int count : counts) {
+            checkCoverage(pool, count);
+        }
+        // Back-to-back runs on the same pool, as the swarm does every epoch
+        for (int round = 0; round < 500; round++) {
+            checkCoverage(pool, round % 37);
+        }
+    }
+
+    // Slow work owned by the caller, then by a worker
+    checkStealing(4, 0);
+    checkStealing(4, 3);
+
+    if (failures) {
+        std::fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+    std::printf("work-stealing pool: ok\n");
+    return 0;
+}
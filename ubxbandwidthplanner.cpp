@@ -0,0 +1,56 @@
+#include "ubxbandwidthplanner.h"
+
+#include <QObject>
+
+void UbxBandwidthPlanner::addOutput(const QString &name, int payloadSize, int periodMs) {
+    if (periodMs <= 0) {
+        return;
+    }
+
+    Output output;
+    output.name = name;
+    output.frameBytes = 8 + payloadSize; // sync(2) + class/id/length(4) + checksum(2)
+    output.periodMs = periodMs;
+    m_outputs.append(output);
+}
+
+double UbxBandwidthPlanner::linkBytesPerSecond(quint32 baudRate, int dataBits, int stopBits, bool parity) {
+    const int bitsPerByte = 1 + dataBits + (parity ? 1 : 0) + stopBits;
+    return static_cast<double>(baudRate) / bitsPerByte;
+}
+
+UbxBandwidthPlanner::Report UbxBandwidthPlanner::plan(quint32 baudRate, int epochPeriodMs, int txQueueCapacity) const {
+    Report report;
+    report.linkBytesPerSecond = linkBytesPerSecond(baudRate);
+
+    for (const Output &output : m_outputs) {
+        report.bytesPerSecond += output.frameBytes * 1000.0 / output.periodMs;
+        report.burstBytes += output.frameBytes;
+        if (output.periodMs <= epochPeriodMs) {
+            report.epochBytes += output.frameBytes * (epochPeriodMs / output.periodMs);
+        }
+    }
+
+    if (report.linkBytesPerSecond > 0.0) {
+        report.utilization = report.bytesPerSecond / report.linkBytesPerSecond;
+        report.burstDrainMs = report.burstBytes * 1000.0 / report.linkBytesPerSecond;
+    }
+
+    // The epoch must leave the UART before the next one starts, and a burst
+    // larger than the queue loses its tail just like a receiver's TX buffer
+    report.oversubscribed = report.utilization > 1.0 ||
+                            report.epochBytes > report.linkBytesPerSecond * epochPeriodMs / 1000.0;
+    report.burstDroppedBytes = qMax(0, report.burstBytes - txQueueCapacity);
+
+    return report;
+}
+
+QString UbxBandwidthPlanner::summary(const Report &report) {
+    return QObject::tr("UART %1% (%2/%3 B/s), epoch %4 B, burst %5 B in %6 ms")
+        .arg(report.utilization * 100.0, 0, 'f', 0)
+        .arg(report.bytesPerSecond, 0, 'f', 0)
+        .arg(report.linkBytesPerSecond, 0, 'f', 0)
+        .arg(report.epochBytes)
+        .arg(report.burstBytes)
+        .arg(report.burstDrainMs, 0, 'f', 1);
+}
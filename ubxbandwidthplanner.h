@@ -0,0 +1,43 @@
+#ifndef UBX_BANDWIDTH_PLANNER_H
+#define UBX_BANDWIDTH_PLANNER_H
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+// Checks whether the periodic output fits the serial link. Each output is a
+// framed message sent every periodMs; the link carries baud / (start + data
+// + parity + stop) bytes per second.
+class UbxBandwidthPlanner {
+public:
+    struct Output {
+        QString name;
+        int frameBytes;
+        int periodMs;
+    };
+
+    struct Report {
+        double bytesPerSecond = 0.0;
+        double linkBytesPerSecond = 0.0;
+        double utilization = 0.0;
+        int epochBytes = 0;        // Messages due every navigation epoch
+        int burstBytes = 0;        // Worst case, every output due at once
+        double burstDrainMs = 0.0; // Time for the burst to leave the UART
+        int burstDroppedBytes = 0; // Part of the burst beyond the TX queue
+        bool oversubscribed = false;
+    };
+
+    void clear() { m_outputs.clear(); }
+    void addOutput(const QString &name, int payloadSize, int periodMs);
+    const QList<Output> &outputs() const { return m_outputs; }
+
+    Report plan(quint32 baudRate, int epochPeriodMs, int txQueueCapacity) const;
+
+    static double linkBytesPerSecond(quint32 baudRate, int dataBits = 8, int stopBits = 1, bool parity = false);
+    static QString summary(const Report &report);
+
+private:
+    QList<Output> m_outputs;
+};
+
+#endif // UBX_BANDWIDTH_PLANNER_H
@@ -0,0 +1,59 @@
+#include "ubxchecksum.h"
+
+UbxChecksum::Value UbxChecksum::compute(const char *data, int size) {
+    const quint8 *bytes = reinterpret_cast<const quint8 *>(data);
+
+    // Only the low 8 bits matter, so 32-bit accumulators may wrap freely.
+    // For a block of 8 bytes: b += 8a + 8*x0 + 7*x1 + ... + 1*x7, a += sum(x).
+    quint32 a = 0;
+    quint32 b = 0;
+    int i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const quint8 *p = bytes + i;
+        b += 8 * a
+             + 8u * p[0] + 7u * p[1] + 6u * p[2] + 5u * p[3]
+             + 4u * p[4] + 3u * p[5] + 2u * p[6] + 1u * p[7];
+        a += 0u + p[0] + p[1] + p[2] + p[3] + p[4] + p[5] + p[6] + p[7];
+    }
+    for (; i < size; i++) {
+        a += bytes[i];
+        b += a;
+    }
+
+    Value ck;
+    ck.ckA = static_cast<quint8>(a);
+    ck.ckB = static_cast<quint8>(b);
+    return ck;
+}
+
+void UbxChecksum::seal(char *frame, int frameSize) {
+    const Value ck = ofFrame(frame, frameSize);
+    frame[frameSize - 2] = static_cast<char>(ck.ckA);
+    frame[frameSize - 1] = static_cast<char>(ck.ckB);
+}
+
+bool UbxChecksum::verify(const QByteArray &frame) {
+    if (frame.size() < 8) {
+        return false;
+    }
+    const Value ck = ofFrame(frame.constData(), frame.size());
+    return ck.ckA == static_cast<quint8>(frame[frame.size() - 2]) &&
+           ck.ckB == static_cast<quint8>(frame[frame.size() - 1]);
+}
+
+void UbxChecksum::patchFrame(char *frame, int frameSize, int payloadOffset,
+                             const char *data, int size) {
+    const int rangeSize = frameSize - 4;
+    Value ck;
+    ck.ckA = static_cast<quint8>(frame[frameSize - 2]);
+    ck.ckB = static_cast<quint8>(frame[frameSize - 1]);
+
+    for (int k = 0; k < size; k++) {
+        const int pos = 6 + payloadOffset + k;
+        update(ck, rangeSize, pos - 2, static_cast<quint8>(frame[pos]), static_cast<quint8>(data[k]));
+        frame[pos] = data[k];
+    }
+
+    frame[frameSize - 2] = static_cast<char>(ck.ckA);
+    frame[frameSize - 1] = static_cast<char>(ck.ckB);
+}
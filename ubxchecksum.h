@@ -0,0 +1,35 @@
+#ifndef UBX_CHECKSUM_H
+#define UBX_CHECKSUM_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// 8-bit Fletcher checksum used by UBX frames. The checksummed range starts
+// at the class byte and ends with the last payload byte.
+class UbxChecksum {
+public:
+    struct Value {
+        quint8 ckA = 0;
+        quint8 ckB = 0;
+    };
+
+    static Value compute(const char *data, int size);
+
+    // O(1) update after range[index] changed from oldByte to newByte,
+    // where rangeSize is the length of the checksummed range.
+    static void update(Value &ck, int rangeSize, int index, quint8 oldByte, quint8 newByte) {
+        const quint8 delta = static_cast<quint8>(newByte - oldByte);
+        ck.ckA += delta;
+        ck.ckB += static_cast<quint8>((rangeSize - index) * delta);
+    }
+
+    // Whole-frame helpers, frame = sync(2) + class/id/length(4) + payload + ck(2)
+    static Value ofFrame(const char *frame, int frameSize) {
+        return compute(frame + 2, frameSize - 4);
+    }
+    static void seal(char *frame, int frameSize);
+    static bool verify(const QByteArray &frame);
+    static void patchFrame(char *frame, int frameSize, int payloadOffset, const char *data, int size);
+};
+
+#endif // UBX_CHECKSUM_H
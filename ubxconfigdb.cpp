@@ -0,0 +1,302 @@
+#include "ubxconfigdb.h"
+
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+enum Transaction {
+    TransactionNone = 0,
+    TransactionBegin = 1,
+    TransactionContinue = 2,
+    TransactionApply = 3
+};
+
+quint64 truncateToSize(quint32 id, quint64 value) {
+    switch (UbxConfigKeys::sizeCode(id)) {
+    case UbxConfigKeys::SizeBit: return value & 0x01;
+    case UbxConfigKeys::SizeOne: return value & 0xFF;
+    case UbxConfigKeys::SizeTwo: return value & 0xFFFF;
+    case UbxConfigKeys::SizeFour: return value & 0xFFFFFFFFu;
+    default: return value;
+    }
+}
+
+bool isWildcard(quint32 id) {
+    return (id & 0xFFFF) == 0xFFFF;
+}
+
+// Group wildcards carry the group in bits 16..23; 0x0FFFFFFF selects all keys
+bool matchesWildcard(quint32 wildcard, quint32 id) {
+    const quint8 group = UbxConfigKeys::group(wildcard);
+    return group == 0xFF || group == UbxConfigKeys::group(id);
+}
+
+} // namespace
+
+UbxConfigDb::UbxConfigDb(QObject *parent) : QObject(parent) {
+    m_ram.resize(UbxConfigKeys::Count);
+    for (int i = 0; i < UbxConfigKeys::Count; i++) {
+        m_ram[i] = UbxConfigKeys::catalog[i].defaultValue;
+    }
+}
+
+bool UbxConfigDb::openStore(quint64 uniqueId) {
+    const bool ok = m_store.open(UbxConfigStore::fileNameFor(uniqueId));
+    reload();
+    return ok;
+}
+
+bool UbxConfigDb::fail(const QString &error) const {
+    m_lastError = error;
+    return false;
+}
+
+bool UbxConfigDb::value(Layer layer, quint32 id, quint64 &out) const {
+    const int index = UbxConfigKeys::indexOf(id);
+    if (index < 0) {
+        return false;
+    }
+    if (layer == Default) {
+        out = UbxConfigKeys::catalog[index].defaultValue;
+        return true;
+    }
+    if (layer == Ram) {
+        out = m_ram[index];
+        return true;
+    }
+
+    const UbxConfigStore::Layer stored = layer == Bbr ? UbxConfigStore::Bbr : UbxConfigStore::Flash;
+    if (!m_store.present(stored, index)) {
+        return false;
+    }
+    out = m_store.value(stored, index);
+    return true;
+}
+
+quint64 UbxConfigDb::value(quint32 id) const {
+    const int index = UbxConfigKeys::indexOf(id);
+    return index < 0 ? 0 : m_ram[index];
+}
+
+bool UbxConfigDb::set(quint8 layers, quint32 id, quint64 value) {
+    const int index = UbxConfigKeys::indexOf(id);
+    if (index < 0) {
+        return fail(tr("Unknown key 0x%1").arg(id, 8, 16, QLatin1Char('0')));
+    }
+    store(layers, index, truncateToSize(id, value));
+    return true;
+}
+
+void UbxConfigDb::store(quint8 layers, int index, quint64 value) {
+    if (layers & BbrMask) {
+        m_store.write(UbxConfigStore::Bbr, index, value, true);
+    }
+    if (layers & FlashMask) {
+        m_store.write(UbxConfigStore::Flash, index, value, true);
+    }
+    if ((layers & RamMask) && m_ram[index] != value) {
+        m_ram[index] = value;
+        emit valueChanged(UbxConfigKeys::catalog[index].id, value);
+    }
+}
+
+void UbxConfigDb::reload() {
+    for (int i = 0; i < UbxConfigKeys::Count; i++) {
+        quint64 value = UbxConfigKeys::catalog[i].defaultValue;
+        if (m_store.present(UbxConfigStore::Flash, i)) {
+            value = m_store.value(UbxConfigStore::Flash, i);
+        } else if (m_store.present(UbxConfigStore::Bbr, i)) {
+            value = m_store.value(UbxConfigStore::Bbr, i);
+        }
+        store(RamMask, i, value);
+    }
+}
+
+void UbxConfigDb::appendValue(QByteArray &out, quint32 id, quint64 value) {
+    char buffer[12];
+    qToLittleEndian<quint32>(id, buffer);
+    qToLittleEndian<quint64>(value, buffer + 4);
+    out.append(buffer, 4 + UbxConfigKeys::valueBytes(id));
+}
+
+int UbxConfigDb::parseValues(const char *data, int size, QVector<quint32> &ids, QVector<quint64> &values) {
+    int pos = 0;
+    while (pos < size) {
+        if (size - pos < 4) {
+            return -1;
+        }
+        const quint32 id = qFromLittleEndian<quint32>(data + pos);
+        const int bytes = UbxConfigKeys::valueBytes(id);
+        if (bytes == 0 || size - pos - 4 < bytes) {
+            return -1;
+        }
+
+        char buffer[8] = {};
+        memcpy(buffer, data + pos + 4, bytes);
+        ids.append(id);
+        values.append(qFromLittleEndian<quint64>(buffer));
+        pos += 4 + bytes;
+    }
+    return pos;
+}
+
+bool UbxConfigDb::handleValGet(const QByteArray &request, QByteArray &response) const {
+    if (request.size() < 4 || quint8(request[0]) != 0) {
+        return fail(tr("Malformed CFG-VALGET request"));
+    }
+
+    const quint8 layerCode = static_cast<quint8>(request[1]);
+    if (layerCode != Ram && layerCode != Bbr && layerCode != Flash && layerCode != Default) {
+        return fail(tr("CFG-VALGET layer %1 does not exist").arg(layerCode));
+    }
+    const Layer layer = static_cast<Layer>(layerCode);
+    const quint16 position = qFromLittleEndian<quint16>(request.constData() + 2);
+
+    response.resize(0);
+    response.append(char(0x01));    // Response version
+    response.append(char(layerCode));
+    response.append(request.mid(2, 2));
+
+    int skipped = 0;
+    int written = 0;
+    auto emitValue = [&](int index) {
+        const quint32 id = UbxConfigKeys::catalog[index].id;
+        quint64 out = 0;
+        if (!value(layer, id, out)) {
+            return;
+        }
+        if (skipped < position) {
+            skipped++;
+            return;
+        }
+        if (written < MaxValGetKeys) {
+            appendValue(response, id, out);
+            written++;
+        }
+    };
+
+    for (int pos = 4; pos + 4 <= request.size(); pos += 4) {
+        const quint32 id = qFromLittleEndian<quint32>(request.constData() + pos);
+        if (isWildcard(id)) {
+            for (int i = 0; i < UbxConfigKeys::Count; i++) {
+                if (matchesWildcard(id, UbxConfigKeys::catalog[i].id)) {
+                    emitValue(i);
+                }
+            }
+            continue;
+        }
+
+        const int index = UbxConfigKeys::indexOf(id);
+        if (index < 0) {
+            return fail(tr("CFG-VALGET for unknown key 0x%1").arg(id, 8, 16, QLatin1Char('0')));
+        }
+        emitValue(index);
+    }
+
+    if (written == 0) {
+        return fail(tr("CFG-VALGET matched no stored values"));
+    }
+    return true;
+}
+
+bool UbxConfigDb::handleValSet(const QByteArray &payload) {
+    if (payload.size() < 4) {
+        return fail(tr("Malformed CFG-VALSET"));
+    }
+
+    const quint8 version = static_cast<quint8>(payload[0]);
+    const quint8 layers = static_cast<quint8>(payload[1]) & (RamMask | BbrMask | FlashMask);
+    const quint8 transaction = version == 1 ? static_cast<quint8>(payload[2]) : TransactionNone;
+    if (version > 1 || transaction > TransactionApply) {
+        m_inTransaction = false;
+        m_transaction.clear();
+        return fail(tr("Unsupported CFG-VALSET version %1").arg(version));
+    }
+
+    QVector<quint32> ids;
+    QVector<quint64> values;
+    if (parseValues(payload.constData() + 4, payload.size() - 4, ids, values) < 0 || ids.size() > MaxValGetKeys) {
+        m_inTransaction = false;
+        m_transaction.clear();
+        return fail(tr("Malformed CFG-VALSET key/value list"));
+    }
+
+    // All keys are checked before any is applied
+    for (quint32 id : ids) {
+        if (UbxConfigKeys::indexOf(id) < 0) {
+            m_inTransaction = false;
+            m_transaction.clear();
+            return fail(tr("CFG-VALSET for unknown key 0x%1").arg(id, 8, 16, QLatin1Char('0')));
+        }
+    }
+
+    if (transaction == TransactionBegin) {
+        m_transaction.clear();
+        m_inTransaction = true;
+    } else if ((transaction == TransactionContinue || transaction == TransactionApply) && !m_inTransaction) {
+        return fail(tr("CFG-VALSET transaction was not started"));
+    }
+
+    if (transaction == TransactionNone) {
+        for (int i = 0; i < ids.size(); i++) {
+            store(layers, UbxConfigKeys::indexOf(ids[i]), truncateToSize(ids[i], values[i]));
+        }
+        return true;
+    }
+
+    for (int i = 0; i < ids.size(); i++) {
+        Pending pending;
+        pending.layers = layers;
+        pending.id = ids[i];
+        pending.value = truncateToSize(ids[i], values[i]);
+        m_transaction.append(pending);
+    }
+
+    if (transaction == TransactionApply) {
+        for (const Pending &pending : qAsConst(m_transaction)) {
+            store(pending.layers, UbxConfigKeys::indexOf(pending.id), pending.value);
+        }
+        m_transaction.clear();
+        m_inTransaction = false;
+    }
+    return true;
+}
+
+bool UbxConfigDb::handleValDel(const QByteArray &payload) {
+    if (payload.size() < 4 || quint8(payload[0]) > 1) {
+        return fail(tr("Malformed CFG-VALDEL"));
+    }
+
+    // Only the persistent layers can lose a key
+    const quint8 layers = static_cast<quint8>(payload[1]) & (BbrMask | FlashMask);
+
+    QVector<int> indexes;
+    for (int pos = 4; pos + 4 <= payload.size(); pos += 4) {
+        const quint32 id = qFromLittleEndian<quint32>(payload.constData() + pos);
+        if (isWildcard(id)) {
+            for (int i = 0; i < UbxConfigKeys::Count; i++) {
+                if (matchesWildcard(id, UbxConfigKeys::catalog[i].id)) {
+                    indexes.append(i);
+                }
+            }
+            continue;
+        }
+
+        const int index = UbxConfigKeys::indexOf(id);
+        if (index < 0) {
+            return fail(tr("CFG-VALDEL for unknown key 0x%1").arg(id, 8, 16, QLatin1Char('0')));
+        }
+        indexes.append(index);
+    }
+
+    for (int index : qAsConst(indexes)) {
+        if ((layers & BbrMask) && m_store.present(UbxConfigStore::Bbr, index)) {
+            m_store.write(UbxConfigStore::Bbr, index, 0, false);
+        }
+        if ((layers & FlashMask) && m_store.present(UbxConfigStore::Flash, index)) {
+            m_store.write(UbxConfigStore::Flash, index, 0, false);
+        }
+    }
+    return true;
+}
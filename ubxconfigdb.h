@@ -0,0 +1,83 @@
+#ifndef UBX_CONFIG_DB_H
+#define UBX_CONFIG_DB_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QVector>
+#include "ubxconfigkeys.h"
+#include "ubxconfigstore.h"
+
+// Receiver configuration as seen through CFG-VALSET/VALGET/VALDEL. Every
+// catalog key has a slot per layer, addressed by its catalog index, so a
+// bulk request costs one hash probe per key. RAM always holds a value;
+// BBR and Flash only hold the keys written to them and live in a
+// UbxConfigStore, persistent once a receiver file is opened.
+class UbxConfigDb : public QObject {
+    Q_OBJECT
+
+public:
+    enum Layer {
+        Ram = 0,
+        Bbr = 1,
+        Flash = 2,
+        Default = 7
+    };
+
+    enum LayerMask {
+        RamMask = 0x01,
+        BbrMask = 0x02,
+        FlashMask = 0x04
+    };
+
+    // One VALGET response carries at most this many values
+    static const int MaxValGetKeys = 64;
+
+    explicit UbxConfigDb(QObject *parent = nullptr);
+
+    bool value(Layer layer, quint32 id, quint64 &out) const;
+    quint64 value(quint32 id) const;   // RAM, 0 for unknown keys
+    bool set(quint8 layers, quint32 id, quint64 value);
+
+    // Rebuilds RAM from Flash, then BBR, then the defaults, as on start-up
+    void reload();
+
+    // Switches to the persistent layers of the receiver with this
+    // SEC-UNIQID and reloads RAM from them
+    bool openStore(quint64 uniqueId);
+    QString storeFileName() const { return m_store.fileName(); }
+    QString storeError() const { return m_store.errorString(); }
+
+    // Protocol handlers. A false return means the request is answered with
+    // ACK-NAK and left no trace in the database.
+    bool handleValGet(const QByteArray &request, QByteArray &response) const;
+    bool handleValSet(const QByteArray &payload);
+    bool handleValDel(const QByteArray &payload);
+
+    QString lastError() const { return m_lastError; }
+
+    // Key/value list encoding with per-key value sizes, little-endian
+    static void appendValue(QByteArray &out, quint32 id, quint64 value);
+    static int parseValues(const char *data, int size, QVector<quint32> &ids, QVector<quint64> &values);
+
+signals:
+    // A RAM value changed, i.e. the running configuration
+    void valueChanged(quint32 id, quint64 value);
+
+private:
+    struct Pending {
+        quint8 layers;
+        quint32 id;
+        quint64 value;
+    };
+
+    void store(quint8 layers, int index, quint64 value);
+    bool fail(const QString &error) const;
+
+    QVector<quint64> m_ram;
+    UbxConfigStore m_store;
+    QVector<Pending> m_transaction;
+    bool m_inTransaction = false;
+    mutable QString m_lastError;
+};
+
+#endif // UBX_CONFIG_DB_H
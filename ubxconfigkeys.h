@@ -0,0 +1,183 @@
+#ifndef UBX_CONFIG_KEYS_H
+#define UBX_CONFIG_KEYS_H
+
+#include <QtGlobal>
+#include <array>
+
+// Configuration keys known to the imitator (u-blox generation 9+ interface).
+// Bits 28..30 of a key ID give the value size, bits 16..23 the group and
+// bits 0..11 the item. The catalog is sorted by ID; lookups go through a
+// hash table built at compile time.
+namespace UbxConfigKeys {
+
+enum Size {
+    SizeBit = 1,    // L, stored in one byte
+    SizeOne = 2,    // U1/I1/E1/X1
+    SizeTwo = 3,    // U2/I2/E2/X2
+    SizeFour = 4,   // U4/I4/E4/X4/R4
+    SizeEight = 5   // U8/I8/X8/R8
+};
+
+constexpr int sizeCode(quint32 id) { return (id >> 28) & 0x07; }
+
+// Bytes the value occupies on the wire, 0 for an invalid size code
+constexpr int valueBytes(quint32 id) {
+    return sizeCode(id) == SizeBit ? 1
+         : sizeCode(id) == SizeOne ? 1
+         : sizeCode(id) == SizeTwo ? 2
+         : sizeCode(id) == SizeFour ? 4
+         : sizeCode(id) == SizeEight ? 8
+         : 0;
+}
+
+constexpr quint8 group(quint32 id) { return static_cast<quint8>((id >> 16) & 0xFF); }
+
+struct Key {
+    quint32 id;
+    const char *name;
+    quint64 defaultValue;
+};
+
+constexpr Key catalog[] = {
+    { 0x10050007, "CFG-TP-TP1_ENA", 1 },
+    { 0x10110025, "CFG-NAVSPG-ACKAIDING", 0 },
+    { 0x10220001, "CFG-ODO-USE_ODO", 0 },
+    { 0x10310001, "CFG-SIGNAL-GPS_L1CA_ENA", 1 },
+    { 0x1031001f, "CFG-SIGNAL-GPS_ENA", 1 },
+    { 0x10310020, "CFG-SIGNAL-SBAS_ENA", 1 },
+    { 0x10310021, "CFG-SIGNAL-GAL_ENA", 1 },
+    { 0x10310022, "CFG-SIGNAL-BDS_ENA", 1 },
+    { 0x10310024, "CFG-SIGNAL-QZSS_ENA", 1 },
+    { 0x10310025, "CFG-SIGNAL-GLO_ENA", 1 },
+    { 0x10360002, "CFG-SBAS-USE_TESTMODE", 0 },
+    { 0x10360003, "CFG-SBAS-USE_RANGING", 1 },
+    { 0x1041000d, "CFG-ITFM-ENABLE", 0 },
+    { 0x10730001, "CFG-UART1INPROT-UBX", 1 },
+    { 0x10730002, "CFG-UART1INPROT-NMEA", 1 },
+    { 0x10740001, "CFG-UART1OUTPROT-UBX", 1 },
+    { 0x10740002, "CFG-UART1OUTPROT-NMEA", 1 },
+    { 0x10750001, "CFG-UART2INPROT-UBX", 1 },
+    { 0x10760001, "CFG-UART2OUTPROT-UBX", 1 },
+    { 0x10770001, "CFG-USBINPROT-UBX", 1 },
+    { 0x10780001, "CFG-USBOUTPROT-UBX", 1 },
+    { 0x10a3002e, "CFG-HW-ANT_CFG_VOLTCTRL", 0 },
+    { 0x20110011, "CFG-NAVSPG-FIXMODE", 3 },
+    { 0x2011001c, "CFG-NAVSPG-UTCSTANDARD", 0 },
+    { 0x20110021, "CFG-NAVSPG-DYNMODEL", 0 },
+    { 0x201100a4, "CFG-NAVSPG-INFIL_MINELEV", 10 },
+    { 0x201100aa, "CFG-NAVSPG-INFIL_NCNOTHRS", 0 },
+    { 0x201100ab, "CFG-NAVSPG-INFIL_CNOTHRS", 0 },
+    { 0x20210003, "CFG-RATE-TIMEREF", 0 },
+    { 0x20410001, "CFG-ITFM-BBTHRESHOLD", 3 },
+    { 0x20410002, "CFG-ITFM-CWTHRESHOLD", 15 },
+    { 0x20910006, "CFG-MSGOUT-UBX_NAV_PVT_I2C", 0 },
+    { 0x20910007, "CFG-MSGOUT-UBX_NAV_PVT_UART1", 0 },
+    { 0x20910008, "CFG-MSGOUT-UBX_NAV_PVT_UART2", 0 },
+    { 0x20910009, "CFG-MSGOUT-UBX_NAV_PVT_USB", 0 },
+    { 0x2091000a, "CFG-MSGOUT-UBX_NAV_PVT_SPI", 0 },
+    { 0x20910015, "CFG-MSGOUT-UBX_NAV_SAT_I2C", 0 },
+    { 0x20910016, "CFG-MSGOUT-UBX_NAV_SAT_UART1", 0 },
+    { 0x20910017, "CFG-MSGOUT-UBX_NAV_SAT_UART2", 0 },
+    { 0x20910018, "CFG-MSGOUT-UBX_NAV_SAT_USB", 0 },
+    { 0x20910019, "CFG-MSGOUT-UBX_NAV_SAT_SPI", 0 },
+    { 0x2091001a, "CFG-MSGOUT-UBX_NAV_STATUS_I2C", 0 },
+    { 0x2091001b, "CFG-MSGOUT-UBX_NAV_STATUS_UART1", 0 },
+    { 0x2091001c, "CFG-MSGOUT-UBX_NAV_STATUS_UART2", 0 },
+    { 0x2091001d, "CFG-MSGOUT-UBX_NAV_STATUS_USB", 0 },
+    { 0x2091001e, "CFG-MSGOUT-UBX_NAV_STATUS_SPI", 0 },
+    { 0x2091005b, "CFG-MSGOUT-UBX_NAV_TIMEUTC_I2C", 0 },
+    { 0x2091005c, "CFG-MSGOUT-UBX_NAV_TIMEUTC_UART1", 0 },
+    { 0x2091005d, "CFG-MSGOUT-UBX_NAV_TIMEUTC_UART2", 0 },
+    { 0x2091005e, "CFG-MSGOUT-UBX_NAV_TIMEUTC_USB", 0 },
+    { 0x2091005f, "CFG-MSGOUT-UBX_NAV_TIMEUTC_SPI", 0 },
+    { 0x209101b4, "CFG-MSGOUT-UBX_MON_HW_I2C", 0 },
+    { 0x209101b5, "CFG-MSGOUT-UBX_MON_HW_UART1", 0 },
+    { 0x209101b6, "CFG-MSGOUT-UBX_MON_HW_UART2", 0 },
+    { 0x209101b7, "CFG-MSGOUT-UBX_MON_HW_USB", 0 },
+    { 0x209101b8, "CFG-MSGOUT-UBX_MON_HW_SPI", 0 },
+    { 0x20910359, "CFG-MSGOUT-UBX_MON_RF_I2C", 0 },
+    { 0x2091035a, "CFG-MSGOUT-UBX_MON_RF_UART1", 0 },
+    { 0x2091035b, "CFG-MSGOUT-UBX_MON_RF_UART2", 0 },
+    { 0x2091035c, "CFG-MSGOUT-UBX_MON_RF_USB", 0 },
+    { 0x2091035d, "CFG-MSGOUT-UBX_MON_RF_SPI", 0 },
+    { 0x20920002, "CFG-INFMSG-UBX_UART1", 0 },
+    { 0x30210001, "CFG-RATE-MEAS", 1000 },
+    { 0x30210002, "CFG-RATE-NAV", 1 },
+    { 0x40520001, "CFG-UART1-BAUDRATE", 38400 },
+    { 0x40530001, "CFG-UART2-BAUDRATE", 38400 },
+};
+
+constexpr int Count = sizeof(catalog) / sizeof(catalog[0]);
+
+enum : quint32 {
+    CFG_RATE_MEAS = 0x30210001,
+    CFG_RATE_NAV = 0x30210002,
+    CFG_UART1_BAUDRATE = 0x40520001,
+    CFG_UART2_BAUDRATE = 0x40530001
+};
+
+namespace detail {
+
+constexpr int IndexSize = 256;   // Power of two, at least twice Count
+
+constexpr int slotOf(quint32 id) {
+    return static_cast<int>((id * 0x9E3779B1u) >> 24) & (IndexSize - 1);
+}
+
+constexpr bool isSorted() {
+    for (int i = 1; i < Count; i++) {
+        if (catalog[i - 1].id >= catalog[i].id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool sizesValid() {
+    for (int i = 0; i < Count; i++) {
+        if (valueBytes(catalog[i].id) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Open addressing with linear probing, -1 marks an empty slot
+constexpr std::array<qint16, IndexSize> buildIndex() {
+    std::array<qint16, IndexSize> index {};
+    for (int i = 0; i < IndexSize; i++) {
+        index[i] = -1;
+    }
+    for (int i = 0; i < Count; i++) {
+        int slot = slotOf(catalog[i].id);
+        while (index[slot] != -1) {
+            slot = (slot + 1) & (IndexSize - 1);
+        }
+        index[slot] = static_cast<qint16>(i);
+    }
+    return index;
+}
+
+constexpr std::array<qint16, IndexSize> index = buildIndex();
+
+static_assert(2 * Count <= IndexSize, "Grow IndexSize with the catalog");
+static_assert(isSorted(), "Keep the catalog sorted by key ID");
+static_assert(sizesValid(), "Key ID with an invalid size code");
+
+} // namespace detail
+
+// Catalog position of a key, -1 if the key is unknown
+constexpr int indexOf(quint32 id) {
+    for (int slot = detail::slotOf(id);; slot = (slot + 1) & (detail::IndexSize - 1)) {
+        const int i = detail::index[slot];
+        if (i < 0 || catalog[i].id == id) {
+            return i;
+        }
+    }
+}
+
+static_assert(indexOf(CFG_UART1_BAUDRATE) >= 0, "Catalog lookup");
+
+} // namespace UbxConfigKeys
+
+#endif // UBX_CONFIG_KEYS_H
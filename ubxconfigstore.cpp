@@ -0,0 +1,300 @@
+#include "ubxconfigstore.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QVector>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Host byte order: the file belongs to the machine that runs the fleet
+struct UbxConfigStore::Header {
+    char magic[4];
+    quint32 version;
+    quint32 keyCount;
+    quint32 catalogHash;
+    quint64 checkpointSeq;  // Last journal entry folded into the arrays
+    quint64 nextSeq;
+    char reserved[32];
+};
+
+struct UbxConfigStore::JournalEntry {
+    quint64 seq;
+    quint64 value;
+    quint16 index;
+    quint8 layer;
+    quint8 present;
+    quint32 checksum;
+};
+
+namespace {
+
+const char s_magic[4] = { 'U', 'B', 'X', 'C' };
+const quint32 s_formatVersion = 1;
+
+struct Layout {
+    qint64 journal;
+    qint64 ids;
+    qint64 values;
+    qint64 present;
+    qint64 size;
+
+    static Layout forCount(int count, int headerSize, int entrySize, int journalCapacity) {
+        Layout layout;
+        layout.journal = headerSize;
+        layout.ids = layout.journal + qint64(entrySize) * journalCapacity;
+        layout.values = (layout.ids + 4 * count + 7) & ~qint64(7);
+        layout.present = layout.values + 8 * qint64(count) * UbxConfigStore::LayerCount;
+        layout.size = layout.present + qint64(count) * UbxConfigStore::LayerCount;
+        return layout;
+    }
+};
+
+quint32 fnv1a(const void *data, int size, quint32 hash = 2166136261u) {
+    const uchar *bytes = static_cast<const uchar *>(data);
+    for (int i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+UbxConfigStore::UbxConfigStore() {
+    m_memory.resize(static_cast<int>(fileSize()));
+    attach(reinterpret_cast<uchar *>(m_memory.data()));
+    create(QString());
+}
+
+UbxConfigStore::~UbxConfigStore() {
+    close();
+}
+
+QString UbxConfigStore::fileNameFor(quint64 uniqueId) {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/receivers";
+    QDir().mkpath(dir);
+    return dir + QString("/%1.ubxcfg").arg(uniqueId, 10, 16, QLatin1Char('0'));
+}
+
+quint32 UbxConfigStore::catalogHash() {
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < UbxConfigKeys::Count; i++) {
+        hash = fnv1a(&UbxConfigKeys::catalog[i].id, sizeof(quint32), hash);
+    }
+    return hash;
+}
+
+qint64 UbxConfigStore::fileSize() {
+    return Layout::forCount(UbxConfigKeys::Count, sizeof(Header), sizeof(JournalEntry), JournalCapacity).size;
+}
+
+quint32 UbxConfigStore::entryChecksum(const JournalEntry &entry) {
+    static_assert(sizeof(JournalEntry) == 24, "Journal entries are written as raw bytes");
+    return fnv1a(&entry, offsetof(JournalEntry, checksum));
+}
+
+void UbxConfigStore::attach(uchar *base) {
+    const Layout layout = Layout::forCount(UbxConfigKeys::Count, sizeof(Header), sizeof(JournalEntry), JournalCapacity);
+    m_base = base;
+    m_header = reinterpret_cast<Header *>(base);
+    m_journal = reinterpret_cast<JournalEntry *>(base + layout.journal);
+    m_ids = reinterpret_cast<quint32 *>(base + layout.ids);
+    for (int layer = 0; layer < LayerCount; layer++) {
+        m_values[layer] = reinterpret_cast<quint64 *>(base + layout.values) + layer * UbxConfigKeys::Count;
+        m_present[layer] = base + layout.present + layer * UbxConfigKeys::Count;
+    }
+}
+
+// Lays out an empty store at m_base, and writes it to fileName if given
+bool UbxConfigStore::create(const QString &fileName) {
+    memset(m_base, 0, static_cast<size_t>(fileSize()));
+    memcpy(m_header->magic, s_magic, sizeof(s_magic));
+    m_header->version = s_formatVersion;
+    m_header->keyCount = UbxConfigKeys::Count;
+    m_header->catalogHash = catalogHash();
+    m_header->checkpointSeq = 0;
+    m_header->nextSeq = 1;
+    for (int i = 0; i < UbxConfigKeys::Count; i++) {
+        m_ids[i] = UbxConfigKeys::catalog[i].id;
+    }
+
+    if (fileName.isEmpty()) {
+        return true;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(reinterpret_cast<const char *>(m_base), fileSize()) != fileSize()) {
+        m_error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool UbxConfigStore::open(const QString &fileName) {
+    close();
+
+    // Only a file of the current format and catalog is mapped as is. One
+    // written for another catalog is migrated, anything else is replaced.
+    bool usable = false;
+    QByteArray previous;
+    QFile existing(fileName);
+    if (existing.open(QIODevice::ReadOnly)) {
+        const QByteArray head = existing.read(sizeof(Header));
+        if (head.size() == int(sizeof(Header))) {
+            const Header *header = reinterpret_cast<const Header *>(head.constData());
+            const bool ours = memcmp(header->magic, s_magic, sizeof(s_magic)) == 0
+                              && header->version == s_formatVersion;
+            if (ours && header->catalogHash == catalogHash() && existing.size() == fileSize()) {
+                usable = true;
+            } else if (ours) {
+                previous = head + existing.readAll();
+            }
+        }
+        existing.close();
+    }
+
+    if (!usable && !create(fileName)) {
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    uchar *mapped = nullptr;
+    if (m_file.open(QIODevice::ReadWrite)) {
+        mapped = m_file.map(0, fileSize());
+    }
+    if (!mapped) {
+        m_error = m_file.errorString();
+        m_file.close();
+        attach(reinterpret_cast<uchar *>(m_memory.data()));
+        create(QString());
+        return false;
+    }
+
+    attach(mapped);
+    if (!previous.isEmpty()) {
+        migrate(reinterpret_cast<const uchar *>(previous.constData()), previous.size());
+    }
+    replay();
+    return true;
+}
+
+void UbxConfigStore::close() {
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    checkpoint();
+    m_file.unmap(m_base);
+    m_file.close();
+
+    // Back to an empty in-memory store
+    attach(reinterpret_cast<uchar *>(m_memory.data()));
+    create(QString());
+}
+
+// Carries values over from a file written for an older catalog, by key ID
+void UbxConfigStore::migrate(const uchar *old, qint64 size) {
+    const Header *header = reinterpret_cast<const Header *>(old);
+    const int count = static_cast<int>(header->keyCount);
+    const Layout layout = Layout::forCount(count, sizeof(Header), sizeof(JournalEntry), JournalCapacity);
+    if (count <= 0 || count > 0xFFFF || size < layout.size) {
+        return;
+    }
+
+    const quint32 *ids = reinterpret_cast<const quint32 *>(old + layout.ids);
+    QVector<int> newIndex(count);
+    for (int i = 0; i < count; i++) {
+        newIndex[i] = UbxConfigKeys::indexOf(ids[i]);
+    }
+
+    for (int layer = 0; layer < LayerCount; layer++) {
+        const quint64 *values = reinterpret_cast<const quint64 *>(old + layout.values) + layer * count;
+        const quint8 *present = old + layout.present + layer * count;
+        for (int i = 0; i < count; i++) {
+            if (newIndex[i] >= 0) {
+                m_values[layer][newIndex[i]] = values[i];
+                m_present[layer][newIndex[i]] = present[i];
+            }
+        }
+    }
+
+    // Pending entries of the old journal, remapped the same way
+    const JournalEntry *journal = reinterpret_cast<const JournalEntry *>(old + layout.journal);
+    for (quint64 seq = header->checkpointSeq + 1;; seq++) {
+        const JournalEntry &entry = journal[seq % JournalCapacity];
+        if (entry.seq != seq || entry.checksum != entryChecksum(entry)
+            || entry.index >= count || entry.layer >= LayerCount || newIndex[entry.index] < 0) {
+            break;
+        }
+        m_values[entry.layer][newIndex[entry.index]] = entry.value;
+        m_present[entry.layer][newIndex[entry.index]] = entry.present;
+    }
+
+    checkpoint();
+}
+
+void UbxConfigStore::replay() {
+    quint64 seq = m_header->checkpointSeq + 1;
+    for (;; seq++) {
+        const JournalEntry &entry = m_journal[seq % JournalCapacity];
+        if (entry.seq != seq || entry.checksum != entryChecksum(entry)
+            || entry.index >= UbxConfigKeys::Count || entry.layer >= LayerCount) {
+            break;
+        }
+        m_values[entry.layer][entry.index] = entry.value;
+        m_present[entry.layer][entry.index] = entry.present;
+    }
+
+    if (seq != m_header->checkpointSeq + 1) {
+        m_header->nextSeq = seq;
+        checkpoint();
+    }
+}
+
+void UbxConfigStore::write(Layer layer, int index, quint64 value, bool present) {
+    if (m_header->nextSeq - 1 - m_header->checkpointSeq >= quint64(JournalCapacity)) {
+        checkpoint();
+    }
+
+    const quint64 seq = m_header->nextSeq++;
+    JournalEntry &entry = m_journal[seq % JournalCapacity];
+    entry.seq = seq;
+    entry.value = value;
+    entry.index = static_cast<quint16>(index);
+    entry.layer = static_cast<quint8>(layer);
+    entry.present = present ? 1 : 0;
+    entry.checksum = entryChecksum(entry);
+    sync(&entry, sizeof(entry));
+
+    m_values[layer][index] = value;
+    m_present[layer][index] = entry.present;
+}
+
+void UbxConfigStore::checkpoint() {
+    const Layout layout = Layout::forCount(UbxConfigKeys::Count, sizeof(Header), sizeof(JournalEntry), JournalCapacity);
+    sync(m_base + layout.values, layout.size - layout.values);
+
+    m_header->checkpointSeq = m_header->nextSeq - 1;
+    sync(m_header, sizeof(Header));
+}
+
+void UbxConfigStore::sync(const void *data, qint64 size) {
+#ifdef Q_OS_UNIX
+    if (!m_file.isOpen()) {
+        return;
+    }
+    static const quintptr pageSize = static_cast<quintptr>(sysconf(_SC_PAGESIZE));
+    const quintptr start = reinterpret_cast<quintptr>(data) & ~(pageSize - 1);
+    const quintptr end = reinterpret_cast<quintptr>(data) + static_cast<quintptr>(size);
+    msync(reinterpret_cast<void *>(start), end - start, MS_SYNC);
+#else
+    // The mapping is written back by the OS; durability is best effort here
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+#endif
+}
@@ -0,0 +1,72 @@
+#ifndef UBX_CONFIG_STORE_H
+#define UBX_CONFIG_STORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include "ubxconfigkeys.h"
+
+// Battery-backed RAM and Flash layers of one simulated receiver, kept in a
+// memory-mapped file. The value arrays are used in place, so opening a
+// store is a map and a header check. Every write is first appended to a
+// small write-ahead journal; on open, journal entries newer than the last
+// checkpoint are replayed over the arrays. Without a file the same layout
+// lives in memory.
+class UbxConfigStore {
+public:
+    enum Layer {
+        Bbr = 0,
+        Flash = 1,
+        LayerCount = 2
+    };
+
+    static const int JournalCapacity = 64;
+
+    UbxConfigStore();
+    ~UbxConfigStore();
+
+    UbxConfigStore(const UbxConfigStore &) = delete;
+    UbxConfigStore &operator=(const UbxConfigStore &) = delete;
+
+    // Per-receiver file under the application data directory
+    static QString fileNameFor(quint64 uniqueId);
+
+    bool open(const QString &fileName);
+    void close();
+    bool isMapped() const { return m_file.isOpen(); }
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+
+    bool present(Layer layer, int index) const { return m_present[layer][index] != 0; }
+    quint64 value(Layer layer, int index) const { return m_values[layer][index]; }
+    void write(Layer layer, int index, quint64 value, bool present);
+
+    // Makes the arrays durable and empties the journal
+    void checkpoint();
+
+private:
+    struct Header;
+    struct JournalEntry;
+
+    static quint32 catalogHash();
+    static qint64 fileSize();
+    static quint32 entryChecksum(const JournalEntry &entry);
+
+    void attach(uchar *base);
+    bool create(const QString &fileName);
+    void migrate(const uchar *old, qint64 size);
+    void replay();
+    void sync(const void *data, qint64 size);
+
+    QFile m_file;
+    QByteArray m_memory;    // Backing store when no file is open
+    uchar *m_base = nullptr;
+    Header *m_header = nullptr;
+    JournalEntry *m_journal = nullptr;
+    quint32 *m_ids = nullptr;
+    quint64 *m_values[LayerCount] = {};
+    quint8 *m_present[LayerCount] = {};
+    QString m_error;
+};
+
+#endif // UBX_CONFIG_STORE_H
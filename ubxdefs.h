@@ -25,7 +25,8 @@ enum UbxCfgId {
     UBX_CFG_NAV5 = 0x24,
     UBX_CFG_ITFM = 0x39,
     UBX_CFG_VALSET = 0x8A,
-    UBX_CFG_VALGET = 0x8B
+    UBX_CFG_VALGET = 0x8B,
+    UBX_CFG_VALDEL = 0x8C
 };
 
 enum UbxMonId {
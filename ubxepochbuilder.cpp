@@ -0,0 +1,273 @@
+#include "ubxepochbuilder.h"
+#include "ubxdefs.h"
+
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <QtMath>
+
+int UbxEpochBuilder::navSatCount(int configured) {
+    return qBound(0, configured, Constellation::MaxSatellites);
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildNavPvt(const SimState &state, const UbxTime &now) {
+    if (m_cache.isDirty(UbxFrameCache::FrameNavPvt)) {
+        char *payload = m_cache.beginStore(UbxFrameCache::FrameNavPvt, UBX_CLASS_NAV, UBX_NAV_PVT, 92);
+
+        qint32 lat = static_cast<qint32>(state.lat * 1e7);
+        qint32 lon = static_cast<qint32>(state.lon * 1e7);
+        qint32 height = static_cast<qint32>(state.height * 1000);
+        quint32 gSpeed = static_cast<quint32>(state.speed * 1000);
+        quint32 headMot = static_cast<quint32>(state.heading * 1e5);
+        quint8 fixType = static_cast<quint8>(state.numSats > 0 ? 3 : 0);
+        quint8 numSV = static_cast<quint8>(m_navSatTracked >= 0 ? m_navSatTracked : state.numSats);
+        qint32 velN = static_cast<qint32>(state.velN * 1000);
+        qint32 velE = static_cast<qint32>(state.velE * 1000);
+        qint32 velD = static_cast<qint32>(-state.velU * 1000);
+        quint32 hAcc = static_cast<quint32>(state.hAcc * 1000);
+        quint32 vAcc = static_cast<quint32>(state.vAcc * 1000);
+        quint32 sAcc = static_cast<quint32>(state.sAcc * 1000);
+        quint16 pDOP = static_cast<quint16>(state.pdop * 100);
+
+        payload[11] = 0x07; // valid: date, time, fully resolved
+
+        qToLittleEndian<qint32>(lon, payload + 24); // lon
+        qToLittleEndian<qint32>(lat, payload + 28); // lat
+        qToLittleEndian<qint32>(height, payload + 32); // height
+        qToLittleEndian<qint32>(height, payload + 36); // hMSL, no geoid model
+        qToLittleEndian<qint32>(velN, payload + 48); // velN
+        qToLittleEndian<qint32>(velE, payload + 52); // velE
+        qToLittleEndian<qint32>(velD, payload + 56); // velD
+        qToLittleEndian<quint32>(gSpeed, payload + 60); // gSpeed
+        qToLittleEndian<quint32>(headMot, payload + 64); // headMot
+        qToLittleEndian<quint32>(hAcc, payload + 40); // hAcc
+        qToLittleEndian<quint32>(vAcc, payload + 44); // vAcc
+        qToLittleEndian<quint32>(sAcc, payload + 68); // sAcc
+        qToLittleEndian<quint16>(pDOP, payload + 76); // pDOP
+        payload[20] = fixType; // fixType
+        payload[23] = numSV;   // numSV
+        if (state.headVehValid) {
+            qToLittleEndian<qint32>(static_cast<qint32>(state.headVeh * 1e5), payload + 84); // headVeh
+            payload[21] = static_cast<char>(payload[21] | 0x20); // flags: headVehValid
+        }
+
+        m_cache.finishStore(UbxFrameCache::FrameNavPvt);
+    }
+
+    // Only iTOW and the UTC date/time (payload bytes 0..10) change per epoch
+    char timeBytes[11];
+    qToLittleEndian<quint32>(now.iTOW, timeBytes); // iTOW
+    qToLittleEndian<quint16>(now.year, timeBytes + 4);
+    timeBytes[6] = static_cast<char>(now.month);
+    timeBytes[7] = static_cast<char>(now.day);
+    timeBytes[8] = static_cast<char>(now.hour);
+    timeBytes[9] = static_cast<char>(now.minute);
+    timeBytes[10] = static_cast<char>(now.second);
+    m_cache.patch(UbxFrameCache::FrameNavPvt, 0, timeBytes, sizeof(timeBytes));
+
+    return frameOf(m_cache.frame(UbxFrameCache::FrameNavPvt));
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildNavStatus(const SimState &state, const UbxTime &now) {
+    if (m_cache.isDirty(UbxFrameCache::FrameNavStatus)) {
+        QByteArray payload(16, 0x00);
+
+        quint8 fixType = static_cast<quint8>(state.statusFixType);
+        quint32 ttff = static_cast<quint32>(state.ttff);
+
+        payload[4] = fixType; // fixType
+        qToLittleEndian<quint32>(ttff, payload.data() + 8); // ttff
+
+        m_cache.store(UbxFrameCache::FrameNavStatus, UBX_CLASS_NAV, UBX_NAV_STATUS, payload);
+    }
+
+    char iTowBytes[4];
+    qToLittleEndian<quint32>(now.iTOW, iTowBytes);
+    m_cache.patch(UbxFrameCache::FrameNavStatus, 0, iTowBytes, sizeof(iTowBytes));
+
+    return frameOf(m_cache.frame(UbxFrameCache::FrameNavStatus));
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildNavSat(const SimState &state, quint32 epoch, const UbxTime &now,
+                                                   const RfScenario::Sample &rf) {
+    QRandomGenerator *generator = QRandomGenerator::global();
+    const double cnoDrop = rf.cnoDrop();
+
+    // The constellation has exactly the configured number of SVs, so every
+    // SV keeps its place in the sky from one epoch to the next. Those above
+    // the horizon are reported first, the rest untracked with no signal
+    const int numSvs = navSatCount(state.numSatsSat);
+    if (numSvs > 0 && m_constellation.satelliteCount() != numSvs) {
+        m_constellation = Constellation(numSvs);
+    }
+    const Constellation::Snapshot &snapshot = m_constellation.advance(epoch, now.msecs);
+    Constellation::LookAngle all[Constellation::MaxSatellites];
+    Constellation::visible(snapshot, state.lat, state.lon, state.height, -90.0, all);
+    // Stable split by hand, std::stable_partition takes a heap buffer
+    Constellation::LookAngle look[Constellation::MaxSatellites];
+    int numVisible = 0;
+    for (int i = 0; i < numSvs; i++) {
+        if (all[i].elevation >= 0.0) {
+            look[numVisible++] = all[i];
+        }
+    }
+    for (int i = 0, next = numVisible; i < numSvs; i++) {
+        if (all[i].elevation < 0.0) {
+            look[next++] = all[i];
+        }
+    }
+    char *payload = m_arena.beginFrame(UBX_CLASS_NAV, UBX_NAV_SAT, 8 + 12 * numSvs);
+
+    qToLittleEndian<quint32>(snapshot.iTOW, payload);
+    payload[4] = static_cast<char>(state.satVersion); // version
+    payload[5] = static_cast<char>(numSvs); // numSvs
+
+    quint8 qualityInd = static_cast<quint8>(state.qualityInd);
+    quint8 health = static_cast<quint8>(state.health);
+    bool svUsed = state.svUsed;
+    bool diffCorr = state.diffCorr;
+    bool smoothed = state.smoothed;
+    quint8 orbitSource = static_cast<quint8>(state.orbitSource);
+    double prResMin = state.prResMin;
+    double prResMax = state.prResMax;
+
+    quint32 flags = 0;
+    flags |= (qualityInd & 0x07) << 0;  // qualityInd (bits 0-2)
+    flags |= (svUsed ? 1 : 0) << 3;     // svUsed (bit 3)
+    flags |= (health & 0x03) << 4;      // health (bits 4-5)
+    flags |= (diffCorr ? 1 : 0) << 6;   // diffCorr (bit 6)
+    flags |= (smoothed ? 1 : 0) << 7;   // smoothed (bit 7)
+    flags |= (orbitSource & 0x07) << 8; // orbitSource (bits 8-10)
+    if (orbitSource == 1) flags |= 1 << 11; // ephAvail if ephemeris
+    flags |= 1 << 12; // almAvail (always available)
+
+    for (int i = 0; i < numSvs; i++) {
+        char *sat = payload + 8 + 12 * i;
+        const Constellation::Satellite &sv = snapshot.satellites[look[i].index];
+        const bool tracked = i < numVisible;
+        sat[0] = static_cast<char>(sv.gnssId); // gnssId
+        sat[1] = static_cast<char>(sv.svId); // svId
+        // 30-50 dBHz rising with elevation, less interference
+        const int cno = tracked ? qRound(30.0 + 20.0 * qSin(qDegreesToRadians(look[i].elevation)) - cnoDrop) : 0;
+        sat[2] = static_cast<char>(qMax(0, cno)); // cno
+        sat[3] = static_cast<char>(qRound(look[i].elevation)); // elev
+
+        qint16 azim = static_cast<qint16>(qRound(look[i].azimuth) % 360);
+        qToLittleEndian<qint16>(azim, sat + 4);
+
+        double prResMeters = prResMin + generator->bounded(prResMax - prResMin);
+        qint16 prRes = static_cast<qint16>(prResMeters * 10); // convert to 0.1m units
+        qToLittleEndian<qint16>(prRes, sat + 6);
+
+        // Below the horizon: no signal, not used, orbit data only
+        qToLittleEndian<quint32>(tracked ? flags : flags & ~0xFFu, sat + 8);
+    }
+
+    // NAV-PVT reports the SVs tracked here from the next epoch on
+    if (m_navSatTracked != numVisible) {
+        m_navSatTracked = numVisible;
+        m_cache.invalidate(UbxFrameCache::FrameNavPvt);
+    }
+
+    return m_arena.finishFrame();
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildNavTimeUtc(const SimState &state, const UbxTime &now) {
+    char *payload = m_arena.beginFrame(UBX_CLASS_NAV, UBX_NAV_TIMEUTC, 20);
+
+    qToLittleEndian<quint32>(now.iTOW, payload);
+
+    quint32 tAcc = static_cast<quint32>(state.timeUtcTAcc);
+    qToLittleEndian<quint32>(tAcc, payload + 4);
+
+    qint32 nano = static_cast<qint32>(state.timeUtcNano);
+    qToLittleEndian<qint32>(nano, payload + 8);
+
+    qToLittleEndian<quint16>(now.year, payload + 12);
+    payload[14] = static_cast<char>(now.month);
+    payload[15] = static_cast<char>(now.day);
+    payload[16] = static_cast<char>(now.hour);
+    payload[17] = static_cast<char>(now.minute);
+    payload[18] = static_cast<char>(now.second);
+
+    quint8 validFlags = 0;
+    switch(state.timeUtcValid) {
+    case 0: validFlags |= 0x01; break; // Valid TOW
+    case 1: validFlags |= 0x02; break; // Valid WKN
+    case 2: validFlags |= 0x04; break; // Valid UTC
+    case 3: validFlags |= 0x08; break; // Authenticated
+    }
+
+    quint8 utcStandard = static_cast<quint8>(state.timeUtcStandard);
+    validFlags |= (utcStandard << 4);
+
+    payload[19] = validFlags;
+
+    return m_arena.finishFrame();
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildMonHw(const SimState &state, const RfScenario::Sample &rf,
+                                                  MonHwInfo &info) {
+    char *payload = m_arena.beginFrame(UBX_CLASS_MON, UBX_MON_HW, 60);
+
+    info.noise = static_cast<quint16>(qMin(65535.0, state.hwNoise * rf.noiseFactor()));
+    qToLittleEndian<quint16>(info.noise, payload + 16);
+
+    info.agcPercent = state.hwAgc * rf.agcFactor();
+    quint16 agc = static_cast<quint16>(info.agcPercent * 81.91);
+    qToLittleEndian<quint16>(agc, payload + 18);
+
+    info.antStatus = rf.antStatus >= 0 ? rf.antStatus : state.hwAntStatus;
+    payload[20] = static_cast<quint8>(info.antStatus);
+
+    payload[21] = static_cast<quint8>(state.hwAntPower);
+
+    quint8 flags = 0;
+    flags |= ((rf.active ? rf.jammingState() : state.hwJamming) << 2);
+    payload[22] = flags;
+
+    info.jamInd = qMax(static_cast<quint8>(state.hwCwSuppression), rf.jamInd());
+    payload[45] = static_cast<char>(info.jamInd);
+
+    return m_arena.finishFrame();
+}
+
+UbxPacketArena::Frame UbxEpochBuilder::buildMonRf(const SimState &state, const RfScenario::Sample &rf,
+                                                  MonRfInfo &info) {
+    const int numBlocks = state.rfBlocks;
+    const int payloadSize = 4 + 24 * numBlocks;
+    char *payload = m_arena.beginFrame(UBX_CLASS_MON, UBX_MON_RF, payloadSize);
+
+    payload[0] = static_cast<quint8>(state.rfVersion);
+    payload[1] = static_cast<quint8>(numBlocks);
+
+    // The scenario, if one runs, scales the configured levels
+    const quint8 jamState = rf.active ? rf.jammingState() : static_cast<quint8>(state.rfJamState);
+    const quint8 antStatus = static_cast<quint8>(rf.antStatus >= 0 ? rf.antStatus : state.rfAntStatus);
+    const quint16 noisePerMS = static_cast<quint16>(qMin(65535.0, state.rfNoise * 100 * rf.noiseFactor()));
+    const quint16 agcCnt = static_cast<quint16>(state.rfAgc * 100 * rf.agcFactor());
+    info.agcPercent = state.rfAgc * rf.agcFactor();
+    info.cwSuppression = qMax(static_cast<quint8>(state.rfCwSuppression), rf.jamInd());
+
+    for (int i = 0; i < numBlocks; i++) {
+        int offset = 4 + i * 24;
+
+        payload[offset] = static_cast<quint8>(i); // blockId
+        payload[offset+1] = jamState; // flags
+        payload[offset+2] = antStatus; // antStatus
+        payload[offset+3] = static_cast<quint8>(state.rfAntPower); // antPower
+
+        qToLittleEndian<quint32>(0x00000000, payload + offset + 4);
+
+        qToLittleEndian<quint16>(noisePerMS, payload + offset + 12);
+        qToLittleEndian<quint16>(agcCnt, payload + offset + 14);
+
+        payload[offset+16] = info.cwSuppression;
+
+        payload[offset+17] = static_cast<qint8>(0);    // ofsI
+        payload[offset+18] = static_cast<quint8>(128); // magI
+        payload[offset+19] = static_cast<qint8>(0);    // ofsQ
+        payload[offset+20] = static_cast<quint8>(128); // magQ
+    }
+
+    return m_arena.finishFrame();
+}
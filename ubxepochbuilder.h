@@ -0,0 +1,57 @@
+#ifndef UBX_EPOCH_BUILDER_H
+#define UBX_EPOCH_BUILDER_H
+
+#include "constellation.h"
+#include "rfscenario.h"
+#include "simstate.h"
+#include "ubxframecache.h"
+#include "ubxpacketarena.h"
+#include "ubxtime.h"
+
+// Frames of the periodic navigation epoch, built from a SimState snapshot
+// without touching a widget. NAV-PVT and NAV-STATUS live in the frame
+// cache and only get the time patched in, the rest are built in the arena.
+// Returned frames stay valid until the arena is rewound or the cache slot
+// rebuilt, which is long enough to hand them to a transport.
+class UbxEpochBuilder {
+public:
+    // Values the GUI shows next to the MON frames
+    struct MonHwInfo {
+        quint16 noise;
+        double agcPercent;
+        int antStatus;
+        quint8 jamInd;
+    };
+
+    struct MonRfInfo {
+        double agcPercent;
+        quint8 cwSuppression;
+    };
+
+    UbxEpochBuilder(UbxPacketArena &arena, UbxFrameCache &cache) : m_arena(arena), m_cache(cache) {}
+
+    UbxPacketArena::Frame buildNavPvt(const SimState &state, const UbxTime &now);
+    UbxPacketArena::Frame buildNavStatus(const SimState &state, const UbxTime &now);
+    UbxPacketArena::Frame buildNavSat(const SimState &state, quint32 epoch, const UbxTime &now,
+                                      const RfScenario::Sample &rf);
+    UbxPacketArena::Frame buildNavTimeUtc(const SimState &state, const UbxTime &now);
+    UbxPacketArena::Frame buildMonHw(const SimState &state, const RfScenario::Sample &rf, MonHwInfo &info);
+    UbxPacketArena::Frame buildMonRf(const SimState &state, const RfScenario::Sample &rf, MonRfInfo &info);
+
+    // SVs above the horizon in the last NAV-SAT, -1 before the first. They
+    // lead its list, and NAV-PVT reports them as numSV
+    int navSatTracked() const { return m_navSatTracked; }
+
+    // SVs NAV-SAT reports for the configured count
+    static int navSatCount(int configured);
+
+private:
+    static UbxPacketArena::Frame frameOf(const QByteArray &frame) { return { frame.constData(), frame.size() }; }
+
+    UbxPacketArena &m_arena;
+    UbxFrameCache &m_cache;
+    Constellation m_constellation{Constellation::MaxSatellites};
+    int m_navSatTracked = -1;
+};
+
+#endif // UBX_EPOCH_BUILDER_H
@@ -0,0 +1,236 @@
+#include "ubxfaultinjector.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QStringList>
+#include <QTimer>
+#include <cstring>
+
+namespace {
+
+const char *const s_faultNames[UbxFaultInjector::FaultCount] = {
+    "drop", "duplicate", "reorder", "delay", "truncate", "bitflip", "checksum"
+};
+
+int faultFromName(const QString &name) {
+    for (int i = 0; i < UbxFaultInjector::FaultCount; i++) {
+        if (name == QLatin1String(s_faultNames[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+const char *UbxFaultInjector::name(Fault fault) {
+    return s_faultNames[fault];
+}
+
+QJsonObject UbxFaultInjector::Config::toJson() const {
+    QJsonObject json;
+    json["enabled"] = enabled;
+    json["seed"] = static_cast<qint64>(seed);
+    json["delayMs"] = delayMs;
+    for (int i = 0; i < FaultCount; i++) {
+        json[s_faultNames[i]] = probability[i];
+    }
+
+    QJsonArray windowArray;
+    for (const Window &window : windows) {
+        QJsonObject item;
+        item["fault"] = s_faultNames[window.fault];
+        item["start"] = window.startMs / 1000.0;
+        item["duration"] = (window.endMs - window.startMs) / 1000.0;
+        item["probability"] = window.probability;
+        windowArray.append(item);
+    }
+    json["windows"] = windowArray;
+    return json;
+}
+
+bool UbxFaultInjector::Config::fromJson(const QJsonObject &json, Config &config, QString &error) {
+    Config result;
+    result.enabled = json["enabled"].toBool(true);
+    result.seed = static_cast<quint32>(json["seed"].toDouble(1));
+    result.delayMs = json["delayMs"].toInt(result.delayMs);
+    if (result.delayMs <= 0) {
+        error = QCoreApplication::translate("UbxFaultInjector", "delayMs must be positive");
+        return false;
+    }
+
+    for (int i = 0; i < FaultCount; i++) {
+        result.probability[i] = json[s_faultNames[i]].toDouble(0);
+        if (result.probability[i] < 0.0 || result.probability[i] > 1.0) {
+            error = QCoreApplication::translate("UbxFaultInjector", "Probability of %1 is outside 0..1")
+                        .arg(s_faultNames[i]);
+            return false;
+        }
+    }
+
+    const QJsonArray windowArray = json["windows"].toArray();
+    for (int i = 0; i < windowArray.size(); i++) {
+        const QJsonObject item = windowArray[i].toObject();
+        const int fault = faultFromName(item["fault"].toString());
+        const qint64 start = qRound64(item["start"].toDouble(-1) * 1000);
+        const qint64 duration = qRound64(item["duration"].toDouble(0) * 1000);
+        const double probability = item["probability"].toDouble(1.0);
+        if (fault < 0 || start < 0 || duration <= 0 || probability < 0.0 || probability > 1.0) {
+            error = QCoreApplication::translate("UbxFaultInjector", "Window %1 needs a known fault, "
+                                                "start, duration and a probability in 0..1").arg(i + 1);
+            return false;
+        }
+        result.windows.append({ start, start + duration, static_cast<Fault>(fault), probability });
+    }
+
+    config = result;
+    return true;
+}
+
+UbxFaultInjector::UbxFaultInjector(QObject *parent)
+    : QObject(parent), m_delayTimer(new QTimer(this)) {
+    m_delayTimer->setSingleShot(true);
+    connect(m_delayTimer, &QTimer::timeout, this, &UbxFaultInjector::releaseDue);
+
+    // Held and damaged frames are copied into these, grown once
+    m_scratch.reserve(4096);
+    m_reordered.reserve(4096);
+    m_held.resize(MaxHeldFrames);
+    m_clock.start();
+}
+
+void UbxFaultInjector::setConfig(const Config &config) {
+    flush();
+    m_config = config;
+    m_random.seed(config.seed);
+    m_clock.restart();
+    memset(m_counts, 0, sizeof(m_counts));
+}
+
+double UbxFaultInjector::probability(Fault fault, qint64 now) const {
+    double p = m_config.probability[fault];
+    for (const Window &window : m_config.windows) {
+        if (window.fault == fault && now >= window.startMs && now < window.endMs) {
+            p = qMax(p, window.probability);
+        }
+    }
+    return p;
+}
+
+// Draws only for faults that can happen, so a seed replays the same run
+bool UbxFaultInjector::roll(Fault fault, qint64 now) {
+    const double p = probability(fault, now);
+    if (p <= 0.0 || m_random.generateDouble() >= p) {
+        return false;
+    }
+    m_counts[fault]++;
+    return true;
+}
+
+void UbxFaultInjector::process(const char *data, int size) {
+    const qint64 now = m_clock.elapsed();
+    releaseDue();
+
+    if (roll(Drop, now)) {
+        return;
+    }
+
+    const char *out = data;
+    int outSize = size;
+    const bool badChecksum = size >= 8 && roll(BadChecksum, now);
+    const bool bitFlip = size > 2 && roll(BitFlip, now);
+    const bool truncate = size > 1 && roll(Truncate, now);
+    if (badChecksum || bitFlip || truncate) {
+        m_scratch.resize(size);
+        char *frame = m_scratch.data();
+        memcpy(frame, data, static_cast<size_t>(size));
+        if (badChecksum) {
+            frame[size - 2] = static_cast<char>(frame[size - 2] ^ (1 + m_random.bounded(255)));
+        }
+        if (bitFlip) {
+            // Anywhere after the sync characters, the checksum included
+            const int bit = static_cast<int>(m_random.bounded(quint32(size - 2) * 8));
+            frame[2 + bit / 8] = static_cast<char>(frame[2 + bit / 8] ^ (1 << (bit % 8)));
+        }
+        if (truncate) {
+            outSize = 1 + static_cast<int>(m_random.bounded(quint32(size - 1)));
+        }
+        out = frame;
+    }
+
+    if (m_heldCount < MaxHeldFrames && roll(Delay, now)) {
+        Held &slot = m_held[(m_heldHead + m_heldCount) % MaxHeldFrames];
+        slot.frame.resize(outSize);
+        memcpy(slot.frame.data(), out, static_cast<size_t>(outSize));
+        slot.dueMs = now + m_config.delayMs;
+        if (m_heldCount++ == 0) {
+            m_delayTimer->start(m_config.delayMs);
+        }
+        return;
+    }
+
+    if (!m_hasReordered && roll(Reorder, now)) {
+        m_reordered.resize(outSize);
+        memcpy(m_reordered.data(), out, static_cast<size_t>(outSize));
+        m_hasReordered = true;
+        return;
+    }
+
+    const bool duplicate = roll(Duplicate, now);
+    emitFrame(out, outSize);
+    if (duplicate) {
+        emitFrame(out, outSize);
+    }
+}
+
+// A frame held for reordering follows whichever frame goes out next
+void UbxFaultInjector::emitFrame(const char *data, int size) {
+    if (m_sink) {
+        m_sink(data, size);
+    }
+    if (m_hasReordered) {
+        m_hasReordered = false;
+        if (m_sink) {
+            m_sink(m_reordered.constData(), m_reordered.size());
+        }
+    }
+}
+
+void UbxFaultInjector::releaseDue() {
+    const qint64 now = m_clock.elapsed();
+    while (m_heldCount > 0 && m_held[m_heldHead].dueMs <= now) {
+        const Held &slot = m_held[m_heldHead];
+        emitFrame(slot.frame.constData(), slot.frame.size());
+        m_heldHead = (m_heldHead + 1) % MaxHeldFrames;
+        m_heldCount--;
+    }
+
+    if (m_heldCount > 0) {
+        m_delayTimer->start(static_cast<int>(m_held[m_heldHead].dueMs - now));
+    }
+}
+
+void UbxFaultInjector::flush() {
+    while (m_heldCount > 0) {
+        const Held &slot = m_held[m_heldHead];
+        emitFrame(slot.frame.constData(), slot.frame.size());
+        m_heldHead = (m_heldHead + 1) % MaxHeldFrames;
+        m_heldCount--;
+    }
+    m_delayTimer->stop();
+
+    if (m_hasReordered) {
+        m_hasReordered = false;
+        if (m_sink) {
+            m_sink(m_reordered.constData(), m_reordered.size());
+        }
+    }
+}
+
+QString UbxFaultInjector::summary() const {
+    QStringList parts;
+    for (int i = 0; i < FaultCount; i++) {
+        parts << QString("%1=%2").arg(s_faultNames[i]).arg(m_counts[i]);
+    }
+    return parts.join(", ");
+}
@@ -0,0 +1,103 @@
+#ifndef UBX_FAULT_INJECTOR_H
+#define UBX_FAULT_INJECTOR_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QVector>
+#include <functional>
+
+class QTimer;
+
+// Optional stage between the frame builders and the transport that damages
+// the output the way a bad link would. Every frame can be dropped,
+// duplicated, swapped with the next one, delayed, truncated, bit-flipped
+// or given a wrong checksum, each with its own probability, raised inside
+// scripted time windows. Decisions come from a seeded generator, so a run
+// can be repeated exactly.
+//
+// Frames that pass unharmed go to the sink by pointer. Damaged and held
+// frames are copied into preallocated slots. When faults are disabled the
+// caller skips the stage altogether.
+class UbxFaultInjector : public QObject {
+    Q_OBJECT
+
+public:
+    enum Fault {
+        Drop,
+        Duplicate,
+        Reorder,
+        Delay,
+        Truncate,
+        BitFlip,
+        BadChecksum,
+        FaultCount
+    };
+
+    struct Window {
+        qint64 startMs;
+        qint64 endMs;
+        Fault fault;
+        double probability;
+    };
+
+    struct Config {
+        bool enabled = false;
+        quint32 seed = 1;
+        double probability[FaultCount] = {};
+        int delayMs = 200;
+        QVector<Window> windows;    // Relative to setConfig()
+
+        QJsonObject toJson() const;
+        static bool fromJson(const QJsonObject &json, Config &config, QString &error);
+    };
+
+    using Sink = std::function<void(const char *data, int size)>;
+
+    // Delayed frames waiting at once; beyond this they are sent on time
+    static const int MaxHeldFrames = 64;
+
+    explicit UbxFaultInjector(QObject *parent = nullptr);
+
+    void setSink(const Sink &sink) { m_sink = sink; }
+    void setConfig(const Config &config);
+    const Config &config() const { return m_config; }
+    bool isEnabled() const { return m_config.enabled; }
+
+    void process(const char *data, int size);
+
+    // Releases held frames, e.g. before the link closes
+    void flush();
+
+    quint64 count(Fault fault) const { return m_counts[fault]; }
+    static const char *name(Fault fault);
+    QString summary() const;
+
+private:
+    struct Held {
+        QByteArray frame;
+        qint64 dueMs;
+    };
+
+    double probability(Fault fault, qint64 now) const;
+    bool roll(Fault fault, qint64 now);
+    void emitFrame(const char *data, int size);
+    void releaseDue();
+
+    Config m_config;
+    Sink m_sink;
+    QRandomGenerator m_random;
+    QElapsedTimer m_clock;
+    QTimer *m_delayTimer;
+    QByteArray m_scratch;
+    QVector<Held> m_held;       // Ring of delayed frames, in due order
+    int m_heldHead = 0;
+    int m_heldCount = 0;
+    QByteArray m_reordered;     // Frame waiting to go out after the next one
+    bool m_hasReordered = false;
+    quint64 m_counts[FaultCount] = {};
+};
+
+#endif // UBX_FAULT_INJECTOR_H
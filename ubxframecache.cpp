@@ -0,0 +1,66 @@
+#include "ubxframecache.h"
+#include "ubxchecksum.h"
+
+#include <cstring>
+
+const QByteArray &UbxFrameCache::store(FrameSlot slot, quint8 msgClass, quint8 msgId,
+                                       const QByteArray &payload) {
+    char *out = beginStore(slot, msgClass, msgId, payload.size());
+    memcpy(out, payload.constData(), payload.size());
+    return finishStore(slot);
+}
+
+char *UbxFrameCache::beginStore(FrameSlot slot, quint8 msgClass, quint8 msgId, int payloadSize) {
+    QByteArray &frame = m_entries[slot].frame;
+    frame.resize(8 + payloadSize);
+
+    char *bytes = frame.data();
+    bytes[0] = '\xB5'; // Sync char 1
+    bytes[1] = '\x62'; // Sync char 2
+    bytes[2] = static_cast<char>(msgClass);
+    bytes[3] = static_cast<char>(msgId);
+    bytes[4] = static_cast<char>(payloadSize & 0xFF);
+    bytes[5] = static_cast<char>((payloadSize >> 8) & 0xFF);
+    memset(bytes + 6, 0, payloadSize);
+
+    return bytes + 6;
+}
+
+const QByteArray &UbxFrameCache::finishStore(FrameSlot slot) {
+    Entry &entry = m_entries[slot];
+    UbxChecksum::seal(entry.frame.data(), entry.frame.size());
+    entry.dirty = false;
+    return entry.frame;
+}
+
+void UbxFrameCache::patch(FrameSlot slot, int payloadOffset, const char *data, int size) {
+    QByteArray &frame = m_entries[slot].frame;
+    if (frame.size() < 8 || payloadOffset < 0 || payloadOffset + size > frame.size() - 8) {
+        return;
+    }
+
+    UbxChecksum::patchFrame(frame.data(), frame.size(), payloadOffset, data, size);
+}
+
+void UbxFrameCache::invalidateAll() {
+    for (Entry &entry : m_entries) {
+        entry.dirty = true;
+    }
+}
+
+QByteArray UbxFrameCache::buildFrame(quint8 msgClass, quint8 msgId, const QByteArray &payload) {
+    const quint16 length = static_cast<quint16>(payload.size());
+    QByteArray packet(8 + length, '\0');
+    char *bytes = packet.data();
+
+    bytes[0] = '\xB5'; // Sync char 1
+    bytes[1] = '\x62'; // Sync char 2
+    bytes[2] = static_cast<char>(msgClass);
+    bytes[3] = static_cast<char>(msgId);
+    bytes[4] = static_cast<char>(length & 0xFF);
+    bytes[5] = static_cast<char>((length >> 8) & 0xFF);
+    memcpy(bytes + 6, payload.constData(), length);
+    UbxChecksum::seal(bytes, packet.size());
+
+    return packet;
+}
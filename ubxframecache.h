@@ -0,0 +1,52 @@
+#ifndef UBX_FRAME_CACHE_H
+#define UBX_FRAME_CACHE_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Keeps fully framed UBX messages whose content only changes when the user
+// edits the corresponding widgets. A slot is rebuilt after invalidate(),
+// dynamic fields (iTOW, UTC time) are patched in place.
+class UbxFrameCache {
+public:
+    enum FrameSlot {
+        FrameMonVer,
+        FrameSecUniqid,
+        FrameCfgPrtResponse,
+        FrameCfgPrt,
+        FrameCfgItfm,
+        FrameCfgNav5,
+        FrameCfgRate,
+        FrameCfgAnt,
+        FrameNavStatus,
+        FrameNavPvt,
+        FrameSlotCount
+    };
+
+    bool isDirty(FrameSlot slot) const { return m_entries[slot].dirty; }
+    const QByteArray &frame(FrameSlot slot) const { return m_entries[slot].frame; }
+
+    const QByteArray &store(FrameSlot slot, quint8 msgClass, quint8 msgId, const QByteArray &payload);
+
+    // Rebuilds a slot in place: beginStore() writes the header and returns
+    // the zeroed payload, finishStore() seals it. The slot keeps its buffer,
+    // so a frame rebuilt every epoch at the same size does not allocate.
+    char *beginStore(FrameSlot slot, quint8 msgClass, quint8 msgId, int payloadSize);
+    const QByteArray &finishStore(FrameSlot slot);
+    void patch(FrameSlot slot, int payloadOffset, const char *data, int size);
+
+    void invalidate(FrameSlot slot) { m_entries[slot].dirty = true; }
+    void invalidateAll();
+
+    static QByteArray buildFrame(quint8 msgClass, quint8 msgId, const QByteArray &payload);
+
+private:
+    struct Entry {
+        QByteArray frame;
+        bool dirty = true;
+    };
+
+    Entry m_entries[FrameSlotCount];
+};
+
+#endif // UBX_FRAME_CACHE_H
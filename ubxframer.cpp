@@ -0,0 +1,128 @@
+#include "ubxframer.h"
+#include "ubxchecksum.h"
+#include "ubxdefs.h"
+
+#include <cstring>
+
+namespace {
+
+const int HeaderSize = 6;
+const int FrameOverhead = 8;
+
+} // namespace
+
+// Largest payload each message can legally have, from the message layouts
+int UbxFramer::maxPayloadLength(quint8 msgClass, quint8 msgId) {
+    switch (msgClass) {
+    case UBX_CLASS_NAV:
+        switch (msgId) {
+        case UBX_NAV_PVT: return 92;
+        case UBX_NAV_STATUS: return 16;
+        case UBX_NAV_SAT: return 8 + 12 * 255;
+        case UBX_NAV_TIMEUTC: return 20;
+        }
+        break;
+    case UBX_CLASS_ACK:
+        return 2;
+    case UBX_CLASS_CFG:
+        switch (msgId) {
+        case UBX_CFG_PRT: return 20;
+        case UBX_CFG_MSG: return 8;
+        case UBX_CFG_RATE: return 6;
+        case UBX_CFG_ANT: return 4;
+        case UBX_CFG_NAV5: return 36;
+        case UBX_CFG_ITFM: return 8;
+        // Up to 64 keys, each with at most 8 bytes of value
+        case UBX_CFG_VALSET: return 4 + 64 * 12;
+        case UBX_CFG_VALGET: return 4 + 64 * 12;
+        case UBX_CFG_VALDEL: return 4 + 64 * 4;
+        }
+        break;
+    case UBX_CLASS_MON:
+        switch (msgId) {
+        case UBX_MON_VER: return 40 + 30 * 32;
+        case UBX_MON_HW: return 60;
+        case UBX_MON_RF: return 4 + 24 * 255;
+        }
+        break;
+    case UBX_CLASS_INF:
+        return 1024;
+    case UBX_CLASS_SEC:
+        if (msgId == UBX_SEC_UNIQID) {
+            return 10;
+        }
+        break;
+    }
+    return DefaultMaxPayload;
+}
+
+void UbxFramer::process(QByteArray &buffer, const Handler &handler) {
+    int pos = 0;
+
+    while (true) {
+        const char *data = buffer.constData();
+        const int size = buffer.size();
+        if (pos >= size) {
+            break;
+        }
+
+        const char *sync = static_cast<const char *>(memchr(data + pos, 0xB5, size_t(size - pos)));
+        if (!sync) {
+            m_stats.discardedBytes += size - pos;
+            pos = size;
+            break;
+        }
+
+        const int start = int(sync - data);
+        m_stats.discardedBytes += start - pos;
+        pos = start;
+        if (size - start < 2) {
+            break;
+        }
+        if (static_cast<quint8>(data[start + 1]) != 0x62) {
+            m_stats.discardedBytes++;
+            pos = start + 1;
+            continue;
+        }
+        if (size - start < HeaderSize) {
+            break;
+        }
+
+        const quint8 msgClass = static_cast<quint8>(data[start + 2]);
+        const quint8 msgId = static_cast<quint8>(data[start + 3]);
+        const int length = static_cast<quint8>(data[start + 4]) |
+                           (static_cast<quint8>(data[start + 5]) << 8);
+
+        // A length the message cannot have means a false sync; waiting for
+        // that many bytes would stall the link
+        if (length > maxPayloadLength(msgClass, msgId)) {
+            m_stats.oversizeLengths++;
+            m_stats.resyncs++;
+            m_stats.discardedBytes++;
+            pos = start + 1;
+            continue;
+        }
+        if (size - start < FrameOverhead + length) {
+            break;
+        }
+
+        const UbxChecksum::Value ck = UbxChecksum::compute(data + start + 2, 4 + length);
+        if (static_cast<quint8>(data[start + HeaderSize + length]) != ck.ckA ||
+            static_cast<quint8>(data[start + HeaderSize + length + 1]) != ck.ckB) {
+            m_stats.checksumErrors++;
+            m_stats.resyncs++;
+            m_stats.discardedBytes++;
+            pos = start + 1;
+            continue;
+        }
+
+        m_stats.frames++;
+        pos = start + FrameOverhead + length;
+        // The handler gets its own copy; buffer may grow while it runs
+        handler(msgClass, msgId, QByteArray(data + start + HeaderSize, length));
+    }
+
+    if (pos > 0) {
+        buffer.remove(0, qMin(pos, buffer.size()));
+    }
+}
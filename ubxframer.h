@@ -0,0 +1,41 @@
+#ifndef UBX_FRAMER_H
+#define UBX_FRAMER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <functional>
+
+// Splits a received byte stream into UBX frames. A candidate frame that
+// fails (length above what its class/ID can carry, or a bad checksum) is
+// treated as a false sync: only its 0xB5 is skipped and the scan resumes
+// from the next byte, so frames that were inside or right behind it are
+// still found.
+class UbxFramer {
+public:
+    struct Stats {
+        quint64 frames = 0;
+        quint64 resyncs = 0;            // Candidates rejected for any reason
+        quint64 checksumErrors = 0;
+        quint64 oversizeLengths = 0;
+        quint64 discardedBytes = 0;     // Bytes that were not part of a frame
+    };
+
+    using Handler = std::function<void(quint8 msgClass, quint8 msgId, const QByteArray &payload)>;
+
+    // Payload cap for messages outside the known schema
+    static const int DefaultMaxPayload = 8192;
+
+    static int maxPayloadLength(quint8 msgClass, quint8 msgId);
+
+    // Hands every complete frame in buffer to handler, then removes the
+    // consumed bytes; a partial frame stays for the next call
+    void process(QByteArray &buffer, const Handler &handler);
+
+    const Stats &stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+private:
+    Stats m_stats;
+};
+
+#endif // UBX_FRAMER_H
@@ -0,0 +1,256 @@
+#include "ubxlog.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QtEndian>
+#include <cstring>
+
+namespace UbxLog {
+
+namespace {
+
+// Source strings keep the GNSSWindow context so existing translations apply
+const char *const s_templates[TemplateCount] = {
+    "%1",
+    QT_TRANSLATE_NOOP("GNSSWindow", "UBX frame received: Class=0x%1, ID=0x%2, Length=%3"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "UBX Packet: Class=0x%1, ID=0x%2, Length=%3, Checksum=0x%4 0x%5"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Successfully sent %1 bytes"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent NAV-PVT"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent NAV-STATUS"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent NAV-SAT message"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent NAV-TIMEUTC"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Preparing MON-RF message with %1 blocks (%2 bytes total)"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Header: version=%1, nBlocks=%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Block %1: antId=%2, jamState=%3, antStatus=%4, antPower=%5, noise=%6, agc=%7"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "MON-RF message sent (%1 bytes total)"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent ACK for Class=0x%1 ID=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent NACK for Class=0x%1 ID=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "NAV-PVT: Lat=%1 Lon=%2 Fix=%3 Sats=%4"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "NAV-STATUS: Fix=%1 TTFF=%2ms"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "NAV-SAT: Version=%1 SVs=%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "MON-HW: Antenna=%1 Jamming=%2%"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "MON-RF: %1 RF blocks"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "MON-HW sent: Noise=%1, AGC=%2%, AntStatus=%3, AntPower=%4"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "CFG-RATE sent: MeasRate=%1ms, NavRate=%2, TimeRef=%3"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "CFG-ITFM sent: BB=%1, CW=%2, Enable=%3"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "CFG-VALSET sent: Version=%1, Layers=0x%2, %3 key-value pair(s)"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "CFG-VALGET sent: Version=%1, Layer=%2, Position=%3, Keys=%4"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "CFG-ANT sent: flags=0x%1, pins=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent CFG-PRT: Port=%1, Baud=%2, InProto=0x%3, OutProto=0x%4"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent CFG-PRT"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Sent CFG-NAV5 configuration"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "SEC-UNIQID sent: Version=%1, ChipID=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "ACK received for Class=0x%1 ID=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "NACK received for Class=0x%1 ID=0x%2"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Write error: %1"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Frame dropped: transmit buffer overrun"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Partial write: %1/%2 bytes"),
+    QT_TRANSLATE_NOOP("GNSSWindow", "Flush failed: %1")
+};
+
+const char *label(const Record &record) {
+    if (record.direction == In) return "IN";
+    if (record.direction == Out) return "OUT";
+    switch (record.level) {
+    case Debug: return "DEBUG";
+    case System: return "SYS";
+    case Warning: return "WARNING";
+    case Error: return "ERR";
+    default: return "INFO";
+    }
+}
+
+} // namespace
+
+void classify(const QString &type, Level &level, Direction &direction) {
+    direction = NoDirection;
+    level = Info;
+
+    if (type.compare("in", Qt::CaseInsensitive) == 0) {
+        direction = In;
+    } else if (type.compare("out", Qt::CaseInsensitive) == 0) {
+        direction = Out;
+    } else if (type.compare("system", Qt::CaseInsensitive) == 0) {
+        level = System;
+    } else if (type.compare("error", Qt::CaseInsensitive) == 0) {
+        level = Error;
+    } else if (type.compare("warning", Qt::CaseInsensitive) == 0) {
+        level = Warning;
+    } else if (type.compare("debug", Qt::CaseInsensitive) == 0) {
+        level = Debug;
+    }
+}
+
+QString format(const Record &record) {
+    if (record.templateId == FreeText || record.templateId >= TemplateCount) {
+        return record.text;
+    }
+
+    QString message = QCoreApplication::translate("GNSSWindow", s_templates[record.templateId]);
+    for (int i = 0; i < record.argCount; i++) {
+        const Arg &arg = record.args[i];
+        switch (arg.kind) {
+        case Arg::Int:
+            message = message.arg(arg.i);
+            break;
+        case Arg::Hex:
+            message = message.arg(static_cast<quint64>(arg.i), arg.width, 16, QLatin1Char('0'));
+            break;
+        case Arg::Real:
+            message = message.arg(arg.d, 0, 'f', arg.width);
+            break;
+        case Arg::Text:
+            message = message.arg(record.text);
+            break;
+        case Arg::Tag:
+            message = message.arg(QLatin1String(arg.s, int(qstrnlen(arg.s, sizeof(arg.s)))));
+            break;
+        }
+    }
+    return message;
+}
+
+QString formatPlain(const Record &record) {
+    return QString("%1 %2: %3")
+        .arg(QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("[hh:mm:ss]"))
+        .arg(QLatin1String(label(record)))
+        .arg(format(record));
+}
+
+QString formatHtml(const Record &record) {
+    const QString timestamp = QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("[hh:mm:ss]");
+    const QString message = format(record).toHtmlEscaped();
+
+    if (record.direction == In) {
+        return QString("<div style='color:#2E7D32;'><b>%1 IN:</b> %2</div>").arg(timestamp, message);
+    }
+    if (record.direction == Out) {
+        return QString("<div style='color:#1565C0;'><b>%1 OUT:</b> %2</div>").arg(timestamp, message);
+    }
+    if (record.level == System) {
+        return QString("<div style='color:#7B1FA2;'><b>%1 SYS:</b> %2</div>").arg(timestamp, message);
+    }
+    if (record.level == Error) {
+        return QString("<div style='color:#C62828;'><b>%1 ERR:</b> %2</div>").arg(timestamp, message);
+    }
+    return QString("<div style='color:#000000;'>%1 %2</div>").arg(timestamp, message);
+}
+
+// size(4) timestamp(8) template(2) level direction class id argCount(5)
+// args(10 each) textLength(4) text(UTF-8)
+void serialize(const Record &record, QByteArray &out) {
+    const QByteArray text = record.text.toUtf8();
+    const int size = 4 + 8 + 2 + 5 + record.argCount * 10 + 4 + text.size();
+
+    const int start = out.size();
+    out.resize(start + size);
+    char *p = out.data() + start;
+
+    qToLittleEndian<quint32>(size, p);
+    qToLittleEndian<qint64>(record.timestamp, p + 4);
+    qToLittleEndian<quint16>(record.templateId, p + 12);
+    p[14] = static_cast<char>(record.level);
+    p[15] = static_cast<char>(record.direction);
+    p[16] = static_cast<char>(record.msgClass);
+    p[17] = static_cast<char>(record.msgId);
+    p[18] = static_cast<char>(record.argCount);
+    p += 19;
+
+    for (int i = 0; i < record.argCount; i++) {
+        p[0] = static_cast<char>(record.args[i].kind);
+        p[1] = static_cast<char>(record.args[i].width);
+        qToLittleEndian<qint64>(record.args[i].i, p + 2);
+        p += 10;
+    }
+
+    qToLittleEndian<quint32>(text.size(), p);
+    memcpy(p + 4, text.constData(), text.size());
+}
+
+int deserialize(const char *data, int size, Record &record) {
+    if (size < 4) {
+        return 0;
+    }
+    const quint32 recordSize = qFromLittleEndian<quint32>(data);
+    if (recordSize < 23) {
+        return -1;
+    }
+    if (static_cast<quint32>(size) < recordSize) {
+        return 0;
+    }
+
+    const int argCount = static_cast<quint8>(data[18]);
+    const quint32 textOffset = 19 + argCount * 10;
+    if (argCount > Record::MaxArgs || textOffset + 4 > recordSize ||
+        textOffset + 4 + qFromLittleEndian<quint32>(data + textOffset) != recordSize) {
+        return -1;
+    }
+
+    record.timestamp = qFromLittleEndian<qint64>(data + 4);
+    record.templateId = qFromLittleEndian<quint16>(data + 12);
+    record.level = static_cast<Level>(data[14]);
+    record.direction = static_cast<Direction>(data[15]);
+    record.msgClass = static_cast<quint8>(data[16]);
+    record.msgId = static_cast<quint8>(data[17]);
+    record.argCount = static_cast<quint8>(argCount);
+
+    const char *p = data + 19;
+    for (int i = 0; i < argCount; i++) {
+        record.args[i].kind = static_cast<Arg::Kind>(p[0]);
+        record.args[i].width = static_cast<quint8>(p[1]);
+        record.args[i].i = qFromLittleEndian<qint64>(p + 2);
+        p += 10;
+    }
+
+    const int textSize = static_cast<int>(recordSize - textOffset - 4);
+    record.text = QString::fromUtf8(p + 4, textSize);
+
+    return static_cast<int>(recordSize);
+}
+
+Ring::Ring(int capacityPow2) : m_slots(capacityPow2), m_buffer(m_slots.data()),
+                               m_mask(static_cast<quint32>(capacityPow2 - 1)) {
+    Q_ASSERT((capacityPow2 & (capacityPow2 - 1)) == 0);
+}
+
+bool Ring::push(Level level, Direction direction, Template templateId,
+                std::initializer_list<Arg> args, quint8 msgClass, quint8 msgId,
+                const QString &text) {
+    const quint32 tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Record &record = m_buffer[tail & m_mask];
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.templateId = templateId;
+    record.level = level;
+    record.direction = direction;
+    record.msgClass = msgClass;
+    record.msgId = msgId;
+    record.argCount = 0;
+    for (const Arg &arg : args) {
+        if (record.argCount == Record::MaxArgs) {
+            break;
+        }
+        record.args[record.argCount++] = arg;
+    }
+    record.text = text;
+
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool Ring::pop(Record &record) {
+    const quint32 head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    record = std::move(m_buffer[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace UbxLog
@@ -0,0 +1,152 @@
+#ifndef UBX_LOG_H
+#define UBX_LOG_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <initializer_list>
+
+// Log entries are stored unformatted: a template ID plus a few raw
+// arguments. tr(), arg() and HTML escaping run only when a record is
+// rendered or exported.
+namespace UbxLog {
+
+enum Level : quint8 {
+    Debug,
+    Info,
+    System,
+    Warning,
+    Error
+};
+
+enum Direction : quint8 {
+    NoDirection,
+    In,
+    Out
+};
+
+// Message templates. FreeText renders the record's text verbatim and
+// carries messages that were formatted by the caller.
+enum Template : quint16 {
+    FreeText,
+    FrameReceived,
+    FrameSent,
+    FrameWritten,
+    NavPvtSent,
+    NavStatusSent,
+    NavSatSent,
+    NavTimeUtcSent,
+    MonRfPreparing,
+    MonRfHeader,
+    MonRfBlock,
+    MonRfSent,
+    AckSent,
+    NackSent,
+    NavPvtReceived,
+    NavStatusReceived,
+    NavSatReceived,
+    MonHwReceived,
+    MonRfReceived,
+    MonHwSent,
+    CfgRateSent,
+    CfgItfmSent,
+    CfgValsetSent,
+    CfgValgetSent,
+    CfgAntSent,
+    CfgPrtSent,
+    CfgPrtResponseSent,
+    CfgNav5Sent,
+    SecUniqidSent,
+    AckReceived,
+    NackReceived,
+    WriteError,
+    FrameDropped,
+    PartialWrite,
+    FlushFailed,
+    TemplateCount
+};
+
+struct Arg {
+    enum Kind : quint8 {
+        Int,
+        Hex,
+        Real,
+        Text,
+        Tag
+    };
+
+    Kind kind;
+    quint8 width;    // Hex digits or decimals
+    union {
+        qint64 i;
+        double d;
+        char s[8];  // Tag, Latin-1, not terminated when 8 chars long
+    };
+};
+
+inline Arg num(qint64 value) { Arg a; a.kind = Arg::Int; a.width = 0; a.i = value; return a; }
+inline Arg hex(quint64 value, int digits = 2) { Arg a; a.kind = Arg::Hex; a.width = quint8(digits); a.i = qint64(value); return a; }
+inline Arg real(double value, int decimals) { Arg a; a.kind = Arg::Real; a.width = quint8(decimals); a.d = value; return a; }
+inline Arg text() { Arg a; a.kind = Arg::Text; a.width = 0; a.i = 0; return a; }
+
+// Short fixed names such as enum labels, kept inline instead of in text
+inline Arg tag(const char *name) {
+    Arg a; a.kind = Arg::Tag; a.width = 0; a.i = 0;
+    for (int n = 0; n < 8 && name[n]; n++) a.s[n] = name[n];
+    return a;
+}
+
+struct Record {
+    static const int MaxArgs = 8;
+
+    qint64 timestamp = 0;   // ms since epoch
+    quint16 templateId = FreeText;
+    Level level = Info;
+    Direction direction = NoDirection;
+    quint8 msgClass = 0;    // Frame the entry refers to, 0 if none
+    quint8 msgId = 0;
+    quint8 argCount = 0;
+    Arg args[MaxArgs];
+    QString text;           // Value of the Text argument, if any
+};
+
+// Maps the legacy appendToLog() type strings onto level and direction
+void classify(const QString &type, Level &level, Direction &direction);
+
+QString format(const Record &record);
+QString formatPlain(const Record &record);
+QString formatHtml(const Record &record);
+
+// Binary journal encoding, little-endian, prefixed with the record size.
+// deserialize() returns the bytes consumed, 0 if data holds only part of
+// a record and -1 if the record is malformed.
+void serialize(const Record &record, QByteArray &out);
+int deserialize(const char *data, int size, Record &record);
+
+// Single-producer/single-consumer ring. Slots are preallocated and reused,
+// so pushing a record does not allocate unless it carries text. When the
+// consumer falls behind, new records are dropped and counted.
+class Ring {
+public:
+    explicit Ring(int capacityPow2 = 8192);
+
+    bool push(Level level, Direction direction, Template templateId,
+              std::initializer_list<Arg> args, quint8 msgClass = 0, quint8 msgId = 0,
+              const QString &text = QString());
+    bool pop(Record &record);
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    QVector<Record> m_slots;
+    Record *m_buffer;
+    quint32 m_mask;
+    std::atomic<quint32> m_head { 0 };  // Next slot to read
+    std::atomic<quint32> m_tail { 0 };  // Next slot to write
+    std::atomic<quint64> m_dropped { 0 };
+};
+
+} // namespace UbxLog
+
+#endif // UBX_LOG_H
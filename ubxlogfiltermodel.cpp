@@ -0,0 +1,72 @@
+#include "ubxlogfiltermodel.h"
+#include "ubxlogjournal.h"
+
+#include <QBrush>
+#include <QColor>
+
+UbxLogFilterModel::UbxLogFilterModel(const UbxLogIndex *index, UbxLogJournal *journal, QObject *parent)
+    : QAbstractListModel(parent), m_index(index), m_journal(journal), m_cache(512) {
+}
+
+int UbxLogFilterModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant UbxLogFilterModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+    if (role != Qt::DisplayRole && role != Qt::ForegroundRole) {
+        return QVariant();
+    }
+
+    const quint32 row = m_rows[index.row()];
+    UbxLog::Record *record = m_cache.object(row);
+    if (!record) {
+        record = new UbxLog::Record;
+        if (!m_journal->readRecord(m_index->offset(static_cast<int>(row)), *record)) {
+            delete record;
+            return role == Qt::DisplayRole ? QVariant(tr("<record unavailable>")) : QVariant();
+        }
+        m_cache.insert(row, record);
+    }
+
+    if (role == Qt::DisplayRole) {
+        return UbxLog::formatPlain(*record);
+    }
+
+    // Same palette as the main log view
+    if (record->direction == UbxLog::In) return QBrush(QColor("#2E7D32"));
+    if (record->direction == UbxLog::Out) return QBrush(QColor("#1565C0"));
+    if (record->level == UbxLog::System) return QBrush(QColor("#7B1FA2"));
+    if (record->level == UbxLog::Error) return QBrush(QColor("#C62828"));
+    return QVariant();
+}
+
+void UbxLogFilterModel::setFilter(const UbxLogIndex::Filter &filter) {
+    beginResetModel();
+    m_filter = filter;
+    m_rows.clear();
+    m_cache.clear();
+    m_index->match(m_filter, 0, m_rows);
+    m_scanned = m_index->size();
+    endResetModel();
+}
+
+void UbxLogFilterModel::update() {
+    if (m_scanned >= m_index->size()) {
+        return;
+    }
+
+    QVector<quint32> fresh;
+    UbxLogIndex::Filter tail = m_filter;
+    tail.lastMinutes = 0;   // New records are inside any time window
+    m_index->match(tail, m_scanned, fresh);
+    m_scanned = m_index->size();
+
+    if (!fresh.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + fresh.size() - 1);
+        m_rows += fresh;
+        endInsertRows();
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef UBX_LOG_FILTER_MODEL_H
+#define UBX_LOG_FILTER_MODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include "ubxlogindex.h"
+
+class UbxLogJournal;
+
+// Rows matching a UbxLogIndex filter. Only the row numbers are held in
+// memory; the view asks for visible rows and those are read back from the
+// journal and formatted on demand.
+class UbxLogFilterModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    UbxLogFilterModel(const UbxLogIndex *index, UbxLogJournal *journal, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    const UbxLogIndex::Filter &filter() const { return m_filter; }
+    void setFilter(const UbxLogIndex::Filter &filter);
+
+    // Picks up records indexed since the last call
+    void update();
+
+private:
+    const UbxLogIndex *m_index;
+    UbxLogJournal *m_journal;
+    UbxLogIndex::Filter m_filter;
+    QVector<quint32> m_rows;
+    int m_scanned = 0;
+    mutable QCache<quint32, UbxLog::Record> m_cache;
+};
+
+#endif // UBX_LOG_FILTER_MODEL_H
@@ -0,0 +1,93 @@
+#include "ubxlogindex.h"
+
+#include <QDateTime>
+
+bool UbxLogIndex::Filter::isEmpty() const {
+    return msgClass < 0 && msgId < 0 && direction < 0 && minLevel <= UbxLog::Debug && lastMinutes <= 0;
+}
+
+QJsonObject UbxLogIndex::Filter::toJson() const {
+    QJsonObject json;
+    json["class"] = msgClass;
+    json["id"] = msgId;
+    json["direction"] = direction;
+    json["minLevel"] = minLevel;
+    json["lastMinutes"] = lastMinutes;
+    return json;
+}
+
+UbxLogIndex::Filter UbxLogIndex::Filter::fromJson(const QJsonObject &json) {
+    Filter filter;
+    filter.msgClass = json["class"].toInt(-1);
+    filter.msgId = json["id"].toInt(-1);
+    filter.direction = json["direction"].toInt(-1);
+    filter.minLevel = json["minLevel"].toInt(UbxLog::Debug);
+    filter.lastMinutes = json["lastMinutes"].toInt(0);
+    return filter;
+}
+
+void UbxLogIndex::add(const UbxLog::Record &record, quint64 offset) {
+    const quint32 row = static_cast<quint32>(m_keys.size());
+    m_keys.append(packKey(record.msgClass, record.msgId, record.level, record.direction));
+    m_offsets.append(offset);
+
+    if (m_baseTime < 0) {
+        m_baseTime = record.timestamp;
+    }
+    // Clamped so a wall clock step backwards cannot reorder buckets
+    const qint64 bucket = qMax<qint64>((record.timestamp - m_baseTime) / BucketMs, m_bucketFirst.size() - 1);
+    while (m_bucketFirst.size() <= bucket) {
+        m_bucketFirst.append(row);
+    }
+}
+
+void UbxLogIndex::clear() {
+    m_keys.clear();
+    m_offsets.clear();
+    m_bucketFirst.clear();
+    m_baseTime = -1;
+}
+
+int UbxLogIndex::firstAtOrAfter(qint64 timestamp) const {
+    if (m_baseTime < 0 || timestamp <= m_baseTime) {
+        return 0;
+    }
+    const qint64 bucket = (timestamp - m_baseTime) / BucketMs;
+    if (bucket >= m_bucketFirst.size()) {
+        return m_keys.size();
+    }
+    return static_cast<int>(m_bucketFirst[static_cast<int>(bucket)]);
+}
+
+void UbxLogIndex::match(const Filter &filter, int from, QVector<quint32> &rows) const {
+    if (filter.lastMinutes > 0) {
+        const qint64 since = QDateTime::currentMSecsSinceEpoch() - qint64(filter.lastMinutes) * 60000;
+        from = qMax(from, firstAtOrAfter(since));
+    }
+
+    // Class, id and direction compare under a mask, level as a range
+    quint32 mask = 0;
+    quint32 value = 0;
+    if (filter.msgClass >= 0) {
+        mask |= 0xFF000000u;
+        value |= quint32(filter.msgClass & 0xFF) << 24;
+    }
+    if (filter.msgId >= 0) {
+        mask |= 0x00FF0000u;
+        value |= quint32(filter.msgId & 0xFF) << 16;
+    }
+    if (filter.direction >= 0) {
+        mask |= 0x000000FFu;
+        value |= quint32(filter.direction & 0xFF);
+    }
+    const quint32 minLevel = static_cast<quint32>(qMax(0, filter.minLevel));
+
+    const quint32 *keys = m_keys.constData();
+    const int count = m_keys.size();
+    for (int row = from; row < count; row++) {
+        const quint32 key = keys[row];
+        if ((key & mask) == value && ((key >> 8) & 0xFF) >= minLevel) {
+            rows.append(static_cast<quint32>(row));
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef UBX_LOG_INDEX_H
+#define UBX_LOG_INDEX_H
+
+#include <QJsonObject>
+#include <QVector>
+#include "ubxlog.h"
+
+// Column index over the log journal: one packed key (class, id, level,
+// direction) and one journal offset per record, plus the first record of
+// every one-second bucket. Filters scan the 4-byte keys only, never the
+// message text, and time windows start from the matching bucket.
+class UbxLogIndex {
+public:
+    struct Filter {
+        int msgClass = -1;      // -1 matches any
+        int msgId = -1;
+        int direction = -1;     // UbxLog::Direction, -1 matches any
+        int minLevel = UbxLog::Debug;
+        int lastMinutes = 0;    // 0 covers the whole session
+
+        bool isEmpty() const;
+        QJsonObject toJson() const;
+        static Filter fromJson(const QJsonObject &json);
+    };
+
+    static const int BucketMs = 1000;
+
+    void add(const UbxLog::Record &record, quint64 offset);
+    void clear();
+
+    int size() const { return m_keys.size(); }
+    quint64 offset(int row) const { return m_offsets[row]; }
+
+    // First record logged at or after timestamp (ms since epoch)
+    int firstAtOrAfter(qint64 timestamp) const;
+
+    // Appends the rows in [from, size()) that pass the filter
+    void match(const Filter &filter, int from, QVector<quint32> &rows) const;
+
+private:
+    static quint32 packKey(quint8 msgClass, quint8 msgId, quint8 level, quint8 direction) {
+        return (quint32(msgClass) << 24) | (quint32(msgId) << 16) | (quint32(level) << 8) | direction;
+    }
+
+    QVector<quint32> m_keys;
+    QVector<quint64> m_offsets;
+    QVector<quint32> m_bucketFirst;  // Bucket i starts at m_baseTime + i * BucketMs
+    qint64 m_baseTime = -1;
+};
+
+#endif // UBX_LOG_INDEX_H
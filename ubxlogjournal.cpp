@@ -0,0 +1,235 @@
+#include "ubxlogjournal.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtEndian>
+
+void UbxLogJournalWriter::open(const QString &directory, const QString &path) {
+    if (!QDir().mkpath(directory)) {
+        emit errorOccurred(tr("Cannot create log journal directory %1").arg(directory));
+        emit opened(false);
+        return;
+    }
+    pruneOldSessions(directory, 10);
+
+    // Held for the whole session, so pruning by other instances skips it
+    m_lock.reset(new QLockFile(path + ".lock"));
+    m_lock->setStaleLockTime(0);
+    m_lock->tryLock(0);
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        emit errorOccurred(tr("Cannot open log journal %1: %2").arg(path, m_file.errorString()));
+        m_lock.reset();
+        emit opened(false);
+        return;
+    }
+    emit opened(true);
+}
+
+void UbxLogJournalWriter::writeChunk(const QByteArray &chunk) {
+    // Flushed, so the chunk can be read back from disk once reported
+    if (m_file.isOpen() && (m_file.write(chunk) != chunk.size() || !m_file.flush())) {
+        emit errorOccurred(tr("Log journal write failed: %1").arg(m_file.errorString()));
+    }
+    emit chunkWritten();
+}
+
+void UbxLogJournalWriter::exportText(const QString &fileName) {
+    m_file.flush();
+
+    QFile in(m_file.fileName());
+    if (!in.open(QIODevice::ReadOnly)) {
+        emit exportFinished(false, in.errorString());
+        return;
+    }
+    QFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit exportFinished(false, out.errorString());
+        return;
+    }
+
+    // One chunk of input and one chunk of output at a time
+    QByteArray buffer;
+    QByteArray text;
+    buffer.reserve(2 * UbxLogJournal::ChunkSize);
+    text.reserve(2 * UbxLogJournal::ChunkSize);
+    UbxLog::Record record;
+    quint64 exported = 0;
+
+    while (!in.atEnd()) {
+        buffer.append(in.read(UbxLogJournal::ChunkSize));
+
+        int pos = 0;
+        for (;;) {
+            const int used = UbxLog::deserialize(buffer.constData() + pos, buffer.size() - pos, record);
+            if (used == 0) {
+                break;
+            }
+            if (used < 0) {
+                emit exportFinished(false, tr("Log journal is corrupt after %1 records").arg(exported));
+                return;
+            }
+            pos += used;
+            text.append(UbxLog::formatPlain(record).toUtf8());
+            text.append('\n');
+            exported++;
+        }
+        buffer.remove(0, pos);
+
+        if (out.write(text) != text.size()) {
+            emit exportFinished(false, out.errorString());
+            return;
+        }
+        text.clear();
+    }
+
+    emit exportFinished(true, tr("Exported %1 log records to %2").arg(exported).arg(fileName));
+}
+
+void UbxLogJournalWriter::close() {
+    m_file.close();
+    m_lock.reset();
+}
+
+void UbxLogJournalWriter::pruneOldSessions(const QString &directory, int keep) {
+    QDir dir(directory);
+    const QFileInfoList sessions = dir.entryInfoList(QStringList() << "session-*.ubxlog",
+                                                     QDir::Files, QDir::Name | QDir::Reversed);
+    for (int i = keep - 1; i < sessions.size(); i++) {
+        const QString session = sessions[i].absoluteFilePath();
+        // A live lock means another running instance still writes the session
+        QLockFile lock(session + ".lock");
+        lock.setStaleLockTime(0);
+        if (!lock.tryLock(0)) {
+            continue;
+        }
+        QFile::remove(session);
+    }
+}
+
+UbxLogJournal::UbxLogJournal(QObject *parent)
+    : QObject(parent), m_writer(new UbxLogJournalWriter), m_flushTimer(new QTimer(this)) {
+    m_writer->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_writer, &QObject::deleteLater);
+
+    connect(this, &UbxLogJournal::chunkReady, m_writer, &UbxLogJournalWriter::writeChunk);
+    connect(this, &UbxLogJournal::exportRequested, m_writer, &UbxLogJournalWriter::exportText);
+    connect(m_writer, &UbxLogJournalWriter::opened, this, &UbxLogJournal::onOpened);
+    connect(m_writer, &UbxLogJournalWriter::chunkWritten, this, &UbxLogJournal::onChunkWritten);
+    connect(m_writer, &UbxLogJournalWriter::exportFinished, this, &UbxLogJournal::exportFinished);
+    connect(m_writer, &UbxLogJournalWriter::errorOccurred, this, &UbxLogJournal::errorOccurred);
+
+    // Partial chunks reach the disk within a second
+    m_flushTimer->setInterval(1000);
+    connect(m_flushTimer, &QTimer::timeout, this, &UbxLogJournal::flush);
+
+    m_chunk.reserve(ChunkSize);
+    m_thread.setObjectName("UbxLogJournal");
+    m_thread.start(QThread::LowPriority);
+}
+
+UbxLogJournal::~UbxLogJournal() {
+    flush();
+    // Queued after every pending chunk, so nothing is lost on exit
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void UbxLogJournal::open() {
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/journal";
+
+    // Milliseconds and the PID keep instances started together apart,
+    // names still sort by start time for pruning
+    m_sessionPath = QString("%1/session-%2-%3.ubxlog")
+                        .arg(directory, QDateTime::currentDateTime().toString("yyyyMMdd-hhmmsszzz"))
+                        .arg(QCoreApplication::applicationPid());
+    QMetaObject::invokeMethod(m_writer, "open", Qt::QueuedConnection,
+                              Q_ARG(QString, directory), Q_ARG(QString, m_sessionPath));
+    m_flushTimer->start();
+}
+
+void UbxLogJournal::onOpened(bool ok) {
+    if (ok) {
+        m_path = m_sessionPath;
+    }
+    emit opened(ok);
+}
+
+void UbxLogJournal::onChunkWritten() {
+    if (!m_inFlight.isEmpty()) {
+        m_writtenOffset += m_inFlight.takeFirst().size();
+    }
+}
+
+quint64 UbxLogJournal::append(const UbxLog::Record &record) {
+    const quint64 offset = m_chunkOffset + m_chunk.size();
+    UbxLog::serialize(record, m_chunk);
+    m_recordCount++;
+    if (m_chunk.size() >= ChunkSize) {
+        flush();
+    }
+    return offset;
+}
+
+bool UbxLogJournal::readRecord(quint64 offset, UbxLog::Record &record) {
+    if (offset >= m_chunkOffset) {
+        const int pos = static_cast<int>(offset - m_chunkOffset);
+        return UbxLog::deserialize(m_chunk.constData() + pos, m_chunk.size() - pos, record) > 0;
+    }
+
+    if (offset >= m_writtenOffset) {
+        quint64 start = m_writtenOffset;
+        for (const QByteArray &chunk : m_inFlight) {
+            if (offset < start + chunk.size()) {
+                const int pos = static_cast<int>(offset - start);
+                return UbxLog::deserialize(chunk.constData() + pos, chunk.size() - pos, record) > 0;
+            }
+            start += chunk.size();
+        }
+        return false;
+    }
+
+    if (m_path.isEmpty()) {
+        return false;
+    }
+    if (!m_reader.isOpen()) {
+        m_reader.setFileName(m_path);
+        if (!m_reader.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+    }
+
+    // Reported chunks are flushed, so the record is complete on disk
+    char header[4];
+    if (!m_reader.seek(static_cast<qint64>(offset)) || m_reader.read(header, 4) != 4) {
+        return false;
+    }
+    const quint32 size = qFromLittleEndian<quint32>(header);
+    if (size < 4) {
+        return false;
+    }
+    QByteArray data(header, 4);
+    data.append(m_reader.read(size - 4));
+    return UbxLog::deserialize(data.constData(), data.size(), record) > 0;
+}
+
+void UbxLogJournal::flush() {
+    if (m_chunk.isEmpty()) {
+        return;
+    }
+    emit chunkReady(m_chunk);
+    m_inFlight.append(m_chunk);
+    m_chunkOffset += m_chunk.size();
+    m_chunk = QByteArray();
+    m_chunk.reserve(ChunkSize);
+}
+
+void UbxLogJournal::exportText(const QString &fileName) {
+    flush();
+    emit exportRequested(fileName);
+}
+
@@ -0,0 +1,96 @@
+#ifndef UBX_LOG_JOURNAL_H
+#define UBX_LOG_JOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QList>
+#include <QLockFile>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+#include "ubxlog.h"
+
+// Runs on the journal thread: opens the session, appends chunks and
+// streams exports
+class UbxLogJournalWriter : public QObject {
+    Q_OBJECT
+
+public slots:
+    void open(const QString &directory, const QString &path);
+    void writeChunk(const QByteArray &chunk);
+    void exportText(const QString &fileName);
+    void close();
+
+signals:
+    void opened(bool ok);
+    // Every chunk is reported, written or not, in the order received
+    void chunkWritten();
+    void exportFinished(bool ok, const QString &message);
+    void errorOccurred(const QString &message);
+
+private:
+    static void pruneOldSessions(const QString &directory, int keep);
+
+    QFile m_file;
+    std::unique_ptr<QLockFile> m_lock;
+};
+
+// Session-long on-disk copy of every log record. The GUI thread serializes
+// records into a fixed-size chunk and hands full chunks to a background
+// writer, so the log view only needs to keep a window of recent lines.
+// Exports are a streamed format pass over the journal and use constant
+// memory regardless of session length.
+class UbxLogJournal : public QObject {
+    Q_OBJECT
+
+public:
+    static const int ChunkSize = 64 * 1024;
+
+    explicit UbxLogJournal(QObject *parent = nullptr);
+    ~UbxLogJournal() override;
+
+    // Opens a new session file in the application data directory on the
+    // journal thread; the result arrives through opened()
+    void open();
+    // Empty until the session file is open
+    QString path() const { return m_path; }
+
+    // Returns the record's byte offset in the journal
+    quint64 append(const UbxLog::Record &record);
+    void flush();
+    void exportText(const QString &fileName);
+
+    // Random access for the log views, from memory or from disk. Never
+    // waits for the journal thread: chunks it has not written yet are
+    // still held here
+    bool readRecord(quint64 offset, UbxLog::Record &record);
+
+    quint64 recordCount() const { return m_recordCount; }
+
+signals:
+    void opened(bool ok);
+    void exportFinished(bool ok, const QString &message);
+    void errorOccurred(const QString &message);
+
+    // Internal, delivered to the writer on the journal thread
+    void chunkReady(const QByteArray &chunk);
+    void exportRequested(const QString &fileName);
+
+private:
+    void onOpened(bool ok);
+    void onChunkWritten();
+
+    QThread m_thread;
+    UbxLogJournalWriter *m_writer;
+    QTimer *m_flushTimer;
+    QByteArray m_chunk;
+    quint64 m_chunkOffset = 0;   // Journal offset of m_chunk[0]
+    QList<QByteArray> m_inFlight; // Handed to the writer, not yet on disk
+    quint64 m_writtenOffset = 0; // Journal offset of m_inFlight[0]
+    QFile m_reader;
+    QString m_sessionPath;
+    QString m_path;
+    quint64 m_recordCount = 0;
+};
+
+#endif // UBX_LOG_JOURNAL_H
@@ -0,0 +1,106 @@
+#ifndef UBX_MESSAGE_POOL_H
+#define UBX_MESSAGE_POOL_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVector>
+#include <utility>
+
+// Pool of decoded messages shared by reference. A frame is decoded once into
+// a pooled slot and every subscriber receives a Handle to the same read-only
+// object; the slot returns to the pool when the last Handle goes away, from
+// whichever thread that happens on.
+template <typename T>
+class UbxMessagePool {
+    struct Slot {
+        QAtomicInt ref;
+        T value;
+    };
+
+public:
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(const Handle &other) : m_slot(other.m_slot) {
+            if (m_slot) m_slot->ref.ref();
+        }
+        Handle(Handle &&other) noexcept : m_slot(other.m_slot) {
+            other.m_slot = nullptr;
+        }
+        ~Handle() { reset(); }
+
+        Handle &operator=(Handle other) noexcept {
+            std::swap(m_slot, other.m_slot);
+            return *this;
+        }
+
+        const T *operator->() const { return &m_slot->value; }
+        const T &operator*() const { return m_slot->value; }
+        explicit operator bool() const { return m_slot != nullptr; }
+        int useCount() const { return m_slot ? m_slot->ref.loadRelaxed() : 0; }
+
+        void reset() {
+            if (m_slot && !m_slot->ref.deref()) {
+                UbxMessagePool::release(m_slot);
+            }
+            m_slot = nullptr;
+        }
+
+    private:
+        friend class UbxMessagePool;
+        explicit Handle(Slot *slot) : m_slot(slot) {}
+
+        Slot *m_slot = nullptr;
+    };
+
+    // Takes a free slot, lets fill() decode into it and publishes it
+    template <typename Fill>
+    static Handle create(Fill fill) {
+        Slot *slot = acquire();
+        fill(slot->value);
+        slot->ref.storeRelease(1);
+        return Handle(slot);
+    }
+
+    static int freeSlots() {
+        QMutexLocker locker(&state().mutex);
+        return state().free.size();
+    }
+
+    // Slots ever allocated for T; stays flat once the pool has warmed up
+    static quint64 allocationCount() {
+        QMutexLocker locker(&state().mutex);
+        return state().allocations;
+    }
+
+private:
+    struct State {
+        QMutex mutex;
+        QVector<Slot *> free;
+        quint64 allocations = 0;
+    };
+
+    // Never destroyed, handles queued to other threads may outlive main()
+    static State &state() {
+        static State *s = new State;
+        return *s;
+    }
+
+    static Slot *acquire() {
+        State &s = state();
+        QMutexLocker locker(&s.mutex);
+        if (s.free.isEmpty()) {
+            s.allocations++;
+            return new Slot();
+        }
+        return s.free.takeLast();
+    }
+
+    static void release(Slot *slot) {
+        State &s = state();
+        QMutexLocker locker(&s.mutex);
+        s.free.append(slot);
+    }
+};
+
+#endif // UBX_MESSAGE_POOL_H
@@ -0,0 +1,43 @@
+#include "ubxpacketarena.h"
+#include "ubxchecksum.h"
+
+#include <cstring>
+
+UbxPacketArena::UbxPacketArena(int capacity) : m_buffer(capacity, '\0') {}
+
+char *UbxPacketArena::beginFrame(quint8 msgClass, quint8 msgId, int payloadSize) {
+    const int frameSize = 8 + payloadSize;
+
+    if (m_used + frameSize > m_buffer.size()) {
+        // Everything before m_used has already been written to the transport
+        m_used = 0;
+        if (frameSize > m_buffer.size()) {
+            m_buffer.resize(qMax(frameSize, m_buffer.size() * 2));
+        }
+    }
+
+    m_frameStart = m_used;
+    m_frameSize = frameSize;
+    m_used += frameSize;
+
+    char *frame = m_buffer.data() + m_frameStart;
+    frame[0] = '\xB5'; // Sync char 1
+    frame[1] = '\x62'; // Sync char 2
+    frame[2] = static_cast<char>(msgClass);
+    frame[3] = static_cast<char>(msgId);
+    frame[4] = static_cast<char>(payloadSize & 0xFF);
+    frame[5] = static_cast<char>((payloadSize >> 8) & 0xFF);
+    memset(frame + 6, 0, payloadSize);
+
+    return frame + 6;
+}
+
+UbxPacketArena::Frame UbxPacketArena::finishFrame() {
+    char *frame = m_buffer.data() + m_frameStart;
+    UbxChecksum::seal(frame, m_frameSize);
+
+    Frame result;
+    result.data = frame;
+    result.size = m_frameSize;
+    return result;
+}
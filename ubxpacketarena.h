@@ -0,0 +1,44 @@
+#ifndef UBX_PACKET_ARENA_H
+#define UBX_PACKET_ARENA_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Bump allocator for outgoing UBX frames. The header is written by
+// beginFrame(), the caller fills the payload in place and finishFrame()
+// seals the checksum. The buffer is rewound at each epoch (reset()) or when
+// it runs out of room, which is safe when frames are handed to the
+// transport synchronously. A caller that keeps an epoch's frames and
+// writes them later (ReceiverInstance) must size the arena for the whole
+// epoch, since a rewind overwrites the frames it still holds.
+//
+// Once each message has been built at its largest size, building an
+// epoch's frames (arena, UbxFrameCache::beginStore(), UbxTime, log records
+// without text) makes no heap allocation; tests/ubxallocationtest.cpp checks
+// this. Writing to the transport, the telemetry dock and frames built from a
+// QByteArray payload (createUbxPacket(), user-triggered and CFG replies) are
+// outside that guarantee.
+class UbxPacketArena {
+public:
+    struct Frame {
+        const char *data;
+        int size;
+    };
+
+    explicit UbxPacketArena(int capacity = 16 * 1024);
+
+    char *beginFrame(quint8 msgClass, quint8 msgId, int payloadSize);
+    Frame finishFrame();
+    void reset() { m_used = 0; }
+
+    int used() const { return m_used; }
+    int capacity() const { return m_buffer.size(); }
+
+private:
+    QByteArray m_buffer;
+    int m_used = 0;
+    int m_frameStart = 0;
+    int m_frameSize = 0;
+};
+
+#endif // UBX_PACKET_ARENA_H
@@ -1,8 +1,62 @@
 #include "ubxparser.h"
+#include "ubxchecksum.h"
+#include "ubxdefs.h"
 #include <QtEndian>
 #include <QDebug>
+#include <QMetaMethod>
+#include <cstring>
 
 UbxParser::UbxParser(QObject *parent) : QObject(parent) {
+    // Handles may be delivered through queued connections to other threads
+    qRegisterMetaType<NavPvtHandle>();
+    qRegisterMetaType<NavSatHandle>();
+    qRegisterMetaType<NavStatusHandle>();
+    qRegisterMetaType<MonVerHandle>();
+    qRegisterMetaType<MonHwHandle>();
+    qRegisterMetaType<MonRfHandle>();
+    qRegisterMetaType<CfgPrtHandle>();
+    qRegisterMetaType<CfgMsgHandle>();
+    qRegisterMetaType<SecUniqidHandle>();
+}
+
+template <typename T, typename Signal>
+bool UbxParser::publish(Signal signal, const QByteArray &payload, void (*decode)(const QByteArray &, T &)) {
+    if (!isSignalConnected(QMetaMethod::fromSignal(signal))) {
+        return true;
+    }
+
+    const typename UbxMessagePool<T>::Handle handle =
+        UbxMessagePool<T>::create([&](T &slot) { decode(payload, slot); });
+    emit (this->*signal)(handle);
+    return true;
+}
+
+bool UbxParser::dispatch(quint8 msgClass, quint8 msgId, const QByteArray &payload) {
+    switch ((msgClass << 8) | msgId) {
+    case (UBX_CLASS_NAV << 8) | UBX_NAV_PVT:
+        return publish(&UbxParser::navPvtReceived, payload, &UbxParser::decodeNavPvt);
+    case (UBX_CLASS_NAV << 8) | UBX_NAV_SAT:
+        return publish(&UbxParser::navSatReceived, payload, &UbxParser::decodeNavSat);
+    case (UBX_CLASS_NAV << 8) | UBX_NAV_STATUS:
+        return publish(&UbxParser::navStatusReceived, payload, &UbxParser::decodeNavStatus);
+    case (UBX_CLASS_MON << 8) | UBX_MON_VER:
+        return publish(&UbxParser::monVerReceived, payload, &UbxParser::decodeMonVer);
+    case (UBX_CLASS_MON << 8) | UBX_MON_HW:
+        return publish(&UbxParser::monHwReceived, payload, &UbxParser::decodeMonHw);
+    case (UBX_CLASS_MON << 8) | UBX_MON_RF:
+        return publish(&UbxParser::monRfReceived, payload, &UbxParser::decodeMonRf);
+    case (UBX_CLASS_CFG << 8) | UBX_CFG_PRT:
+        return publish(&UbxParser::cfgPrtReceived, payload, &UbxParser::decodeCfgPrt);
+    case (UBX_CLASS_CFG << 8) | UBX_CFG_MSG:
+        return publish(&UbxParser::cfgMsgReceived, payload, &UbxParser::decodeCfgMsg);
+    case (UBX_CLASS_SEC << 8) | UBX_SEC_UNIQID:
+        return publish(&UbxParser::secUniqidReceived, payload, &UbxParser::decodeSecUniqid);
+    case (UBX_CLASS_INF << 8) | UBX_INF_ERROR:
+        emit infErrorReceived(QString::fromLatin1(payload));
+        return true;
+    default:
+        return false;
+    }
 }
 
 bool UbxParser::parseUbxMessage(const QByteArray &data,
@@ -32,16 +86,7 @@ bool UbxParser::parseUbxMessage(const QByteArray &data,
         return false;
     }
 
-    quint8 ck_a = 0;
-    quint8 ck_b = 0;
-
-    for (int i = 2; i < data.size() - 2; i++) {
-        ck_a += static_cast<quint8>(data[i]);
-        ck_b += ck_a;
-    }
-
-    if (ck_a != static_cast<quint8>(data[data.size()-2]) ||
-        ck_b != static_cast<quint8>(data[data.size()-1])) {
+    if (!UbxChecksum::verify(data)) {
         qDebug() << "Checksum mismatch";
         return false;
     }
@@ -60,113 +105,128 @@ UbxParser::CfgItfm UbxParser::parseCfgItfm(const QByteArray &payload) {
     CfgItfm result = {};
 
     if (payload.size() >= 8) {
-        result.config = qFromLittleEndian<quint32>(payload.mid(0, 4).constData());
-        result.config2 = qFromLittleEndian<quint32>(payload.mid(4, 4).constData());
+        result.config = qFromLittleEndian<quint32>(payload.constData());
+        result.config2 = qFromLittleEndian<quint32>(payload.constData() + 4);
     }
 
     return result;
 }
 
-UbxParser::NavPvt UbxParser::parseNavPvt(const QByteArray &payload) {
-    NavPvt result = {};
+void UbxParser::decodeNavPvt(const QByteArray &payload, NavPvt &result) {
+    result = NavPvt();
 
     if (payload.size() < 92) {
         qWarning() << "NAV-PVT payload too small:" << payload.size()
                    << "bytes, expected 92";
-        return result;
+        return;
     }
 
-    result.iTOW = qFromLittleEndian<quint32>(payload.mid(0, 4).constData());
-    result.year = qFromLittleEndian<quint16>(payload.mid(4, 2).constData());
+    result.iTOW = qFromLittleEndian<quint32>(payload.constData());
+    result.year = qFromLittleEndian<quint16>(payload.constData() + 4);
     result.month = static_cast<quint8>(payload[6]);
     result.day = static_cast<quint8>(payload[7]);
     result.hour = static_cast<quint8>(payload[8]);
     result.min = static_cast<quint8>(payload[9]);
     result.sec = static_cast<quint8>(payload[10]);
     result.valid = static_cast<quint8>(payload[11]);
-    result.tAcc = qFromLittleEndian<quint32>(payload.mid(12, 4).constData());
-    result.nano = qFromLittleEndian<qint32>(payload.mid(16, 4).constData());
+    result.tAcc = qFromLittleEndian<quint32>(payload.constData() + 12);
+    result.nano = qFromLittleEndian<qint32>(payload.constData() + 16);
     result.fixType = static_cast<quint8>(payload[20]);
     result.flags = static_cast<quint8>(payload[21]);
+    result.flags2 = static_cast<quint8>(payload[22]);
     result.numSV = static_cast<quint8>(payload[23]);
-    result.lon = qFromLittleEndian<qint32>(payload.mid(24, 4).constData());
-    result.lat = qFromLittleEndian<qint32>(payload.mid(28, 4).constData());
-    result.height = qFromLittleEndian<qint32>(payload.mid(32, 4).constData());
-    result.hMSL = qFromLittleEndian<qint32>(payload.mid(36, 4).constData());
-    result.hAcc = qFromLittleEndian<quint32>(payload.mid(40, 4).constData());
-    result.vAcc = qFromLittleEndian<quint32>(payload.mid(44, 4).constData());
-    result.velN = qFromLittleEndian<qint32>(payload.mid(48, 4).constData());
-    result.velE = qFromLittleEndian<qint32>(payload.mid(52, 4).constData());
-    result.velD = qFromLittleEndian<qint32>(payload.mid(56, 4).constData());
-    result.speed = qFromLittleEndian<quint32>(payload.mid(60, 4).constData());
-    result.gSpeed = qFromLittleEndian<quint32>(payload.mid(64, 4).constData());
-    result.headMot = qFromLittleEndian<quint32>(payload.mid(68, 4).constData());
-    result.sAcc = qFromLittleEndian<quint32>(payload.mid(72, 4).constData());
-    result.headAcc = qFromLittleEndian<quint32>(payload.mid(76, 4).constData());
-    result.pDOP = qFromLittleEndian<quint16>(payload.mid(80, 2).constData());
-
-    qDebug() << "Parsed NAV-PVT:"
-             << "Lat:" << result.lat/1e7 << "Lon:" << result.lon/1e7
-             << "Fix:" << result.fixType << "Sats:" << result.numSV;
+    result.lon = qFromLittleEndian<qint32>(payload.constData() + 24);
+    result.lat = qFromLittleEndian<qint32>(payload.constData() + 28);
+    result.height = qFromLittleEndian<qint32>(payload.constData() + 32);
+    result.hMSL = qFromLittleEndian<qint32>(payload.constData() + 36);
+    result.hAcc = qFromLittleEndian<quint32>(payload.constData() + 40);
+    result.vAcc = qFromLittleEndian<quint32>(payload.constData() + 44);
+    result.velN = qFromLittleEndian<qint32>(payload.constData() + 48);
+    result.velE = qFromLittleEndian<qint32>(payload.constData() + 52);
+    result.velD = qFromLittleEndian<qint32>(payload.constData() + 56);
+    result.gSpeed = qFromLittleEndian<quint32>(payload.constData() + 60);
+    result.headMot = qFromLittleEndian<quint32>(payload.constData() + 64);
+    result.sAcc = qFromLittleEndian<quint32>(payload.constData() + 68);
+    result.headAcc = qFromLittleEndian<quint32>(payload.constData() + 72);
+    result.pDOP = qFromLittleEndian<quint16>(payload.constData() + 76);
+    memcpy(result.reserved, payload.constData() + 78, sizeof(result.reserved));
+    result.headVeh = qFromLittleEndian<qint32>(payload.constData() + 84);
+    result.magDec = qFromLittleEndian<qint16>(payload.constData() + 88);
+    result.magAcc = qFromLittleEndian<quint16>(payload.constData() + 90);
+}
 
+UbxParser::NavPvt UbxParser::parseNavPvt(const QByteArray &payload) {
+    NavPvt result;
+    decodeNavPvt(payload, result);
     return result;
 }
 
-UbxParser::NavSat UbxParser::parseNavSat(const QByteArray &payload) {
-    NavSat result = {};
+void UbxParser::decodeNavSat(const QByteArray &payload, NavSat &result) {
+    result = NavSat();
 
     if (payload.size() < 8) {
-        return result;
+        return;
     }
 
-    result.iTOW = qFromLittleEndian<quint32>(payload.mid(0, 4).constData());
+    result.iTOW = qFromLittleEndian<quint32>(payload.constData());
     result.version = static_cast<quint8>(payload[4]);
-    result.numSvs = static_cast<quint8>(payload[5]);
 
+    // numSvs comes from the peer; decode only the blocks that are present
     const int satSize = 12;
-    for (int i = 0; i < result.numSvs && (8 + i * satSize + satSize) <= payload.size(); i++) {
-        int offset = 8 + i * satSize;
-        result.sats[i].gnssId = static_cast<quint8>(payload[offset]);
-        result.sats[i].svId = static_cast<quint8>(payload[offset+1]);
-        result.sats[i].cno = static_cast<quint8>(payload[offset+2]);
-        result.sats[i].elev = static_cast<quint8>(payload[offset+3]);
-        result.sats[i].azim = qFromLittleEndian<qint16>(payload.mid(offset+4, 2).constData());
-        result.sats[i].flags = qFromLittleEndian<quint32>(payload.mid(offset+8, 4).constData());
+    const int count = qMin<int>(static_cast<quint8>(payload[5]), (payload.size() - 8) / satSize);
+    result.numSvs = static_cast<quint8>(count);
+    for (int i = 0; i < count; i++) {
+        const char *sat = payload.constData() + 8 + i * satSize;
+        result.sats[i].gnssId = static_cast<quint8>(sat[0]);
+        result.sats[i].svId = static_cast<quint8>(sat[1]);
+        result.sats[i].cno = static_cast<quint8>(sat[2]);
+        result.sats[i].elev = static_cast<qint8>(sat[3]);
+        result.sats[i].azim = qFromLittleEndian<qint16>(sat + 4);
+        result.sats[i].flags = qFromLittleEndian<quint32>(sat + 8);
     }
+}
 
+UbxParser::NavSat UbxParser::parseNavSat(const QByteArray &payload) {
+    NavSat result;
+    decodeNavSat(payload, result);
     return result;
 }
 
-UbxParser::NavStatus UbxParser::parseNavStatus(const QByteArray &payload) {
-    NavStatus result = {};
+void UbxParser::decodeNavStatus(const QByteArray &payload, NavStatus &result) {
+    result = NavStatus();
 
     if (payload.size() < 16) {
-        return result;
+        return;
     }
 
-    result.iTOW = qFromLittleEndian<quint32>(payload.mid(0, 4).constData());
+    result.iTOW = qFromLittleEndian<quint32>(payload.constData());
     result.fixType = static_cast<quint8>(payload[4]);
     result.flags = static_cast<quint8>(payload[5]);
-    result.ttff = qFromLittleEndian<quint32>(payload.mid(8, 4).constData());
-
-    qDebug() << "Parsed NAV-STATUS:"
-             << "Fix:" << result.fixType << "TTFF:" << result.ttff << "ms";
+    result.ttff = qFromLittleEndian<quint32>(payload.constData() + 8);
+}
 
+UbxParser::NavStatus UbxParser::parseNavStatus(const QByteArray &payload) {
+    NavStatus result;
+    decodeNavStatus(payload, result);
     return result;
 }
 
-UbxParser::CfgPrt UbxParser::parseCfgPrt(const QByteArray &payload) {
-    CfgPrt result = {};
+void UbxParser::decodeCfgPrt(const QByteArray &payload, CfgPrt &result) {
+    result = CfgPrt();
 
     if (payload.size() < 20) {
-        return result;
+        return;
     }
 
     result.portID = static_cast<quint8>(payload[0]);
-    result.baudRate = qFromLittleEndian<quint32>(payload.mid(8, 4).constData());
-    result.inProtoMask = qFromLittleEndian<quint16>(payload.mid(12, 2).constData());
-    result.outProtoMask = qFromLittleEndian<quint16>(payload.mid(14, 2).constData());
+    result.baudRate = qFromLittleEndian<quint32>(payload.constData() + 8);
+    result.inProtoMask = qFromLittleEndian<quint16>(payload.constData() + 12);
+    result.outProtoMask = qFromLittleEndian<quint16>(payload.constData() + 14);
+}
 
+UbxParser::CfgPrt UbxParser::parseCfgPrt(const QByteArray &payload) {
+    CfgPrt result;
+    decodeCfgPrt(payload, result);
     return result;
 }
 
@@ -185,42 +245,56 @@ UbxParser::AckPacket UbxParser::parseAck(const QByteArray &payload) {
     return ack;
 }
 
-UbxParser::SecUniqid UbxParser::parseSecUniqid(const QByteArray &payload) {
-    SecUniqid result = {};
+void UbxParser::decodeSecUniqid(const QByteArray &payload, SecUniqid &result) {
+    result = SecUniqid();
 
-    if (payload.size() < 5) {
-        return result;
+    if (payload.size() < 9) {
+        return;
     }
 
+    // version, 3 reserved bytes, then the 5-byte ID most significant first
     result.version = static_cast<quint8>(payload[0]);
-    result.uniqueId = qFromLittleEndian<quint32>(payload.mid(1, 4).constData());
+    for (int i = 4; i < 9; i++) {
+        result.uniqueId = (result.uniqueId << 8) | static_cast<quint8>(payload[i]);
+    }
+}
 
+UbxParser::SecUniqid UbxParser::parseSecUniqid(const QByteArray &payload) {
+    SecUniqid result;
+    decodeSecUniqid(payload, result);
     return result;
 }
 
-UbxParser::CfgMsg UbxParser::parseCfgMsg(const QByteArray &payload) {
-    CfgMsg result = {};
+void UbxParser::decodeCfgMsg(const QByteArray &payload, CfgMsg &result) {
+    result = CfgMsg();
 
     if (payload.size() < 3) {
-        return result;
+        return;
     }
 
     result.msgClass = static_cast<quint8>(payload[0]);
     result.msgId = static_cast<quint8>(payload[1]);
     result.rate = static_cast<quint8>(payload[2]);
+}
 
+UbxParser::CfgMsg UbxParser::parseCfgMsg(const QByteArray &payload) {
+    CfgMsg result;
+    decodeCfgMsg(payload, result);
     return result;
 }
 
-UbxParser::MonRf UbxParser::parseMonRf(const QByteArray &payload) {
-    MonRf result = {};
+void UbxParser::decodeMonRf(const QByteArray &payload, MonRf &result) {
+    result.version = 0;
+    result.nBlocks = 0;
+    result.reserved1[0] = result.reserved1[1] = 0;
+    result.blocks.resize(0);
     const int headerSize = 4;
     const int blockSize = 24;
 
     if (payload.size() < headerSize) {
         qWarning() << "MON-RF payload too small:" << payload.size()
                    << "bytes, expected at least" << headerSize;
-        return result;
+        return;
     }
 
     result.version = static_cast<quint8>(payload[0]);
@@ -232,76 +306,99 @@ UbxParser::MonRf UbxParser::parseMonRf(const QByteArray &payload) {
     if (payload.size() < expectedSize) {
         qWarning() << "MON-RF payload too small for blocks:" << payload.size()
                    << "bytes, expected" << expectedSize;
-        return result;
+        return;
     }
 
-    for (int i = 0; i < result.nBlocks && i < 4; i++) {
+    result.blocks.resize(result.nBlocks);
+    for (int i = 0; i < result.nBlocks; i++) {
         int offset = headerSize + i * blockSize;
         auto& block = result.blocks[i];
+        block = MonRf::RfBlock();
 
         block.antId = static_cast<quint8>(payload[offset]);
         block.flags = static_cast<quint8>(payload[offset+1]);
         block.antStatus = static_cast<quint8>(payload[offset+2]);
         block.antPower = static_cast<quint8>(payload[offset+3]);
-        block.postStatus = qFromLittleEndian<quint32>(payload.mid(offset+4, 4).constData());
-        block.noisePerMS = qFromLittleEndian<quint16>(payload.mid(offset+12, 2).constData());
-        block.agcCnt = qFromLittleEndian<quint16>(payload.mid(offset+14, 2).constData());
+        block.postStatus = qFromLittleEndian<quint32>(payload.constData() + offset + 4);
+        block.noisePerMS = qFromLittleEndian<quint16>(payload.constData() + offset + 12);
+        block.agcCnt = qFromLittleEndian<quint16>(payload.constData() + offset + 14);
         block.cwSuppression = static_cast<quint8>(payload[offset+16]);
         block.ofsI = static_cast<qint8>(payload[offset+17]);
         block.magI = static_cast<quint8>(payload[offset+18]);
         block.ofsQ = static_cast<qint8>(payload[offset+19]);
         block.magQ = static_cast<quint8>(payload[offset+20]);
     }
+}
 
+UbxParser::MonRf UbxParser::parseMonRf(const QByteArray &payload) {
+    MonRf result;
+    decodeMonRf(payload, result);
     return result;
 }
 
-UbxParser::MonVer UbxParser::parseMonVer(const QByteArray &payload) {
-    MonVer result;
-    int pos = 0;
+namespace {
+
+// Fixed-size, NUL-padded string field; the terminator may be missing
+QString latin1Field(const QByteArray &payload, int pos, int size) {
+    const char *field = payload.constData() + pos;
+    return QString::fromLatin1(field, static_cast<int>(qstrnlen(field, static_cast<uint>(size))));
+}
 
-    result.swVersion = QString::fromLatin1(payload.constData() + pos);
-    pos += result.swVersion.length() + 1;
+} // namespace
+
+void UbxParser::decodeMonVer(const QByteArray &payload, MonVer &result) {
+    result = MonVer();
+    const int swSize = 30;
+    const int hwSize = 10;
+    const int extensionSize = 30;
+
+    if (payload.size() < swSize + hwSize) {
+        qWarning() << "MON-VER payload too small:" << payload.size()
+                   << "bytes, expected at least" << swSize + hwSize;
+        return;
+    }
 
-    result.hwVersion = QString::fromLatin1(payload.constData() + pos);
-    pos += result.hwVersion.length() + 1;
+    result.swVersion = latin1Field(payload, 0, swSize);
+    result.hwVersion = latin1Field(payload, swSize, hwSize);
 
-    while (pos < payload.size()) {
-        QString ext = QString::fromLatin1(payload.constData() + pos);
-        if (ext.isEmpty()) {
-            break;
+    for (int pos = swSize + hwSize; pos + extensionSize <= payload.size(); pos += extensionSize) {
+        const QString ext = latin1Field(payload, pos, extensionSize);
+        if (!ext.isEmpty()) {
+            result.extensions.append(ext);
         }
-        result.extensions.append(ext);
-        pos += ext.length() + 1;
     }
+}
 
+UbxParser::MonVer UbxParser::parseMonVer(const QByteArray &payload) {
+    MonVer result;
+    decodeMonVer(payload, result);
     return result;
 }
 
-UbxParser::MonHw UbxParser::parseMonHw(const QByteArray &payload) {
-    MonHw result = {};
+void UbxParser::decodeMonHw(const QByteArray &payload, MonHw &result) {
+    result = MonHw();
     const int minSize = 28 + 4 + 17 + 1 + 2;
 
     if (payload.size() < minSize) {
         qWarning() << "MON-HW payload too small:" << payload.size()
                    << "bytes, expected at least" << minSize;
-        return result;
+        return;
     }
 
-    result.pinSel = qFromLittleEndian<quint32>(payload.mid(0, 4).constData());
-    result.pinBank = qFromLittleEndian<quint32>(payload.mid(4, 4).constData());
-    result.pinDir = qFromLittleEndian<quint32>(payload.mid(8, 4).constData());
-    result.pinVal = qFromLittleEndian<quint32>(payload.mid(12, 4).constData());
+    result.pinSel = qFromLittleEndian<quint32>(payload.constData());
+    result.pinBank = qFromLittleEndian<quint32>(payload.constData() + 4);
+    result.pinDir = qFromLittleEndian<quint32>(payload.constData() + 8);
+    result.pinVal = qFromLittleEndian<quint32>(payload.constData() + 12);
 
-    result.noisePerMS = qFromLittleEndian<quint16>(payload.mid(16, 2).constData());
-    result.agcCnt = qFromLittleEndian<quint16>(payload.mid(18, 2).constData());
+    result.noisePerMS = qFromLittleEndian<quint16>(payload.constData() + 16);
+    result.agcCnt = qFromLittleEndian<quint16>(payload.constData() + 18);
 
     result.aStatus = static_cast<quint8>(payload[20]);
     result.aPower = static_cast<quint8>(payload[21]);
     result.flags = static_cast<quint8>(payload[22]);
     result.reserved1 = static_cast<quint8>(payload[23]);
 
-    result.usedMask = qFromLittleEndian<quint32>(payload.mid(24, 4).constData());
+    result.usedMask = qFromLittleEndian<quint32>(payload.constData() + 24);
 
     const int vpStart = 28;
     for (int i = 0; i < 17 && (vpStart + i) < payload.size(); i++) {
@@ -323,10 +420,14 @@ UbxParser::MonHw UbxParser::parseMonHw(const QByteArray &payload) {
 
     const int pinIrqPos = jamIndPos + 3;
     if (payload.size() >= pinIrqPos + 12) {
-        result.pinIrq = qFromLittleEndian<quint32>(payload.mid(pinIrqPos, 4).constData());
-        result.pullH = qFromLittleEndian<quint32>(payload.mid(pinIrqPos + 4, 4).constData());
-        result.pullL = qFromLittleEndian<quint32>(payload.mid(pinIrqPos + 8, 4).constData());
+        result.pinIrq = qFromLittleEndian<quint32>(payload.constData() + pinIrqPos);
+        result.pullH = qFromLittleEndian<quint32>(payload.constData() + pinIrqPos + 4);
+        result.pullL = qFromLittleEndian<quint32>(payload.constData() + pinIrqPos + 8);
     }
+}
 
+UbxParser::MonHw UbxParser::parseMonHw(const QByteArray &payload) {
+    MonHw result;
+    decodeMonHw(payload, result);
     return result;
 }
@@ -5,6 +5,8 @@
 #include <QByteArray>
 #include <QDateTime>
 #include <QtEndian>
+#include <QVector>
+#include "ubxmessagepool.h"
 
 class UbxParser : public QObject {
     Q_OBJECT
@@ -36,19 +38,21 @@ public:
         qint32 velN;         // Velocity North (mm/s)
         qint32 velE;         // Velocity East (mm/s)
         qint32 velD;         // Velocity Down (mm/s)
-        quint32 speed;       // Speed (3D, mm/s)
         quint32 gSpeed;      // Ground speed (2D, mm/s)
         quint32 headMot;     // Heading of motion (deg * 1e-5)
         quint32 sAcc;        // Speed accuracy estimate (mm/s)
         quint32 headAcc;     // Heading accuracy estimate (deg * 1e-5)
         quint16 pDOP;        // Position DOP (0.01)
         quint8 reserved[6];
+        qint32 headVeh;      // Heading of vehicle (deg * 1e-5), valid with flags bit 5
+        qint16 magDec;       // Magnetic declination (deg * 1e-2)
+        quint16 magAcc;      // Magnetic declination accuracy (deg * 1e-2)
     };
 
     struct NavSat {
         quint32 iTOW;
         quint8 version;
-        quint8 numSvs;
+        quint8 numSvs;      // Blocks actually decoded
         struct SatelliteInfo {
             quint8 gnssId;
             quint8 svId;
@@ -56,7 +60,7 @@ public:
             qint8 elev;
             qint16 azim;
             quint32 flags;
-        } sats[128];
+        } sats[255];
     };
 
     struct NavStatus {
@@ -129,7 +133,11 @@ public:
             qint8 ofsQ;
             quint8 magQ;
             quint8 reserved2[3];
-        } blocks[4];
+        };
+
+        // One block per RF band, as many as nBlocks announces. The vector
+        // keeps its capacity when the pooled message is decoded again.
+        QVector<RfBlock> blocks;
     };
     struct AckPacket {
         quint8 ackClass;
@@ -156,19 +164,35 @@ public:
 
     struct SecUniqid {
         quint8 version;
-        quint32 uniqueId;
+        quint64 uniqueId;   // 40 bits
     };
 
+    // Shared read-only views of pooled, decoded messages
+    using NavPvtHandle = UbxMessagePool<NavPvt>::Handle;
+    using NavSatHandle = UbxMessagePool<NavSat>::Handle;
+    using NavStatusHandle = UbxMessagePool<NavStatus>::Handle;
+    using MonVerHandle = UbxMessagePool<MonVer>::Handle;
+    using MonHwHandle = UbxMessagePool<MonHw>::Handle;
+    using MonRfHandle = UbxMessagePool<MonRf>::Handle;
+    using CfgPrtHandle = UbxMessagePool<CfgPrt>::Handle;
+    using CfgMsgHandle = UbxMessagePool<CfgMsg>::Handle;
+    using SecUniqidHandle = UbxMessagePool<SecUniqid>::Handle;
+
+    // Decodes the payload once and emits the matching *Received signal.
+    // Messages nobody subscribed to are not decoded at all. Returns false
+    // for class/id pairs without a typed signal.
+    bool dispatch(quint8 msgClass, quint8 msgId, const QByteArray &payload);
+
 signals:
-    void navPvtReceived(const NavPvt &data);
-    void navSatReceived(const NavSat &data);
-    void navStatusReceived(const NavStatus &data);
-    void monVerReceived(const MonVer &data);
-    void monHwReceived(const MonHw &data);
-    void cfgPrtReceived(const CfgPrt &data);
-    void secUniqidReceived(const SecUniqid &data);
-    void monRfReceived(const MonRf &data);
-    void cfgMsgReceived(const CfgMsg &data);
+    void navPvtReceived(const UbxParser::NavPvtHandle &data);
+    void navSatReceived(const UbxParser::NavSatHandle &data);
+    void navStatusReceived(const UbxParser::NavStatusHandle &data);
+    void monVerReceived(const UbxParser::MonVerHandle &data);
+    void monHwReceived(const UbxParser::MonHwHandle &data);
+    void cfgPrtReceived(const UbxParser::CfgPrtHandle &data);
+    void secUniqidReceived(const UbxParser::SecUniqidHandle &data);
+    void monRfReceived(const UbxParser::MonRfHandle &data);
+    void cfgMsgReceived(const UbxParser::CfgMsgHandle &data);
     void infErrorReceived(const QString &msg);
 
 public:
@@ -191,6 +215,31 @@ public:
     static MonVer parseMonVer(const QByteArray &payload);
     static SecUniqid parseSecUniqid(const QByteArray &payload);
     static CfgMsg parseCfgMsg(const QByteArray &payload);
+
+    // In-place variants used to fill pooled slots
+    static void decodeNavPvt(const QByteArray &payload, NavPvt &result);
+    static void decodeNavSat(const QByteArray &payload, NavSat &result);
+    static void decodeNavStatus(const QByteArray &payload, NavStatus &result);
+    static void decodeCfgPrt(const QByteArray &payload, CfgPrt &result);
+    static void decodeMonVer(const QByteArray &payload, MonVer &result);
+    static void decodeMonHw(const QByteArray &payload, MonHw &result);
+    static void decodeMonRf(const QByteArray &payload, MonRf &result);
+    static void decodeSecUniqid(const QByteArray &payload, SecUniqid &result);
+    static void decodeCfgMsg(const QByteArray &payload, CfgMsg &result);
+
+private:
+    template <typename T, typename Signal>
+    bool publish(Signal signal, const QByteArray &payload, void (*decode)(const QByteArray &, T &));
 };
 
+Q_DECLARE_METATYPE(UbxParser::NavPvtHandle)
+Q_DECLARE_METATYPE(UbxParser::NavSatHandle)
+Q_DECLARE_METATYPE(UbxParser::NavStatusHandle)
+Q_DECLARE_METATYPE(UbxParser::MonVerHandle)
+Q_DECLARE_METATYPE(UbxParser::MonHwHandle)
+Q_DECLARE_METATYPE(UbxParser::MonRfHandle)
+Q_DECLARE_METATYPE(UbxParser::CfgPrtHandle)
+Q_DECLARE_METATYPE(UbxParser::CfgMsgHandle)
+Q_DECLARE_METATYPE(UbxParser::SecUniqidHandle)
+
 #endif
@@ -0,0 +1,73 @@
+#include "ubxratetable.h"
+#include "ubxdefs.h"
+
+#include <cstring>
+
+namespace {
+
+struct OutputInfo {
+    quint8 msgClass;
+    quint8 msgId;
+    quint32 baseKey;    // CFG-MSGOUT key of the I2C port
+    const char *name;
+};
+
+const OutputInfo s_outputs[UbxRateTable::OutputCount] = {
+    { UBX_CLASS_NAV, UBX_NAV_PVT, 0x20910006, "NAV-PVT" },
+    { UBX_CLASS_NAV, UBX_NAV_STATUS, 0x2091001a, "NAV-STATUS" },
+    { UBX_CLASS_NAV, UBX_NAV_SAT, 0x20910015, "NAV-SAT" },
+    { UBX_CLASS_NAV, UBX_NAV_TIMEUTC, 0x2091005b, "NAV-TIMEUTC" },
+    { UBX_CLASS_MON, UBX_MON_HW, 0x209101b4, "MON-HW" },
+    { UBX_CLASS_MON, UBX_MON_RF, 0x20910359, "MON-RF" }
+};
+
+} // namespace
+
+UbxRateTable::UbxRateTable() {
+    memset(m_rates, 0, sizeof(m_rates));
+}
+
+int UbxRateTable::outputOf(quint8 msgClass, quint8 msgId) {
+    for (int i = 0; i < OutputCount; i++) {
+        if (s_outputs[i].msgClass == msgClass && s_outputs[i].msgId == msgId) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+quint8 UbxRateTable::messageClass(int output) {
+    return s_outputs[output].msgClass;
+}
+
+quint8 UbxRateTable::messageId(int output) {
+    return s_outputs[output].msgId;
+}
+
+const char *UbxRateTable::name(int output) {
+    return s_outputs[output].name;
+}
+
+quint32 UbxRateTable::keyFor(int output, int port) {
+    return s_outputs[output].baseKey + static_cast<quint32>(port);
+}
+
+bool UbxRateTable::fromKey(quint32 id, int &output, int &port) {
+    for (int i = 0; i < OutputCount; i++) {
+        if (id >= s_outputs[i].baseKey && id < s_outputs[i].baseKey + PortCount) {
+            output = i;
+            port = static_cast<int>(id - s_outputs[i].baseKey);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UbxRateTable::anyEnabled(int port) const {
+    for (int i = 0; i < OutputCount; i++) {
+        if (m_rates[i][port] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
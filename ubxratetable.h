@@ -0,0 +1,57 @@
+#ifndef UBX_RATE_TABLE_H
+#define UBX_RATE_TABLE_H
+
+#include <QtGlobal>
+
+// Periodic output rates per message and port, in navigation epochs as on a
+// real receiver: rate N sends the message every Nth epoch, 0 disables it.
+// The configuration database owns the values (CFG-MSGOUT keys); the table
+// is the emitter's cached copy, indexed so an epoch costs one lookup per
+// message.
+class UbxRateTable {
+public:
+    enum Output {
+        NavPvt,
+        NavStatus,
+        NavSat,
+        NavTimeUtc,
+        MonHw,
+        MonRf,
+        OutputCount
+    };
+
+    // Same order as the rate array of CFG-MSG and the MSGOUT key suffixes
+    enum Port {
+        I2c,
+        Uart1,
+        Uart2,
+        Usb,
+        Spi,
+        PortCount
+    };
+
+    UbxRateTable();
+
+    static int outputOf(quint8 msgClass, quint8 msgId);   // -1 if not periodic
+    static quint8 messageClass(int output);
+    static quint8 messageId(int output);
+    static const char *name(int output);
+
+    static quint32 keyFor(int output, int port);
+    static bool fromKey(quint32 id, int &output, int &port);
+
+    quint8 rate(int output, int port) const { return m_rates[output][port]; }
+    void setRate(int output, int port, quint8 rate) { m_rates[output][port] = rate; }
+
+    bool due(int output, int port, quint32 epoch) const {
+        const quint8 r = m_rates[output][port];
+        return r != 0 && epoch % r == 0;
+    }
+
+    bool anyEnabled(int port) const;
+
+private:
+    quint8 m_rates[OutputCount][PortCount];
+};
+
+#endif // UBX_RATE_TABLE_H
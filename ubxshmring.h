@@ -0,0 +1,229 @@
+/*
+ * Shared-memory link between the imitator and a co-located consumer
+ * (software-in-the-loop autopilot). Plain C so the consumer can include it
+ * without Qt; the imitator uses the same definitions.
+ *
+ * The segment holds two single-producer/single-consumer byte rings: "out"
+ * carries UBX frames from the imitator, "in" carries frames back. Every
+ * record is a 32-bit length followed by one whole frame, padded to 8 bytes,
+ * and never wraps: when it does not fit before the end of the ring, a
+ * UBX_SHM_WRAP marker sends the reader back to offset 0. A reader therefore
+ * gets each frame as one contiguous block and can parse it in place.
+ *
+ * Consumer loop:
+ *
+ *   int fd = shm_open("/ubx-imitator-40001", O_RDWR, 0);
+ *   struct ubx_shm_segment *seg = mmap(NULL, size, PROT_READ | PROT_WRITE,
+ *                                      MAP_SHARED, fd, 0);
+ *   for (;;) {
+ *       const unsigned char *frame;
+ *       uint32_t size;
+ *       int status = ubx_shm_peek(&seg->out, ubx_shm_out_data(seg),
+ *                                 seg->capacity, &frame, &size);
+ *       if (status == UBX_SHM_EMPTY) {
+ *           ubx_shm_wait(&seg->out, 100000000);
+ *           continue;
+ *       }
+ *       if (status == UBX_SHM_CORRUPT)
+ *           break;
+ *       handle_ubx(frame, size);
+ *       ubx_shm_release(&seg->out, size);
+ *   }
+ *
+ * ubx_shm_wait() sleeps on a futex on Linux. Elsewhere it returns at once
+ * and the consumer polls. The imitator clears seg->magic and wakes the
+ * consumer when it closes the link.
+ */
+#ifndef UBX_SHM_RING_H
+#define UBX_SHM_RING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define UBX_SHM_MAGIC 0x55425852u   /* "UBXR", set once the segment is ready */
+#define UBX_SHM_VERSION 1u
+#define UBX_SHM_WRAP 0xFFFFFFFFu
+#define UBX_SHM_ALIGN 8u
+
+/* ubx_shm_peek() results */
+#define UBX_SHM_CORRUPT (-1)
+#define UBX_SHM_EMPTY 0
+#define UBX_SHM_FRAME 1
+
+/* Producer and consumer indices live on separate cache lines */
+struct ubx_shm_ring {
+    uint64_t head;          /* Bytes committed by the producer, monotonic */
+    unsigned char pad0[56];
+    uint64_t tail;          /* Bytes released by the consumer, monotonic */
+    unsigned char pad1[56];
+    uint32_t seq;           /* Futex word, bumped on every commit */
+    uint32_t waiting;       /* Non-zero while the consumer sleeps on seq */
+    unsigned char pad2[56];
+};
+
+struct ubx_shm_segment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;      /* Bytes per ring, a power of two */
+    uint32_t producer_pid;
+    unsigned char pad[48];
+    struct ubx_shm_ring out;
+    struct ubx_shm_ring in;
+    /* Followed by the out data, then the in data, capacity bytes each */
+};
+
+static inline uint64_t ubx_shm_segment_size(uint32_t capacity) {
+    return sizeof(struct ubx_shm_segment) + 2 * (uint64_t)capacity;
+}
+
+static inline unsigned char *ubx_shm_out_data(struct ubx_shm_segment *seg) {
+    return (unsigned char *)(seg + 1);
+}
+
+static inline unsigned char *ubx_shm_in_data(struct ubx_shm_segment *seg) {
+    return (unsigned char *)(seg + 1) + seg->capacity;
+}
+
+static inline uint32_t ubx_shm_record_size(uint32_t size) {
+    return (4u + size + UBX_SHM_ALIGN - 1) & ~(UBX_SHM_ALIGN - 1);
+}
+
+/*
+ * Producer side. Returns room for a frame of the given size, or NULL when
+ * the ring is full; the frame is published by ubx_shm_commit() with the
+ * same size.
+ */
+static inline unsigned char *ubx_shm_reserve(struct ubx_shm_ring *ring, unsigned char *data,
+                                             uint32_t capacity, uint32_t size) {
+    const uint64_t head = ring->head;
+    const uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    const uint32_t offset = (uint32_t)(head & (capacity - 1));
+    const uint32_t record = ubx_shm_record_size(size);
+    const uint32_t skip = capacity - offset < record ? capacity - offset : 0;
+
+    if (record > capacity || head + skip + record - tail > capacity) {
+        return NULL;
+    }
+    if (skip) {
+        const uint32_t wrap = UBX_SHM_WRAP;
+        memcpy(data + offset, &wrap, 4);
+        return data + 4;
+    }
+    return data + offset + 4;
+}
+
+static inline void ubx_shm_wake(struct ubx_shm_ring *ring) {
+    __atomic_fetch_add(&ring->seq, 1, __ATOMIC_SEQ_CST);
+#if defined(__linux__)
+    syscall(SYS_futex, &ring->seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+static inline void ubx_shm_commit(struct ubx_shm_ring *ring, unsigned char *data,
+                                  uint32_t capacity, uint32_t size) {
+    const uint64_t head = ring->head;
+    const uint32_t offset = (uint32_t)(head & (capacity - 1));
+    const uint32_t record = ubx_shm_record_size(size);
+    const uint32_t skip = capacity - offset < record ? capacity - offset : 0;
+
+    memcpy(data + (skip ? 0 : offset), &size, 4);
+    __atomic_store_n(&ring->head, head + skip + record, __ATOMIC_RELEASE);
+
+    /* Pairs with the waiting store in ubx_shm_wait() */
+    __atomic_fetch_add(&ring->seq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_SEQ_CST)) {
+#if defined(__linux__)
+        syscall(SYS_futex, &ring->seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+    }
+}
+
+static inline int ubx_shm_write(struct ubx_shm_ring *ring, unsigned char *data,
+                                uint32_t capacity, const void *frame, uint32_t size) {
+    unsigned char *slot = ubx_shm_reserve(ring, data, capacity, size);
+    if (!slot) {
+        return 0;
+    }
+    memcpy(slot, frame, size);
+    ubx_shm_commit(ring, data, capacity, size);
+    return 1;
+}
+
+/*
+ * Consumer side. Points frame at the next frame in place and returns
+ * UBX_SHM_FRAME, or returns UBX_SHM_EMPTY. The frame stays valid until
+ * ubx_shm_release(). Lengths and indices come from the peer, so a record
+ * that would reach past the end of the ring or past head yields
+ * UBX_SHM_CORRUPT; the ring is then unusable and the link must be closed.
+ */
+static inline int ubx_shm_peek(struct ubx_shm_ring *ring, unsigned char *data, uint32_t capacity,
+                               const unsigned char **frame, uint32_t *size) {
+    uint64_t tail = ring->tail;
+    const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t offset;
+    uint32_t length;
+
+    if (tail == head) {
+        return UBX_SHM_EMPTY;
+    }
+    if (head - tail > capacity) {
+        return UBX_SHM_CORRUPT;
+    }
+    offset = (uint32_t)(tail & (capacity - 1));
+    memcpy(&length, data + offset, 4);
+    if (length == UBX_SHM_WRAP) {
+        /* A wrap marker is always followed by a record at offset 0 */
+        tail += capacity - offset;
+        if (tail >= head) {
+            return UBX_SHM_CORRUPT;
+        }
+        offset = 0;
+        memcpy(&length, data, 4);
+    }
+    if (length > capacity - offset - 4 || tail + ubx_shm_record_size(length) > head) {
+        return UBX_SHM_CORRUPT;
+    }
+    if (tail != ring->tail) {
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    *frame = data + offset + 4;
+    *size = length;
+    return UBX_SHM_FRAME;
+}
+
+static inline void ubx_shm_release(struct ubx_shm_ring *ring, uint32_t size) {
+    __atomic_store_n(&ring->tail, ring->tail + ubx_shm_record_size(size), __ATOMIC_RELEASE);
+}
+
+/*
+ * Sleeps until the producer commits or timeout_ns passes (0 waits forever).
+ * Returns 1 when the ring has data.
+ */
+static inline int ubx_shm_wait(struct ubx_shm_ring *ring, int64_t timeout_ns) {
+    uint32_t seq;
+
+    __atomic_store_n(&ring->waiting, 1, __ATOMIC_SEQ_CST);
+    seq = __atomic_load_n(&ring->seq, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail) {
+#if defined(__linux__)
+        struct timespec timeout;
+        timeout.tv_sec = (time_t)(timeout_ns / 1000000000);
+        timeout.tv_nsec = (long)(timeout_ns % 1000000000);
+        syscall(SYS_futex, &ring->seq, FUTEX_WAIT, seq, timeout_ns > 0 ? &timeout : NULL, NULL, 0);
+#else
+        (void)seq;
+        (void)timeout_ns;
+#endif
+    }
+    __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != ring->tail;
+}
+
+#endif /* UBX_SHM_RING_H */
@@ -0,0 +1,45 @@
+#include "ubxtime.h"
+
+#include <QDateTime>
+
+namespace {
+
+const qint64 MSecsPerDay = 24 * 60 * 60 * 1000LL;
+const qint64 MSecsPerWeek = 7 * MSecsPerDay;
+
+// Floor division, so times before 1970 land on the right day
+qint64 floorDiv(qint64 a, qint64 b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+} // namespace
+
+UbxTime UbxTime::fromMSecs(qint64 msecs) {
+    UbxTime t;
+    t.msecs = msecs;
+    t.iTOW = static_cast<quint32>(msecs - floorDiv(msecs, MSecsPerWeek) * MSecsPerWeek);
+
+    const qint64 days = floorDiv(msecs, MSecsPerDay);
+    const qint64 msOfDay = msecs - days * MSecsPerDay;
+    t.hour = static_cast<quint8>(msOfDay / 3600000);
+    t.minute = static_cast<quint8>(msOfDay / 60000 % 60);
+    t.second = static_cast<quint8>(msOfDay / 1000 % 60);
+
+    // Civil date from a day count, with March as the first month of the
+    // year so the leap day comes last (H. Hinnant, days_from_civil inverse)
+    const qint64 z = days + 719468;
+    const qint64 era = floorDiv(z, 146097);
+    const qint64 doe = z - era * 146097;
+    const qint64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const qint64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const qint64 mp = (5 * doy + 2) / 153;
+    const qint64 month = mp < 10 ? mp + 3 : mp - 9;
+    t.day = static_cast<quint8>(doy - (153 * mp + 2) / 5 + 1);
+    t.month = static_cast<quint8>(month);
+    t.year = static_cast<quint16>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+    return t;
+}
+
+UbxTime UbxTime::now() {
+    return fromMSecs(QDateTime::currentMSecsSinceEpoch());
+}
@@ -0,0 +1,24 @@
+#ifndef UBX_TIME_H
+#define UBX_TIME_H
+
+#include <QtGlobal>
+
+// UTC time fields as NAV-PVT, NAV-TIMEUTC and NAV-STATUS carry them,
+// worked out arithmetically from ms since the Unix epoch. Unlike
+// QDateTime this never consults the time zone database or allocates, so
+// it is cheap enough to call for every frame.
+struct UbxTime {
+    qint64 msecs = 0;       // UTC, ms since the Unix epoch
+    quint32 iTOW = 0;       // ms into the week
+    quint16 year = 1970;
+    quint8 month = 1;
+    quint8 day = 1;
+    quint8 hour = 0;
+    quint8 minute = 0;
+    quint8 second = 0;
+
+    static UbxTime fromMSecs(qint64 msecs);
+    static UbxTime now();
+};
+
+#endif // UBX_TIME_H
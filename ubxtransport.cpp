@@ -0,0 +1,196 @@
+#include "ubxtransport.h"
+
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+
+// TcpClientTransport
+
+TcpClientTransport::TcpClientTransport(const QString &host, quint16 port, QObject *parent)
+    : UbxTransport(parent), m_socket(new QTcpSocket(this)), m_host(host), m_port(port) {
+    connect(m_socket, &QTcpSocket::connected, this, &UbxTransport::opened);
+    connect(m_socket, &QTcpSocket::disconnected, this, &UbxTransport::closed);
+    connect(m_socket, &QTcpSocket::readyRead, this, &UbxTransport::readyRead);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        emit errorOccurred(m_socket->errorString());
+    });
+}
+
+void TcpClientTransport::open() {
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void TcpClientTransport::close() {
+    if (m_socket->state() == QAbstractSocket::ConnectedState) {
+        m_socket->disconnectFromHost();
+        if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+            m_socket->waitForDisconnected(1000);
+        }
+    } else {
+        m_socket->abort();
+    }
+}
+
+bool TcpClientTransport::isOpen() const {
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 TcpClientTransport::write(const char *data, qint64 size) {
+    return m_socket->write(data, size);
+}
+
+QByteArray TcpClientTransport::readAll() {
+    return m_socket->readAll();
+}
+
+QString TcpClientTransport::errorString() const {
+    return m_socket->errorString();
+}
+
+QString TcpClientTransport::description() const {
+    return tr("TCP client %1:%2").arg(m_host).arg(m_port);
+}
+
+bool TcpClientTransport::flush() {
+    return m_socket->flush();
+}
+
+// TcpServerTransport
+
+TcpServerTransport::TcpServerTransport(const QString &host, quint16 port, QObject *parent)
+    : UbxTransport(parent), m_server(new QTcpServer(this)), m_address(host), m_port(port) {
+    if (m_address.isNull()) {
+        m_address = QHostAddress::Any;
+    }
+    connect(m_server, &QTcpServer::newConnection, this, &TcpServerTransport::onNewConnection);
+}
+
+void TcpServerTransport::open() {
+    if (m_server->isListening()) {
+        return;
+    }
+    if (!m_server->listen(m_address, m_port)) {
+        emit errorOccurred(m_server->errorString());
+    }
+}
+
+void TcpServerTransport::onNewConnection() {
+    QTcpSocket *socket = m_server->nextPendingConnection();
+    if (!socket) {
+        return;
+    }
+
+    // The receiver has a single port, so a second client is turned away
+    if (m_client) {
+        socket->abort();
+        socket->deleteLater();
+        return;
+    }
+
+    m_client = socket;
+    connect(m_client, &QTcpSocket::readyRead, this, &UbxTransport::readyRead);
+    connect(m_client, &QTcpSocket::disconnected, this, [this]() {
+        m_client->deleteLater();
+        m_client = nullptr;
+        emit closed();
+    });
+    connect(m_client, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        if (m_client) {
+            emit errorOccurred(m_client->errorString());
+        }
+    });
+
+    emit opened();
+}
+
+void TcpServerTransport::close() {
+    if (m_client) {
+        m_client->disconnectFromHost();
+    }
+    m_server->close();
+}
+
+bool TcpServerTransport::isOpen() const {
+    return m_client && m_client->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 TcpServerTransport::write(const char *data, qint64 size) {
+    return m_client ? m_client->write(data, size) : -1;
+}
+
+QByteArray TcpServerTransport::readAll() {
+    return m_client ? m_client->readAll() : QByteArray();
+}
+
+QString TcpServerTransport::errorString() const {
+    return m_client ? m_client->errorString() : m_server->errorString();
+}
+
+QString TcpServerTransport::description() const {
+    return tr("TCP server %1:%2").arg(m_address.toString()).arg(m_port);
+}
+
+bool TcpServerTransport::flush() {
+    return m_client && m_client->flush();
+}
+
+// UdpTransport
+
+UdpTransport::UdpTransport(const QString &host, quint16 port, QObject *parent)
+    : UbxTransport(parent), m_socket(new QUdpSocket(this)), m_address(host), m_port(port) {
+    connect(m_socket, &QUdpSocket::readyRead, this, [this]() {
+        while (m_socket->hasPendingDatagrams()) {
+            m_pending.append(m_socket->receiveDatagram().data());
+        }
+        emit readyRead();
+    });
+    connect(m_socket, &QUdpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        emit errorOccurred(m_socket->errorString());
+    });
+}
+
+void UdpTransport::open() {
+    if (m_address.isNull()) {
+        emit errorOccurred(tr("Invalid UDP address"));
+        return;
+    }
+    // Ephemeral local port, the autopilot replies to the datagram source
+    if (m_socket->state() != QAbstractSocket::BoundState && !m_socket->bind()) {
+        emit errorOccurred(m_socket->errorString());
+        return;
+    }
+    emit opened();
+}
+
+void UdpTransport::close() {
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->close();
+        emit closed();
+    }
+}
+
+bool UdpTransport::isOpen() const {
+    return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+qint64 UdpTransport::write(const char *data, qint64 size) {
+    return m_socket->writeDatagram(data, size, m_address, m_port);
+}
+
+QByteArray UdpTransport::readAll() {
+    QByteArray data;
+    data.swap(m_pending);
+    return data;
+}
+
+QString UdpTransport::errorString() const {
+    return m_socket->errorString();
+}
+
+QString UdpTransport::description() const {
+    return tr("UDP %1:%2").arg(m_address.toString()).arg(m_port);
+}
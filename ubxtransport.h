@@ -0,0 +1,124 @@
+#ifndef UBX_TRANSPORT_H
+#define UBX_TRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QString>
+
+class QTcpSocket;
+class QTcpServer;
+class QUdpSocket;
+
+// Byte stream between the imitator and the autopilot. GNSSWindow writes
+// framed UBX packets and reads raw bytes without knowing the medium.
+class UbxTransport : public QObject {
+    Q_OBJECT
+
+public:
+    enum Kind {
+        TcpClient,
+        TcpServer,
+        Udp,
+        Pty,
+        SharedMemory,
+        UdpFanout
+    };
+
+    explicit UbxTransport(QObject *parent = nullptr) : QObject(parent) {}
+
+    static UbxTransport *create(Kind kind, const QString &host, quint16 port, QObject *parent = nullptr);
+
+    virtual void open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+    virtual qint64 write(const char *data, qint64 size) = 0;
+    virtual QByteArray readAll() = 0;
+    virtual QString errorString() const = 0;
+    virtual QString description() const = 0;
+    virtual bool flush() { return true; }
+
+    // Line rate of the emulated UART, ignored by transports without one
+    virtual void setBaudRate(quint32 baudRate) { Q_UNUSED(baudRate); }
+
+    // Navigation epoch boundaries, for transports that send an epoch's
+    // frames together
+    virtual void beginEpoch(quint32 epoch) { Q_UNUSED(epoch); }
+    virtual void endEpoch() {}
+
+signals:
+    void opened();
+    void closed();
+    void readyRead();
+    void errorOccurred(const QString &message);
+};
+
+class TcpClientTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    TcpClientTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+    bool flush() override;
+
+private:
+    QTcpSocket *m_socket;
+    QString m_host;
+    quint16 m_port;
+};
+
+// Listens for the autopilot and serves one client at a time
+class TcpServerTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    TcpServerTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+    bool flush() override;
+
+private:
+    void onNewConnection();
+
+    QTcpServer *m_server;
+    QTcpSocket *m_client = nullptr;
+    QHostAddress m_address;
+    quint16 m_port;
+};
+
+// Sends datagrams to host:port and accepts replies on the bound port
+class UdpTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    UdpTransport(const QString &host, quint16 port, QObject *parent = nullptr);
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+
+private:
+    QUdpSocket *m_socket;
+    QHostAddress m_address;
+    quint16 m_port;
+    QByteArray m_pending;
+};
+
+#endif // UBX_TRANSPORT_H
@@ -0,0 +1,24 @@
+#include "ubxtransport.h"
+#include "ptytransport.h"
+#include "shmtransport.h"
+#include "udpfanouttransport.h"
+
+// Kept apart from ubxtransport.cpp so that code using the base class
+// alone does not pull in every transport
+UbxTransport *UbxTransport::create(Kind kind, const QString &host, quint16 port, QObject *parent) {
+    switch (kind) {
+    case TcpServer:
+        return new TcpServerTransport(host, port, parent);
+    case Udp:
+        return new UdpTransport(host, port, parent);
+    case Pty:
+        return new PtyTransport(parent);
+    case SharedMemory:
+        return new ShmTransport(ShmTransport::segmentName(port), parent);
+    case UdpFanout:
+        return new UdpFanoutTransport(host, port, parent);
+    case TcpClient:
+    default:
+        return new TcpClientTransport(host, port, parent);
+    }
+}
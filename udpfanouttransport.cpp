@@ -0,0 +1,303 @@
+#include "udpfanouttransport.h"
+
+#include <QNetworkDatagram>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+struct UdpFanoutTransport::SendBuffers {
+    struct Slice {
+        const char *data;
+        int size;
+    };
+
+    std::vector<quint32> headers;   // Two little-endian words per datagram
+    std::vector<Slice> slices;      // Header (optional) and frames of each datagram
+    std::vector<int> datagrams;     // First slice and slice count, pairs
+    QByteArray scratch;             // Fallback path only
+#ifdef Q_OS_LINUX
+    std::vector<sockaddr_storage> names;
+    socklen_t nameSize = 0;
+    std::vector<iovec> iov;
+    std::vector<mmsghdr> msgs;
+#endif
+};
+
+bool UdpFanoutTransport::parseDestinations(const QString &list, quint16 defaultPort,
+                                           QVector<Destination> &destinations, QString &error) {
+    destinations.clear();
+    const QStringList items = list.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        QString host = item;
+        quint16 port = defaultPort;
+
+        // host:port, [v6]:port or a bare address
+        const int colon = item.lastIndexOf(':');
+        if (colon > 0 && (item.count(':') == 1 || item.startsWith('['))) {
+            bool ok = false;
+            port = item.mid(colon + 1).toUShort(&ok);
+            if (!ok || port == 0) {
+                error = tr("Invalid port in \"%1\"").arg(item);
+                return false;
+            }
+            host = item.left(colon);
+        }
+        if (host.startsWith('[') && host.endsWith(']')) {
+            host = host.mid(1, host.size() - 2);
+        }
+
+        const QHostAddress address(host);
+        if (address.isNull()) {
+            error = tr("Invalid address \"%1\"").arg(item);
+            return false;
+        }
+        destinations.append({ address, port });
+    }
+
+    if (destinations.isEmpty()) {
+        error = tr("No UDP destinations given");
+        return false;
+    }
+    return true;
+}
+
+UdpFanoutTransport::UdpFanoutTransport(const QString &destinations, quint16 defaultPort, QObject *parent)
+    : UbxTransport(parent),
+      m_socket(new QUdpSocket(this)),
+      m_destinationList(destinations),
+      m_defaultPort(defaultPort),
+      m_buffers(new SendBuffers) {
+    connect(m_socket, &QUdpSocket::readyRead, this, [this]() {
+        while (m_socket->hasPendingDatagrams()) {
+            m_pending.append(m_socket->receiveDatagram().data());
+        }
+        emit readyRead();
+    });
+    connect(m_socket, &QUdpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        emit errorOccurred(m_socket->errorString());
+    });
+
+    // reserve() keeps the capacity across resize(0) between epochs
+    m_batch.reserve(16 * 1024);
+}
+
+UdpFanoutTransport::~UdpFanoutTransport() = default;
+
+void UdpFanoutTransport::open() {
+    if (!parseDestinations(m_destinationList, m_defaultPort, m_destinations, m_errorString)) {
+        emit errorOccurred(m_errorString);
+        return;
+    }
+
+    bool ipv6 = false;
+    for (const Destination &destination : qAsConst(m_destinations)) {
+        ipv6 = ipv6 || destination.address.protocol() == QAbstractSocket::IPv6Protocol;
+    }
+
+    // A dual-stack socket reaches IPv4 destinations through mapped addresses
+    if (m_socket->state() != QAbstractSocket::BoundState &&
+        !m_socket->bind(ipv6 ? QHostAddress::Any : QHostAddress::AnyIPv4, 0)) {
+        m_errorString = m_socket->errorString();
+        emit errorOccurred(m_errorString);
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+    SendBuffers &buffers = *m_buffers;
+    buffers.names.assign(m_destinations.size(), sockaddr_storage());
+    buffers.nameSize = ipv6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    for (int i = 0; i < m_destinations.size(); i++) {
+        const Destination &destination = m_destinations[i];
+        sockaddr_storage &name = buffers.names[i];
+        memset(&name, 0, sizeof(name));
+        if (ipv6) {
+            sockaddr_in6 *in6 = reinterpret_cast<sockaddr_in6 *>(&name);
+            in6->sin6_family = AF_INET6;
+            in6->sin6_port = qToBigEndian(destination.port);
+            if (destination.address.protocol() == QAbstractSocket::IPv6Protocol) {
+                const Q_IPV6ADDR address = destination.address.toIPv6Address();
+                memcpy(&in6->sin6_addr, address.c, 16);
+                in6->sin6_scope_id = destination.address.scopeId().toUInt();
+            } else {
+                const quint32 address = qToBigEndian(destination.address.toIPv4Address());
+                in6->sin6_addr.s6_addr[10] = 0xFF;
+                in6->sin6_addr.s6_addr[11] = 0xFF;
+                memcpy(&in6->sin6_addr.s6_addr[12], &address, 4);
+            }
+        } else {
+            sockaddr_in *in = reinterpret_cast<sockaddr_in *>(&name);
+            in->sin_family = AF_INET;
+            in->sin_port = qToBigEndian(destination.port);
+            in->sin_addr.s_addr = qToBigEndian(destination.address.toIPv4Address());
+        }
+    }
+#endif
+
+    m_sequence = 0;
+    m_batch.resize(0);
+    m_frameEnds.resize(0);
+    emit opened();
+}
+
+void UdpFanoutTransport::close() {
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->close();
+        m_batch.resize(0);
+        m_frameEnds.resize(0);
+        emit closed();
+    }
+}
+
+bool UdpFanoutTransport::isOpen() const {
+    return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+qint64 UdpFanoutTransport::write(const char *data, qint64 size) {
+    if (!isOpen()) {
+        return -1;
+    }
+
+    m_batch.append(data, static_cast<int>(size));
+    m_frameEnds.append(m_batch.size());
+
+    // Frames outside an epoch (ACKs, poll replies) leave at once
+    if (!m_inEpoch) {
+        sendBatch();
+    }
+    return size;
+}
+
+void UdpFanoutTransport::beginEpoch(quint32 epoch) {
+    m_inEpoch = true;
+    m_epoch = epoch;
+}
+
+void UdpFanoutTransport::endEpoch() {
+    m_inEpoch = false;
+    sendBatch();
+}
+
+void UdpFanoutTransport::sendBatch() {
+    if (m_frameEnds.isEmpty()) {
+        return;
+    }
+
+    SendBuffers &buffers = *m_buffers;
+    buffers.headers.clear();
+    buffers.slices.clear();
+    buffers.datagrams.clear();
+
+    // Split the batch into datagrams. The header words are written first,
+    // slices point at them once the vector stops growing
+    const int headerSize = m_sequenceHeader ? HeaderSize : 0;
+    int begin = 0;
+    int frame = 0;
+    while (frame < m_frameEnds.size()) {
+        int end = m_frameEnds[frame++];
+        if (m_packing == PackedPerEpoch) {
+            while (frame < m_frameEnds.size() && headerSize + m_frameEnds[frame] - begin <= MaxPackedPayload) {
+                end = m_frameEnds[frame++];
+            }
+        }
+
+        buffers.datagrams.push_back(static_cast<int>(buffers.slices.size()));
+        if (m_sequenceHeader) {
+            buffers.headers.push_back(qToLittleEndian(m_sequence));
+            buffers.headers.push_back(qToLittleEndian(m_epoch));
+            buffers.slices.push_back({ nullptr, HeaderSize });
+        }
+        buffers.slices.push_back({ m_batch.constData() + begin, end - begin });
+        buffers.datagrams.push_back(m_sequenceHeader ? 2 : 1);
+        m_sequence++;
+        begin = end;
+    }
+
+    const int datagramCount = static_cast<int>(buffers.datagrams.size() / 2);
+    if (m_sequenceHeader) {
+        for (int i = 0; i < datagramCount; i++) {
+            buffers.slices[buffers.datagrams[2 * i]].data =
+                reinterpret_cast<const char *>(&buffers.headers[2 * i]);
+        }
+    }
+
+#ifdef Q_OS_LINUX
+    // Every destination gets the same datagrams; one call sends them all
+    buffers.iov.resize(buffers.slices.size());
+    for (size_t i = 0; i < buffers.slices.size(); i++) {
+        buffers.iov[i].iov_base = const_cast<char *>(buffers.slices[i].data);
+        buffers.iov[i].iov_len = static_cast<size_t>(buffers.slices[i].size);
+    }
+
+    const int count = datagramCount * m_destinations.size();
+    buffers.msgs.resize(static_cast<size_t>(count));
+    for (int d = 0; d < m_destinations.size(); d++) {
+        for (int g = 0; g < datagramCount; g++) {
+            mmsghdr &msg = buffers.msgs[static_cast<size_t>(d * datagramCount + g)];
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_hdr.msg_name = &buffers.names[static_cast<size_t>(d)];
+            msg.msg_hdr.msg_namelen = buffers.nameSize;
+            msg.msg_hdr.msg_iov = &buffers.iov[static_cast<size_t>(buffers.datagrams[2 * g])];
+            msg.msg_hdr.msg_iovlen = static_cast<size_t>(buffers.datagrams[2 * g + 1]);
+        }
+    }
+
+    const int fd = static_cast<int>(m_socket->socketDescriptor());
+    int sent = 0;
+    while (sent < count) {
+        const int result = ::sendmmsg(fd, buffers.msgs.data() + sent, static_cast<unsigned>(count - sent), 0);
+        if (result > 0) {
+            sent += result;
+            m_datagramsSent += static_cast<quint64>(result);
+        } else if (result < 0 && errno == EINTR) {
+            continue;
+        } else {
+            // The failing datagram is skipped, the rest still go out
+            m_errorString = QString::fromLocal8Bit(strerror(errno));
+            m_sendErrors++;
+            sent++;
+        }
+    }
+#else
+    for (int g = 0; g < datagramCount; g++) {
+        buffers.scratch.resize(0);
+        const int first = buffers.datagrams[2 * g];
+        for (int s = first; s < first + buffers.datagrams[2 * g + 1]; s++) {
+            buffers.scratch.append(buffers.slices[s].data, buffers.slices[s].size);
+        }
+        for (const Destination &destination : qAsConst(m_destinations)) {
+            if (m_socket->writeDatagram(buffers.scratch, destination.address, destination.port) < 0) {
+                m_sendErrors++;
+            } else {
+                m_datagramsSent++;
+            }
+        }
+    }
+#endif
+
+    m_batch.resize(0);
+    m_frameEnds.resize(0);
+}
+
+QByteArray UdpFanoutTransport::readAll() {
+    QByteArray data;
+    data.swap(m_pending);
+    return data;
+}
+
+QString UdpFanoutTransport::errorString() const {
+    return m_errorString.isEmpty() ? m_socket->errorString() : m_errorString;
+}
+
+QString UdpFanoutTransport::description() const {
+    return tr("UDP fan-out to %n destination(s)", nullptr, m_destinations.size());
+}
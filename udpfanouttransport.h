@@ -0,0 +1,84 @@
+#ifndef UBX_UDP_FANOUT_TRANSPORT_H
+#define UBX_UDP_FANOUT_TRANSPORT_H
+
+#include "ubxtransport.h"
+
+#include <QVector>
+#include <memory>
+
+// Output-only UDP stream to several unicast or multicast destinations,
+// e.g. "239.1.1.1, 10.0.0.5:5000" (the port defaults to the dialog port).
+// Frames written during a navigation epoch are collected and go out in
+// endEpoch(), to every destination with one sendmmsg() call on Linux.
+// Datagrams carry one frame each or are packed up to one Ethernet MTU.
+// The optional 8-byte header (datagram sequence, epoch, both u32 LE) lets a
+// receiver detect loss. Replies to the bound port are read like UDP.
+class UdpFanoutTransport : public UbxTransport {
+    Q_OBJECT
+
+public:
+    enum Packing {
+        FramePerDatagram,
+        PackedPerEpoch
+    };
+
+    struct Destination {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    UdpFanoutTransport(const QString &destinations, quint16 defaultPort, QObject *parent = nullptr);
+    ~UdpFanoutTransport() override;
+
+    void open() override;
+    void close() override;
+    bool isOpen() const override;
+    qint64 write(const char *data, qint64 size) override;
+    QByteArray readAll() override;
+    QString errorString() const override;
+    QString description() const override;
+
+    void beginEpoch(quint32 epoch) override;
+    void endEpoch() override;
+
+    void setPacking(Packing packing) { m_packing = packing; }
+    void setSequenceHeader(bool enabled) { m_sequenceHeader = enabled; }
+
+    quint64 datagramsSent() const { return m_datagramsSent; }
+    quint64 sendErrors() const { return m_sendErrors; }
+
+    static bool parseDestinations(const QString &list, quint16 defaultPort,
+                                  QVector<Destination> &destinations, QString &error);
+
+    // Packed datagrams stay within an Ethernet MTU
+    static const int MaxPackedPayload = 1472;
+    static const int HeaderSize = 8;
+
+private:
+    struct SendBuffers;
+
+    void sendBatch();
+
+    QUdpSocket *m_socket;
+    QString m_destinationList;
+    quint16 m_defaultPort;
+    QVector<Destination> m_destinations;
+    QString m_errorString;
+    QByteArray m_pending;
+
+    Packing m_packing = FramePerDatagram;
+    bool m_sequenceHeader = true;
+    bool m_inEpoch = false;
+    quint32 m_epoch = 0;
+    quint32 m_sequence = 0;
+
+    // Frames of the current epoch, back to back
+    QByteArray m_batch;
+    QVector<int> m_frameEnds;
+    std::unique_ptr<SendBuffers> m_buffers;
+
+    quint64 m_datagramsSent = 0;
+    quint64 m_sendErrors = 0;
+};
+
+#endif // UBX_UDP_FANOUT_TRANSPORT_H
@@ -0,0 +1,53 @@
+#include "uipresenter.h"
+
+#include <QTimer>
+
+UiPresenter::UiPresenter(QObject *parent)
+    : QObject(parent), m_timer(new QTimer(this)) {
+    m_timer->setInterval(1000 / RefreshHz);
+    connect(m_timer, &QTimer::timeout, this, &UiPresenter::refresh);
+}
+
+template <typename Handle>
+void UiPresenter::store(Handle &slot, const Handle &value) {
+    if (slot) {
+        m_coalesced++;
+    }
+    // Holding the handle keeps the pooled message alive, nothing is copied
+    slot = value;
+
+    if (!m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+template <typename Handle, typename Signal>
+bool UiPresenter::publish(Handle &slot, Signal signal) {
+    if (!slot) {
+        return false;
+    }
+    Handle latest = slot;
+    slot.reset();
+    emit (this->*signal)(*latest);
+    return true;
+}
+
+void UiPresenter::post(const UbxParser::NavPvtHandle &pvt) { store(m_navPvt, pvt); }
+void UiPresenter::post(const UbxParser::NavStatusHandle &status) { store(m_navStatus, status); }
+void UiPresenter::post(const UbxParser::MonHwHandle &hw) { store(m_monHw, hw); }
+void UiPresenter::post(const UbxParser::MonRfHandle &rf) { store(m_monRf, rf); }
+void UiPresenter::post(const UbxParser::CfgPrtHandle &prt) { store(m_cfgPrt, prt); }
+
+void UiPresenter::refresh() {
+    bool shown = false;
+    shown |= publish(m_navPvt, &UiPresenter::navPvtChanged);
+    shown |= publish(m_navStatus, &UiPresenter::navStatusChanged);
+    shown |= publish(m_monHw, &UiPresenter::monHwChanged);
+    shown |= publish(m_monRf, &UiPresenter::monRfChanged);
+    shown |= publish(m_cfgPrt, &UiPresenter::cfgPrtChanged);
+
+    // Idle until the next message arrives
+    if (!shown) {
+        m_timer->stop();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef UI_PRESENTER_H
+#define UI_PRESENTER_H
+
+#include <QObject>
+#include "ubxparser.h"
+
+class QTimer;
+
+// Last-value cache between the parser and the widgets. Handlers post the
+// newest decoded message; widgets are refreshed from it at most RefreshHz
+// times a second, so a fast peer stream no longer pays for a repaint per
+// message. Intermediate snapshots are dropped and counted.
+class UiPresenter : public QObject {
+    Q_OBJECT
+
+public:
+    static const int RefreshHz = 15;
+
+    explicit UiPresenter(QObject *parent = nullptr);
+
+    void post(const UbxParser::NavPvtHandle &pvt);
+    void post(const UbxParser::NavStatusHandle &status);
+    void post(const UbxParser::MonHwHandle &hw);
+    void post(const UbxParser::MonRfHandle &rf);
+    void post(const UbxParser::CfgPrtHandle &prt);
+
+    // Snapshots replaced before they were shown
+    quint64 coalescedCount() const { return m_coalesced; }
+
+signals:
+    void navPvtChanged(const UbxParser::NavPvt &pvt);
+    void navStatusChanged(const UbxParser::NavStatus &status);
+    void monHwChanged(const UbxParser::MonHw &hw);
+    void monRfChanged(const UbxParser::MonRf &rf);
+    void cfgPrtChanged(const UbxParser::CfgPrt &prt);
+
+private:
+    template <typename Handle>
+    void store(Handle &slot, const Handle &value);
+
+    template <typename Handle, typename Signal>
+    bool publish(Handle &slot, Signal signal);
+
+    void refresh();
+
+    QTimer *m_timer;
+    quint64 m_coalesced = 0;
+
+    // A non-null handle is a snapshot not yet shown
+    UbxParser::NavPvtHandle m_navPvt;
+    UbxParser::NavStatusHandle m_navStatus;
+    UbxParser::MonHwHandle m_monHw;
+    UbxParser::MonRfHandle m_monRf;
+    UbxParser::CfgPrtHandle m_cfgPrt;
+};
+
+#endif // UI_PRESENTER_H
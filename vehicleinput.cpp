@@ -0,0 +1,286 @@
+#include "vehicleinput.h"
+
+#include <QNetworkDatagram>
+#include <QUdpSocket>
+#include <QtEndian>
+#include <QtMath>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double EarthRadius = 6378137.0;
+
+// MAVLink message IDs and their CRC_EXTRA seeds
+const quint32 MavlinkHilState = 90;
+const quint32 MavlinkHilGps = 113;
+const quint8 HilStateCrcExtra = 183;
+const quint8 HilGpsCrcExtra = 124;
+const int HilStateLength = 56;
+const int HilGpsLength = 39;     // With the MAVLink 2 id/yaw extensions
+
+quint16 mavlinkCrc(const char *data, int size, quint8 extra) {
+    quint16 crc = 0xFFFF;
+    auto accumulate = [&crc](quint8 byte) {
+        quint8 tmp = byte ^ static_cast<quint8>(crc & 0xFF);
+        tmp ^= static_cast<quint8>(tmp << 4);
+        crc = static_cast<quint16>((crc >> 8) ^ (tmp << 8) ^ (tmp << 3) ^ (tmp >> 4));
+    };
+    for (int i = 0; i < size; i++) {
+        accumulate(static_cast<quint8>(data[i]));
+    }
+    accumulate(extra);
+    return crc;
+}
+
+template <typename T>
+T field(const char *payload, int offset) {
+    return qFromLittleEndian<T>(payload + offset);
+}
+
+float floatField(const char *payload, int offset) {
+    const quint32 bits = qFromLittleEndian<quint32>(payload + offset);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double doubleField(const char *payload, int offset) {
+    const quint64 bits = qFromLittleEndian<quint64>(payload + offset);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Moves a sample along its velocity for dt seconds
+void advance(VehicleInput::Sample &sample, double dt) {
+    sample.lat += qRadiansToDegrees(sample.velN * dt / EarthRadius);
+    sample.lon += qRadiansToDegrees(sample.velE * dt / (EarthRadius * qMax(1e-6, qCos(qDegreesToRadians(sample.lat)))));
+    sample.alt -= sample.velD * dt;
+}
+
+double lerp(double a, double b, double t) {
+    return a + (b - a) * t;
+}
+
+// Shortest way round for angles in radians
+double lerpAngle(double a, double b, double t) {
+    double delta = std::remainder(b - a, 2.0 * M_PI);
+    return a + delta * t;
+}
+
+} // namespace
+
+VehicleInput::VehicleInput(QObject *parent)
+    : QObject(parent), m_socket(new QUdpSocket(this)) {
+    connect(m_socket, &QUdpSocket::readyRead, this, &VehicleInput::onReadyRead);
+    m_clock.start();
+}
+
+bool VehicleInput::open(quint16 port) {
+    close();
+    if (!m_socket->bind(QHostAddress::Any, port)) {
+        m_errorString = m_socket->errorString();
+        return false;
+    }
+
+    m_writerSlot = Slot();
+    m_slot.publish(m_writerSlot);
+    m_samples = 0;
+    m_rejected = 0;
+    m_statsStartNs = nowNs();
+    return true;
+}
+
+void VehicleInput::close() {
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->close();
+    }
+    m_writerSlot = Slot();
+    m_slot.publish(m_writerSlot);
+}
+
+bool VehicleInput::isOpen() const {
+    return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+void VehicleInput::onReadyRead() {
+    while (m_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = m_socket->receiveDatagram();
+        const QByteArray data = datagram.data();
+
+        Sample sample = m_writerSlot.latest;
+        const bool parsed = data.size() >= 4 && qFromLittleEndian<quint32>(data.constData()) == PacketMagic
+                                ? parsePacket(data.constData(), data.size(), sample)
+                                : parseMavlink(data.constData(), data.size(), sample);
+        if (!parsed) {
+            m_rejected++;
+            continue;
+        }
+
+        sample.receivedNs = nowNs();
+        if (sample.timeUs == 0) {
+            sample.timeUs = sample.receivedNs / 1000;
+        }
+        accept(sample);
+    }
+}
+
+bool VehicleInput::parsePacket(const char *data, int size, Sample &sample) const {
+    if (size < PacketSize || field<quint16>(data, 4) != 1) {
+        return false;
+    }
+
+    sample.attitudeValid = field<quint16>(data, 6) & 0x0001;
+    sample.timeUs = static_cast<qint64>(field<quint64>(data, 8));
+    sample.lat = doubleField(data, 16);
+    sample.lon = doubleField(data, 24);
+    sample.alt = doubleField(data, 32);
+    sample.velN = floatField(data, 40);
+    sample.velE = floatField(data, 44);
+    sample.velD = floatField(data, 48);
+    sample.roll = floatField(data, 52);
+    sample.pitch = floatField(data, 56);
+    sample.yaw = floatField(data, 60);
+    return true;
+}
+
+// Takes the last HIL_STATE or HIL_GPS in the datagram. HIL_GPS carries no
+// attitude, so the previous attitude is kept.
+bool VehicleInput::parseMavlink(const char *data, int size, Sample &sample) const {
+    bool found = false;
+    int pos = 0;
+
+    while (pos < size) {
+        const quint8 magic = static_cast<quint8>(data[pos]);
+        if (magic != 0xFE && magic != 0xFD) {
+            pos++;
+            continue;
+        }
+
+        const bool v2 = magic == 0xFD;
+        const int headerSize = v2 ? 10 : 6;
+        if (size - pos < headerSize + 2) {
+            break;
+        }
+        const int length = static_cast<quint8>(data[pos + 1]);
+        const bool signedFrame = v2 && (static_cast<quint8>(data[pos + 2]) & 0x01);
+        const int frameSize = headerSize + length + 2 + (signedFrame ? 13 : 0);
+        if (size - pos < frameSize) {
+            break;
+        }
+
+        const quint32 msgId = v2 ? (static_cast<quint8>(data[pos + 7]) |
+                                    (static_cast<quint8>(data[pos + 8]) << 8) |
+                                    (static_cast<quint8>(data[pos + 9]) << 16))
+                                 : static_cast<quint8>(data[pos + 5]);
+        if (msgId != MavlinkHilState && msgId != MavlinkHilGps) {
+            pos += frameSize;
+            continue;
+        }
+        const quint8 extra = msgId == MavlinkHilState ? HilStateCrcExtra : HilGpsCrcExtra;
+        const int fullLength = msgId == MavlinkHilState ? HilStateLength : HilGpsLength;
+
+        const quint16 crc = qFromLittleEndian<quint16>(data + pos + headerSize + length);
+        if (mavlinkCrc(data + pos + 1, headerSize - 1 + length, extra) != crc || length > fullLength) {
+            pos++;
+            continue;
+        }
+
+        // MAVLink 2 trims trailing zero bytes from the payload
+        char payload[HilStateLength] = {};
+        memcpy(payload, data + pos + headerSize, static_cast<size_t>(length));
+
+        sample.timeUs = static_cast<qint64>(field<quint64>(payload, 0));
+        if (msgId == MavlinkHilState) {
+            sample.roll = floatField(payload, 8);
+            sample.pitch = floatField(payload, 12);
+            sample.yaw = floatField(payload, 16);
+            sample.attitudeValid = true;
+            sample.lat = field<qint32>(payload, 32) * 1e-7;
+            sample.lon = field<qint32>(payload, 36) * 1e-7;
+            sample.alt = field<qint32>(payload, 40) * 1e-3;
+            sample.velN = field<qint16>(payload, 44) * 0.01;
+            sample.velE = field<qint16>(payload, 46) * 0.01;
+            sample.velD = field<qint16>(payload, 48) * 0.01;
+        } else {
+            sample.lat = field<qint32>(payload, 8) * 1e-7;
+            sample.lon = field<qint32>(payload, 12) * 1e-7;
+            sample.alt = field<qint32>(payload, 16) * 1e-3;
+            sample.velN = field<qint16>(payload, 26) * 0.01;
+            sample.velE = field<qint16>(payload, 28) * 0.01;
+            sample.velD = field<qint16>(payload, 30) * 0.01;
+        }
+        found = true;
+        pos += frameSize;
+    }
+    return found;
+}
+
+void VehicleInput::accept(const Sample &sample) {
+    // A sender clock that went backwards starts a new track
+    m_writerSlot.hasPrevious = m_writerSlot.valid && sample.timeUs > m_writerSlot.latest.timeUs;
+    m_writerSlot.previous = m_writerSlot.latest;
+    m_writerSlot.latest = sample;
+    m_writerSlot.valid = true;
+    m_slot.publish(m_writerSlot);
+    m_samples++;
+}
+
+bool VehicleInput::sampleAt(qint64 timeNs, Sample &sample) const {
+    const Slot slot = m_slot.read();
+    if (!slot.valid || nowNs() - slot.latest.receivedNs > StaleMs * 1000000LL) {
+        return false;
+    }
+
+    // Requested time on the sender clock, anchored at the newest arrival
+    const qint64 targetUs = slot.latest.timeUs + (timeNs - slot.latest.receivedNs) / 1000;
+    sample = slot.latest;
+
+    if (targetUs < slot.latest.timeUs && slot.hasPrevious) {
+        const Sample &a = slot.previous;
+        const Sample &b = slot.latest;
+        const double t = qBound(0.0, double(targetUs - a.timeUs) / double(b.timeUs - a.timeUs), 1.0);
+        sample.lat = lerp(a.lat, b.lat, t);
+        sample.lon = lerp(a.lon, b.lon, t);
+        sample.alt = lerp(a.alt, b.alt, t);
+        sample.velN = lerp(a.velN, b.velN, t);
+        sample.velE = lerp(a.velE, b.velE, t);
+        sample.velD = lerp(a.velD, b.velD, t);
+        sample.roll = lerpAngle(a.roll, b.roll, t);
+        sample.pitch = lerpAngle(a.pitch, b.pitch, t);
+        sample.yaw = lerpAngle(a.yaw, b.yaw, t);
+        sample.timeUs = a.timeUs + qint64(t * (b.timeUs - a.timeUs));
+    } else if (targetUs > slot.latest.timeUs) {
+        const qint64 aheadUs = qMin<qint64>(targetUs - slot.latest.timeUs, MaxExtrapolationMs * 1000LL);
+        advance(sample, aheadUs * 1e-6);
+        sample.timeUs += aheadUs;
+    }
+    return true;
+}
+
+void VehicleInput::recordDelay(qint64 delayNs) {
+    m_lastDelayMs = delayNs / 1e6;
+    m_maxDelayMs = qMax(m_maxDelayMs, m_lastDelayMs);
+    m_delaySumMs += m_lastDelayMs;
+    m_delayCount++;
+}
+
+VehicleInput::Stats VehicleInput::takeStats() {
+    const qint64 now = nowNs();
+    Stats stats;
+    stats.samples = m_samples;
+    stats.rejected = m_rejected;
+    stats.rateHz = now > m_statsStartNs ? m_samples * 1e9 / (now - m_statsStartNs) : 0.0;
+    stats.lastDelayMs = m_lastDelayMs;
+    stats.meanDelayMs = m_delayCount > 0 ? m_delaySumMs / m_delayCount : 0.0;
+    stats.maxDelayMs = m_maxDelayMs;
+
+    m_samples = 0;
+    m_rejected = 0;
+    m_statsStartNs = now;
+    m_delayCount = 0;
+    m_delaySumMs = 0.0;
+    m_maxDelayMs = 0.0;
+    return stats;
+}
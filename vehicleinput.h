@@ -0,0 +1,106 @@
+#ifndef VEHICLE_INPUT_H
+#define VEHICLE_INPUT_H
+
+#include "seqlock.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+
+class QUdpSocket;
+
+// Truth input from a flight simulator for hardware/software-in-the-loop
+// runs. Each datagram on the bound UDP port carries either the fixed
+// binary packet below or MAVLink HIL_GPS / HIL_STATE messages (v1 or v2).
+// The two newest samples sit in a seqlocked slot; sampleAt() interpolates
+// between them, or extrapolates the newest along its velocity, to the
+// requested time.
+//
+// Binary packet, 64 bytes, little-endian:
+//   u32 magic "VEHS" (0x53484556), u16 version (1), u16 flags (bit 0: attitude valid)
+//   u64 timeUs               sender clock
+//   f64 lat, lon             deg
+//   f64 alt                  m above the ellipsoid
+//   f32 velN, velE, velD     m/s
+//   f32 roll, pitch, yaw     rad
+class VehicleInput : public QObject {
+    Q_OBJECT
+
+public:
+    struct Sample {
+        qint64 timeUs = 0;          // Sender clock
+        qint64 receivedNs = 0;      // Local clock, see nowNs()
+        double lat = 0.0;           // deg
+        double lon = 0.0;           // deg
+        double alt = 0.0;           // m
+        double velN = 0.0;          // m/s
+        double velE = 0.0;
+        double velD = 0.0;
+        double roll = 0.0;          // rad
+        double pitch = 0.0;
+        double yaw = 0.0;
+        bool attitudeValid = false;
+    };
+
+    struct Stats {
+        quint64 samples = 0;
+        quint64 rejected = 0;       // Datagrams that were not a valid packet
+        double rateHz = 0.0;
+        double lastDelayMs = 0.0;   // Newest truth sample to NAV-PVT written
+        double meanDelayMs = 0.0;
+        double maxDelayMs = 0.0;
+    };
+
+    static const quint32 PacketMagic = 0x53484556;
+    static const int PacketSize = 64;
+
+    // Older input counts as lost and the configured values apply again
+    static const int StaleMs = 1000;
+    static const int MaxExtrapolationMs = 500;
+
+    explicit VehicleInput(QObject *parent = nullptr);
+
+    bool open(quint16 port);
+    void close();
+    bool isOpen() const;
+    QString errorString() const { return m_errorString; }
+
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+    // Truth at timeNs on the local clock; false while no fresh input exists.
+    // Safe to call from any thread.
+    bool sampleAt(qint64 timeNs, Sample &sample) const;
+
+    void recordDelay(qint64 delayNs);
+
+    // Statistics since the previous call
+    Stats takeStats();
+
+private:
+    struct Slot {
+        Sample previous;
+        Sample latest;
+        bool hasPrevious = false;
+        bool valid = false;
+    };
+
+    void onReadyRead();
+    bool parsePacket(const char *data, int size, Sample &sample) const;
+    bool parseMavlink(const char *data, int size, Sample &sample) const;
+    void accept(const Sample &sample);
+
+    QUdpSocket *m_socket;
+    QElapsedTimer m_clock;
+    QString m_errorString;
+    SeqLock<Slot> m_slot;
+    Slot m_writerSlot;              // Writer-side copy of the published slot
+
+    quint64 m_samples = 0;
+    quint64 m_rejected = 0;
+    qint64 m_statsStartNs = 0;
+    quint64 m_delayCount = 0;
+    double m_delaySumMs = 0.0;
+    double m_lastDelayMs = 0.0;
+    double m_maxDelayMs = 0.0;
+};
+
+#endif // VEHICLE_INPUT_H
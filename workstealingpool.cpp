@@ -0,0 +1,132 @@
+#include "workstealingpool.h"
+
+WorkStealingPool::WorkStealingPool(int threads)
+    : m_queues(threads > 0 ? threads : qMax(1u, std::thread::hardware_concurrency())) {
+    for (int i = 1; i < threadCount(); i++) {
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::run(int count, const Task &task) {
+    if (count <= 0) {
+        return;
+    }
+
+    const int threads = threadCount();
+    for (int i = 0; i < threads; i++) {
+        std::lock_guard<std::mutex> lock(m_queues[i].mutex);
+        m_queues[i].begin = static_cast<int>(qint64(count) * i / threads);
+        m_queues[i].end = static_cast<int>(qint64(count) * (i + 1) / threads);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_busyWorkers = threads - 1;
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_task = nullptr;
+}
+
+void WorkStealingPool::workerLoop(int self) {
+    quint64 seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        drain(self);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::drain(int self) {
+    const Task &task = *m_task;
+    int index;
+    for (;;) {
+        while (pop(self, index)) {
+            task(index);
+        }
+        if (!steal(self)) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::pop(int self, int &index) {
+    Queue &queue = m_queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.begin >= queue.end) {
+        return false;
+    }
+    index = queue.begin++;
+    return true;
+}
+
+// Moves the upper half of the largest other range into our empty queue
+bool WorkStealingPool::steal(int self) {
+    const int threads = threadCount();
+    for (;;) {
+        int victim = -1;
+        int largest = 0;
+        for (int i = 0; i < threads; i++) {
+            if (i == self) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(m_queues[i].mutex);
+            const int remaining = m_queues[i].end - m_queues[i].begin;
+            if (remaining > largest) {
+                largest = remaining;
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+
+        int begin;
+        int end;
+        {
+            std::lock_guard<std::mutex> lock(m_queues[victim].mutex);
+            Queue &queue = m_queues[victim];
+            if (queue.begin >= queue.end) {
+                continue;   // Drained meanwhile, look again
+            }
+            end = queue.end;
+            begin = queue.begin + (queue.end - queue.begin) / 2;
+            queue.end = begin;
+        }
+
+        std::lock_guard<std::mutex> lock(m_queues[self].mutex);
+        m_queues[self].begin = begin;
+        m_queues[self].end = end;
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. run() splits the
+// index range evenly over the workers and the calling thread; whoever runs
+// out of work steals the upper half of the largest remaining range, so a
+// few slow items do not hold up the whole loop.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(int index)>;
+
+    // 0 uses one thread per core, the caller counted as one of them
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(m_queues.size()); }
+
+    // Calls task(i) for every i in [0, count) and returns once all are
+    // done. Not reentrant.
+    void run(int count, const Task &task);
+
+    // Ranges taken from another thread's queue since the last call
+    quint64 takeSteals() { return m_steals.exchange(0, std::memory_order_relaxed); }
+
+private:
+    // One range of indices per thread, on its own cache line
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        int begin = 0;
+        int end = 0;
+    };
+
+    void workerLoop(int self);
+    void drain(int self);
+    bool pop(int self, int &index);
+    bool steal(int self);
+
+    std::vector<Queue> m_queues;        // [0] belongs to the caller of run()
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const Task *m_task = nullptr;
+    quint64 m_generation = 0;
+    int m_busyWorkers = 0;
+    bool m_stopping = false;
+    std::atomic<quint64> m_steals{0};
+};
+
+#endif // WORK_STEALING_POOL_H